@@ -60,7 +60,7 @@ def enablePalPlc(palComponent, value):
     primePalPlcRmHdrFile.setEnabled(value)
     palComponent.setDependencyEnabled("primePalPlc", value)
 
-    if value & palComponent.getDependencyEnabled("primePalUSI"):
+    if value & palComponent.getSymbolValue("PRIME_PAL_PHY_SNIFFER"):
         activateComponents(["srv_psniffer"])
     else:
         if (palComponent.getDependencyEnabled("primePalSerial") == False):
@@ -74,7 +74,7 @@ def enablePalRf(palComponent, value):
     primePalRfRmHdrFile.setEnabled(value)
     palComponent.setDependencyEnabled("primePalRf", value)
 
-    if value & palComponent.getDependencyEnabled("primePalUSI"):
+    if value & palComponent.getSymbolValue("PRIME_PAL_PHY_SNIFFER"):
         activateComponents(["srv_rsniffer"])
     else:
         Database.deactivateComponents(["srv_rsniffer"]) 
@@ -90,14 +90,15 @@ def enablePalSerial(palComponent, value):
     else:
         Database.deactivateComponents(["primePhySerialDrv"]) 
 
-    if value & palComponent.getDependencyEnabled("primePalUSI"):
+    if value & palComponent.getSymbolValue("PRIME_PAL_PHY_SNIFFER"):
         activateComponents(["srv_psniffer"])
     else:
         if (palComponent.getDependencyEnabled("primePalPlc") == False):
             Database.deactivateComponents(["srv_psniffer"]) 
 
 def enablePhySniffer(palComponent, value):
-    palComponent.setDependencyEnabled("primePalUSI", value)
+    perTestEnabled = palComponent.getSymbolValue("PRIME_PAL_PER_TEST")
+    palComponent.setDependencyEnabled("primePalUSI", value or perTestEnabled)
     
     if value and palComponent.getDependencyEnabled("primePalPlc"):
         activateComponents(["srv_psniffer"])
@@ -116,6 +117,10 @@ def enablePhySniffer(palComponent, value):
         if (palComponent.getDependencyEnabled("primePalPlc") == False):
             Database.deactivateComponents(["srv_psniffer"]) 
 
+def enablePerTest(palComponent, value):
+    snifferEnabled = palComponent.getSymbolValue("PRIME_PAL_PHY_SNIFFER")
+    palComponent.setDependencyEnabled("primePalUSI", value or snifferEnabled)
+
 def showUSISymbol(symbol, event):
     symbol.setVisible(event["value"])
 
@@ -126,6 +131,12 @@ def showUSISymbol(symbol, event):
 def showSymbol(symbol, event):
     symbol.setVisible(event["value"])
 
+def showHybridSymbol(symbol, event):
+    localComponent = symbol.getComponent()
+    plcEnabled = localComponent.getSymbolValue("PRIME_PAL_PLC_EN")
+    rfEnabled = localComponent.getSymbolValue("PRIME_PAL_RF_EN")
+    symbol.setVisible(plcEnabled and rfEnabled)
+
 def updatePalDependencies(symbol, event):
     idSymbol = event["id"]
     localComponent = symbol.getComponent()
@@ -138,6 +149,8 @@ def updatePalDependencies(symbol, event):
         enablePalSerial(localComponent, event["value"])
     elif (idSymbol == "PRIME_PAL_PHY_SNIFFER"):
         enablePhySniffer(localComponent, event["value"])
+    elif (idSymbol == "PRIME_PAL_PER_TEST"):
+        enablePerTest(localComponent, event["value"])
 
 def freqHopGetChannelList(rangeValues):
     channels = []
@@ -201,6 +214,37 @@ def instantiateComponent(primePalComponent):
         primePalPlcPVDDMonitor.setReadOnly(True)
     primePalPlcPVDDMonitor.setDependencies(showSymbol, ["PRIME_PAL_PLC_EN"])
 
+    primePalPlcChannelMonitor = primePalComponent.createBooleanSymbol("PRIME_PAL_PLC_CHANNEL_MONITOR", primePalPlc)
+    primePalPlcChannelMonitor.setLabel("Channel Quality Monitor")
+    primePalPlcChannelMonitor.setDescription("Periodically sample noise level and carrier detect of the PLC channel while idle")
+    primePalPlcChannelMonitor.setDefaultValue(False)
+    primePalPlcChannelMonitor.setHelp(prime_pal_helpkeyword)
+    primePalPlcChannelMonitor.setDependencies(showSymbol, ["PRIME_PAL_PLC_EN"])
+
+    primePalPlcAdaptiveCsma = primePalComponent.createBooleanSymbol("PRIME_PAL_PLC_ADAPTIVE_CSMA", primePalPlc)
+    primePalPlcAdaptiveCsma.setLabel("Adaptive CSMA")
+    primePalPlcAdaptiveCsma.setDescription("Track busy channel and collision rates and scale CSMA senses and delay to the measured contention")
+    primePalPlcAdaptiveCsma.setDefaultValue(False)
+    primePalPlcAdaptiveCsma.setHelp(prime_pal_helpkeyword)
+    primePalPlcAdaptiveCsma.setDependencies(showSymbol, ["PRIME_PAL_PLC_EN"])
+
+    primePalPlcTxPowerControl = primePalComponent.createBooleanSymbol("PRIME_PAL_PLC_TX_POWER_CONTROL", primePalPlc)
+    primePalPlcTxPowerControl.setLabel("TX Power Control")
+    primePalPlcTxPowerControl.setDescription("Adapt PLC transmission power per destination from reverse link quality and ACK outcomes")
+    primePalPlcTxPowerControl.setDefaultValue(False)
+    primePalPlcTxPowerControl.setHelp(prime_pal_helpkeyword)
+    primePalPlcTxPowerControl.setDependencies(showSymbol, ["PRIME_PAL_PLC_EN"])
+
+    primePalPlcTxPowerTargetLqi = primePalComponent.createIntegerSymbol("PRIME_PAL_PLC_TX_POWER_TARGET_LQI", primePalPlcTxPowerControl)
+    primePalPlcTxPowerTargetLqi.setLabel("Target LQI")
+    primePalPlcTxPowerTargetLqi.setDescription("LQI to keep at the destination. TX power is reduced while the link exceeds it")
+    primePalPlcTxPowerTargetLqi.setDefaultValue(24)
+    primePalPlcTxPowerTargetLqi.setMin(0)
+    primePalPlcTxPowerTargetLqi.setMax(63)
+    primePalPlcTxPowerTargetLqi.setVisible(False)
+    primePalPlcTxPowerTargetLqi.setHelp(prime_pal_helpkeyword)
+    primePalPlcTxPowerTargetLqi.setDependencies(showSymbol, ["PRIME_PAL_PLC_TX_POWER_CONTROL"])
+
     primePalRf = primePalComponent.createBooleanSymbol("PRIME_PAL_RF_EN", primePalInterfaces)
     primePalRf.setLabel("Enable RF PHY interface")
     primePalRf.setDefaultValue(False)
@@ -245,6 +289,60 @@ def instantiateComponent(primePalComponent):
     primePalSerialComment.setLabel("***PAL Serial only supported in a PRIME 1.3.6 BN or BN Slave***")
     primePalSerialComment.setDependencies(showSymbol, ["PRIME_PAL_SERIAL_EN"])
 
+    primePalHybridDuplicate = primePalComponent.createBooleanSymbol("PRIME_PAL_HYBRID_DUPLICATE", primePalInterfaces)
+    primePalHybridDuplicate.setLabel("Enable PLC and RF duplicate transmission")
+    primePalHybridDuplicate.setDescription("Allow to transmit the same message through PLC and RF, merging both confirms and discarding duplicated indications")
+    primePalHybridDuplicate.setVisible(False)
+    primePalHybridDuplicate.setDefaultValue(False)
+    primePalHybridDuplicate.setHelp(prime_pal_helpkeyword)
+    primePalHybridDuplicate.setDependencies(showHybridSymbol, ["PRIME_PAL_PLC_EN", "PRIME_PAL_RF_EN"])
+
+    primePalMediumAdvisor = primePalComponent.createBooleanSymbol("PRIME_PAL_MEDIUM_ADVISOR", primePalInterfaces)
+    primePalMediumAdvisor.setLabel("Enable PLC and RF medium advisor")
+    primePalMediumAdvisor.setDescription("Keep per-neighbor quality estimates of PLC and RF to get the fastest medium for a destination")
+    primePalMediumAdvisor.setVisible(False)
+    primePalMediumAdvisor.setDefaultValue(False)
+    primePalMediumAdvisor.setHelp(prime_pal_helpkeyword)
+    primePalMediumAdvisor.setDependencies(showHybridSymbol, ["PRIME_PAL_PLC_EN", "PRIME_PAL_RF_EN"])
+
+    primePalAirtime = primePalComponent.createBooleanSymbol("PRIME_PAL_AIRTIME", primePalInterfaces)
+    primePalAirtime.setLabel("Enable airtime accounting")
+    primePalAirtime.setDescription("Accumulate on-air time per channel, frame type and scheme, and enforce optional duty-cycle budgets")
+    primePalAirtime.setDefaultValue(False)
+    primePalAirtime.setHelp(prime_pal_helpkeyword)
+
+    primePalAirtimeWindow = primePalComponent.createIntegerSymbol("PRIME_PAL_AIRTIME_WINDOW", primePalAirtime)
+    primePalAirtimeWindow.setLabel("Utilization Window (s)")
+    primePalAirtimeWindow.setDescription("Length of the sliding window used for channel utilization and duty-cycle budgets")
+    primePalAirtimeWindow.setDefaultValue(3600)
+    primePalAirtimeWindow.setMin(1)
+    primePalAirtimeWindow.setMax(3600)
+    primePalAirtimeWindow.setVisible(False)
+    primePalAirtimeWindow.setHelp(prime_pal_helpkeyword)
+    primePalAirtimeWindow.setDependencies(showSymbol, ["PRIME_PAL_AIRTIME"])
+
+    primePalTxScheduler = primePalComponent.createBooleanSymbol("PRIME_PAL_TX_SCHEDULER", primePalInterfaces)
+    primePalTxScheduler.setLabel("Enable TX reservation scheduler")
+    primePalTxScheduler.setDescription("Keep a table of absolute time transmissions to detect overlaps and conflicts with programmed channel switches")
+    primePalTxScheduler.setDefaultValue(False)
+    primePalTxScheduler.setHelp(prime_pal_helpkeyword)
+
+    primePalTxSchedulerDelay = primePalComponent.createBooleanSymbol("PRIME_PAL_TX_SCHED_DELAY", primePalTxScheduler)
+    primePalTxSchedulerDelay.setLabel("Delay conflicting transmissions")
+    primePalTxSchedulerDelay.setDescription("Move a conflicting transmission after the reservations it overlaps instead of rejecting it")
+    primePalTxSchedulerDelay.setDefaultValue(False)
+    primePalTxSchedulerDelay.setVisible(False)
+    primePalTxSchedulerDelay.setHelp(prime_pal_helpkeyword)
+    primePalTxSchedulerDelay.setDependencies(showSymbol, ["PRIME_PAL_TX_SCHEDULER"])
+
+    primePalTxSchedulerSharedFe = primePalComponent.createBooleanSymbol("PRIME_PAL_TX_SCHED_SHARED_FE", primePalTxScheduler)
+    primePalTxSchedulerSharedFe.setLabel("PLC and RF share front-end")
+    primePalTxSchedulerSharedFe.setDescription("Transmissions of one medium conflict with reservations and channel switches of the other medium")
+    primePalTxSchedulerSharedFe.setDefaultValue(False)
+    primePalTxSchedulerSharedFe.setVisible(False)
+    primePalTxSchedulerSharedFe.setHelp(prime_pal_helpkeyword)
+    primePalTxSchedulerSharedFe.setDependencies(showSymbol, ["PRIME_PAL_TX_SCHEDULER"])
+
     primePalPhySniffer = primePalComponent.createBooleanSymbol("PRIME_PAL_PHY_SNIFFER", None)
     primePalPhySniffer.setLabel("Enable PRIME PHY sniffer")
     primePalPhySniffer.setDefaultValue(False)
@@ -259,12 +357,27 @@ def instantiateComponent(primePalComponent):
     primePalPlcUSIInstance.setHelp(prime_pal_helpkeyword)
     primePalPlcUSIInstance.setDependencies(showUSISymbol, ["PRIME_PAL_PHY_SNIFFER"])
 
+    primePalPerTest = primePalComponent.createBooleanSymbol("PRIME_PAL_PER_TEST", None)
+    primePalPerTest.setLabel("Enable PRIME PHY PER test engine")
+    primePalPerTest.setDescription("Transmit and count numbered test frames across schemes and attenuations, reporting results over USI")
+    primePalPerTest.setDefaultValue(False)
+    primePalPerTest.setHelp(prime_pal_helpkeyword)
+
+    primePalPerTestUSIInstance = primePalComponent.createIntegerSymbol("PRIME_PAL_PER_TEST_USI_INSTANCE", primePalPerTest)
+    primePalPerTestUSIInstance.setLabel("USI Instance")
+    primePalPerTestUSIInstance.setDefaultValue(0)
+    primePalPerTestUSIInstance.setMax(0)
+    primePalPerTestUSIInstance.setMin(0)
+    primePalPerTestUSIInstance.setVisible(False)
+    primePalPerTestUSIInstance.setHelp(prime_pal_helpkeyword)
+    primePalPerTestUSIInstance.setDependencies(showUSISymbol, ["PRIME_PAL_PER_TEST"])
+
     primePalDummy = primePalComponent.createMenuSymbol("PRIME_PAL_DUMMY", None)
     primePalDummy.setLabel("")
     primePalDummy.setDescription("")
     primePalDummy.setVisible(False)
     primePalDummy.setHelp(prime_pal_helpkeyword)
-    primePalDummy.setDependencies(updatePalDependencies, ["PRIME_PAL_PLC_EN", "PRIME_PAL_RF_EN", "PRIME_PAL_SERIAL_EN", "PRIME_PAL_PHY_SNIFFER"])
+    primePalDummy.setDependencies(updatePalDependencies, ["PRIME_PAL_PLC_EN", "PRIME_PAL_RF_EN", "PRIME_PAL_SERIAL_EN", "PRIME_PAL_PHY_SNIFFER", "PRIME_PAL_PER_TEST"])
     
     ############################################################################
     #### Code Generation ####
@@ -49,6 +49,11 @@ Microchip or any third party.
 #include "pal.h"
 #include "pal_types.h"
 #include "pal_local.h"
+<#if (PRIME_PAL_PLC_EN == true) && (((PRIME_PAL_RF_EN == true) && (PRIME_PAL_MEDIUM_ADVISOR == true)) || (PRIME_PAL_PLC_TX_POWER_CONTROL == true))>
+#include "service/time_management/srv_time_management.h"
+<#elseif (PRIME_PAL_AIRTIME == true) || (PRIME_PAL_PER_TEST == true) || (PRIME_PAL_TX_SCHEDULER == true)>
+#include "service/time_management/srv_time_management.h"
+</#if>
 <#if PRIME_PAL_PLC_EN == true>
 #include "pal_plc.h"
 </#if>
@@ -67,6 +72,29 @@ Microchip or any third party.
   </#if>
 </#if>
 
+<#assign PAL_HYBRID_DUPLICATE = false>
+<#if (PRIME_PAL_PLC_EN == true) && (PRIME_PAL_RF_EN == true) && (PRIME_PAL_HYBRID_DUPLICATE == true)>
+    <#assign PAL_HYBRID_DUPLICATE = true>
+</#if>
+<#assign PAL_MEDIUM_ADVISOR = false>
+<#if (PRIME_PAL_PLC_EN == true) && (PRIME_PAL_RF_EN == true) && (PRIME_PAL_MEDIUM_ADVISOR == true)>
+    <#assign PAL_MEDIUM_ADVISOR = true>
+</#if>
+<#assign PAL_PLC_TX_POWER_CONTROL = false>
+<#if (PRIME_PAL_PLC_EN == true) && (PRIME_PAL_PLC_TX_POWER_CONTROL == true)>
+    <#assign PAL_PLC_TX_POWER_CONTROL = true>
+</#if>
+<#if PAL_HYBRID_DUPLICATE == true>
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macro Definitions
+// *****************************************************************************
+// *****************************************************************************
+/* Pending confirms of a duplicate transmission */
+#define PAL_DUP_CFM_PRIMARY           0x01U
+#define PAL_DUP_CFM_SECONDARY         0x02U
+
+</#if>
 // *****************************************************************************
 // *****************************************************************************
 // Section: Global data
@@ -74,189 +102,1991 @@ Microchip or any third party.
 // *****************************************************************************
 
 static PAL_DATA palData;
+<#if PRIME_PAL_AIRTIME == true>
+
+/* Modulation schemes in the order of the airtime counters */
+static const PAL_SCHEME palAirtimeSchemes[PAL_AIRTIME_NUM_SCHEMES] = {
+    PAL_SCHEME_DBPSK, PAL_SCHEME_DQPSK, PAL_SCHEME_D8PSK,
+    PAL_SCHEME_DBPSK_C, PAL_SCHEME_DQPSK_C, PAL_SCHEME_D8PSK_C,
+    PAL_SCHEME_R_DBPSK, PAL_SCHEME_R_DQPSK,
+    PAL_SCHEME_RF, PAL_SCHEME_RF_FSK_FEC_OFF, PAL_SCHEME_RF_FSK_FEC_ON
+};
+</#if>
 
 // *****************************************************************************
 // *****************************************************************************
 // Section: File scope functions
 // *****************************************************************************
 // *****************************************************************************
-<#if PRIME_PAL_PLC_EN == true>
-static void lPAL_PlcDataConfirmCallback(PAL_MSG_CONFIRM_DATA *pData)
+<#if (PAL_HYBRID_DUPLICATE == true) || (PAL_MEDIUM_ADVISOR == true)>
+static bool lPAL_IsRfPch(uint16_t pch)
 {
-    if((palData.dataConfirmCallback) != NULL)
+    return ((pch >= PRIME_PAL_RF_CHN_MASK) && (pch < PRIME_PAL_SERIAL_CHN_MASK));
+}
+
+</#if>
+<#if PAL_MEDIUM_ADVISOR == true>
+static PAL_ADVISOR_NEIGHBOR *lPAL_AdvisorGetNeighbor(uint32_t neighborId, bool create)
+{
+    PAL_ADVISOR_NEIGHBOR *pNeighbor;
+    PAL_ADVISOR_NEIGHBOR *pOldest = NULL;
+    uint32_t timeNow = SRV_TIME_MANAGEMENT_GetTimeUS();
+    uint32_t age;
+    uint32_t maxAge = 0;
+    uint8_t index;
+    uint8_t medium;
+
+    for (index = 0; index < PAL_ADVISOR_NUM_NEIGHBORS; index++)
+    {
+        pNeighbor = &palData.advisorTable[index];
+
+        if (pNeighbor->valid == false)
+        {
+            if (pOldest == NULL)
+            {
+                /* Use first free entry */
+                pOldest = pNeighbor;
+                maxAge = 0xFFFFFFFFUL;
+            }
+
+            continue;
+        }
+
+        if (pNeighbor->neighborId == neighborId)
+        {
+            return pNeighbor;
+        }
+
+        /* Age of the most recent information of the neighbor */
+        age = 0xFFFFFFFFUL;
+        for (medium = 0; medium < PAL_ADVISOR_NUM_MEDIUMS; medium++)
+        {
+            if ((pNeighbor->medium[medium].valid == true) &&
+                ((timeNow - pNeighbor->medium[medium].lastUpdate) < age))
+            {
+                age = timeNow - pNeighbor->medium[medium].lastUpdate;
+            }
+        }
+
+        if ((pOldest == NULL) || (age > maxAge))
+        {
+            pOldest = pNeighbor;
+            maxAge = age;
+        }
+    }
+
+    if ((create == false) || (pOldest == NULL))
+    {
+        return NULL;
+    }
+
+    /* Replace the least recently updated neighbor */
+    (void)memset(pOldest, 0, sizeof(PAL_ADVISOR_NEIGHBOR));
+    pOldest->neighborId = neighborId;
+    pOldest->valid = true;
+
+    return pOldest;
+}
+
+static void lPAL_AdvisorIndication(PAL_MSG_INDICATION_DATA *pData)
+{
+    PAL_ADVISOR_NEIGHBOR *pNeighbor;
+    PAL_ADVISOR_MEDIUM_INFO *pMedium;
+    uint32_t neighborId;
+
+    if ((palData.neighborIdCallback == NULL) || (pData->pch >= PRIME_PAL_SERIAL_CHN_MASK))
+    {
+        return;
+    }
+
+    neighborId = palData.neighborIdCallback(pData->pData, pData->dataLength, false);
+    if (neighborId == PAL_NEIGHBOR_ID_INVALID)
+    {
+        return;
+    }
+
+    pNeighbor = lPAL_AdvisorGetNeighbor(neighborId, true);
+    if (pNeighbor == NULL)
+    {
+        return;
+    }
+
+    if (lPAL_IsRfPch(pData->pch) == true)
+    {
+        pMedium = &pNeighbor->medium[PAL_ADVISOR_MEDIUM_RF];
+    }
+    else
+    {
+        pMedium = &pNeighbor->medium[PAL_ADVISOR_MEDIUM_PLC];
+    }
+
+    if (pMedium->valid == false)
+    {
+        pMedium->bitrateAvg = (uint32_t)pData->estimatedBitrate << 4;
+        pMedium->lqiAvg = (uint16_t)pData->lqi << 4;
+        pMedium->successRatio = 256U;
+        pMedium->valid = true;
+    }
+    else
+    {
+        pMedium->bitrateAvg -= (pMedium->bitrateAvg >> 3);
+        pMedium->bitrateAvg += ((uint32_t)pData->estimatedBitrate << 1);
+        pMedium->lqiAvg -= (pMedium->lqiAvg >> 3);
+        pMedium->lqiAvg += ((uint16_t)pData->lqi << 1);
+    }
+
+    pMedium->pch = pData->pch;
+    pMedium->scheme = pData->lessRobustMod;
+    pMedium->lastUpdate = SRV_TIME_MANAGEMENT_GetTimeUS();
+}
+
+static void lPAL_AdvisorRequest(PAL_MSG_REQUEST_DATA *pData)
+{
+    uint8_t medium;
+
+    if ((palData.neighborIdCallback == NULL) || (pData->pch >= PRIME_PAL_SERIAL_CHN_MASK))
+    {
+        return;
+    }
+
+    if (lPAL_IsRfPch(pData->pch) == true)
+    {
+        medium = PAL_ADVISOR_MEDIUM_RF;
+    }
+    else
+    {
+        medium = PAL_ADVISOR_MEDIUM_PLC;
+    }
+
+    palData.advisorTxNeighborId[medium] = palData.neighborIdCallback(pData->pData, pData->dataLength, true);
+    palData.advisorTxBufId[medium] = pData->buffId;
+}
+
+static void lPAL_AdvisorConfirm(PAL_MSG_CONFIRM_DATA *pData)
+{
+    PAL_ADVISOR_NEIGHBOR *pNeighbor;
+    PAL_ADVISOR_MEDIUM_INFO *pMedium;
+    uint16_t sample;
+    uint8_t medium;
+
+    if (lPAL_IsRfPch(pData->pch) == true)
+    {
+        medium = PAL_ADVISOR_MEDIUM_RF;
+    }
+    else
+    {
+        medium = PAL_ADVISOR_MEDIUM_PLC;
+    }
+
+    if ((palData.advisorTxNeighborId[medium] == PAL_NEIGHBOR_ID_INVALID) ||
+        (palData.advisorTxBufId[medium] != pData->bufId))
+    {
+        return;
+    }
+
+    switch (pData->result)
+    {
+        case PAL_TX_RESULT_SUCCESS:
+            sample = 256U;
+            break;
+
+        case PAL_TX_RESULT_BUSY_CH:
+        case PAL_TX_RESULT_BUSY_TX:
+        case PAL_TX_RESULT_BUSY_RX:
+        case PAL_TX_RESULT_TIMEOUT:
+            sample = 0U;
+            break;
+
+        default:
+            /* Result not related to medium availability */
+            return;
+    }
+
+    pNeighbor = lPAL_AdvisorGetNeighbor(palData.advisorTxNeighborId[medium], false);
+    palData.advisorTxNeighborId[medium] = PAL_NEIGHBOR_ID_INVALID;
+    if (pNeighbor == NULL)
+    {
+        return;
+    }
+
+    /* Only update mediums with information from received messages */
+    pMedium = &pNeighbor->medium[medium];
+    if (pMedium->valid == true)
+    {
+        pMedium->successRatio -= (pMedium->successRatio >> 3);
+        pMedium->successRatio += (sample >> 3);
+    }
+}
+
+</#if>
+<#if PAL_PLC_TX_POWER_CONTROL == true>
+static PAL_TXPC_NEIGHBOR *lPAL_TxPowerGetNeighbor(uint32_t neighborId, bool create)
+{
+    PAL_TXPC_NEIGHBOR *pNeighbor;
+    PAL_TXPC_NEIGHBOR *pOldest = NULL;
+    uint32_t timeNow = SRV_TIME_MANAGEMENT_GetTimeUS();
+    uint32_t age;
+    uint32_t maxAge = 0;
+    uint8_t index;
+
+    for (index = 0; index < PAL_TXPC_NUM_NEIGHBORS; index++)
+    {
+        pNeighbor = &palData.txpcTable[index];
+
+        if (pNeighbor->valid == false)
+        {
+            if (create == true)
+            {
+                pOldest = pNeighbor;
+                maxAge = 0xFFFFFFFFUL;
+            }
+
+            continue;
+        }
+
+        if (pNeighbor->neighborId == neighborId)
+        {
+            return pNeighbor;
+        }
+
+        age = timeNow - pNeighbor->lastUpdate;
+        if ((create == true) && (age > maxAge))
+        {
+            pOldest = pNeighbor;
+            maxAge = age;
+        }
+    }
+
+    if ((create == false) || (pOldest == NULL))
+    {
+        return NULL;
+    }
+
+    /* Replace the least recently updated neighbor */
+    (void)memset(pOldest, 0, sizeof(PAL_TXPC_NEIGHBOR));
+    pOldest->neighborId = neighborId;
+    pOldest->valid = true;
+
+    return pOldest;
+}
+
+static void lPAL_TxPowerUpdateOffset(PAL_TXPC_NEIGHBOR *pNeighbor)
+{
+    uint8_t lqi;
+    uint8_t attTarget = 0;
+
+    if (pNeighbor->holdAcks > 0U)
+    {
+        /* Recovering from a missing ACK */
+        return;
+    }
+
+    /* Attenuation which keeps the target LQI, assuming a symmetric link */
+    lqi = (uint8_t)((pNeighbor->lqiAvg + 8U) >> 4);
+    if (lqi > PAL_TXPC_TARGET_LQI)
+    {
+        attTarget = lqi - (uint8_t)PAL_TXPC_TARGET_LQI;
+        if (attTarget > PAL_TXPC_MAX_ATT_OFFSET)
+        {
+            attTarget = PAL_TXPC_MAX_ATT_OFFSET;
+        }
+    }
+
+    /* Reduce power in 1 dB steps, raise it at once */
+    if (attTarget > pNeighbor->attOffset)
+    {
+        pNeighbor->attOffset++;
+    }
+    else
+    {
+        pNeighbor->attOffset = attTarget;
+    }
+}
+
+static void lPAL_TxPowerIndication(PAL_MSG_INDICATION_DATA *pData)
+{
+    PAL_TXPC_NEIGHBOR *pNeighbor;
+    uint32_t neighborId;
+    uint32_t timeNow;
+
+    if (palData.neighborIdCallback == NULL)
+    {
+        return;
+    }
+
+    neighborId = palData.neighborIdCallback(pData->pData, pData->dataLength, false);
+    if (neighborId == PAL_NEIGHBOR_ID_INVALID)
+    {
+        return;
+    }
+
+    pNeighbor = lPAL_TxPowerGetNeighbor(neighborId, true);
+    if (pNeighbor == NULL)
+    {
+        return;
+    }
+
+    timeNow = SRV_TIME_MANAGEMENT_GetTimeUS();
+    if ((pNeighbor->lqiAvg == 0U) || ((timeNow - pNeighbor->lastUpdate) > PAL_TXPC_AGING_US))
+    {
+        pNeighbor->lqiAvg = (uint16_t)pData->lqi << 4;
+    }
+    else
+    {
+        pNeighbor->lqiAvg -= (pNeighbor->lqiAvg >> 3);
+        pNeighbor->lqiAvg += ((uint16_t)pData->lqi << 1);
+    }
+
+    pNeighbor->lastUpdate = timeNow;
+    lPAL_TxPowerUpdateOffset(pNeighbor);
+}
+
+static void lPAL_TxPowerRequest(PAL_MSG_REQUEST_DATA *pData)
+{
+    PAL_TXPC_NEIGHBOR *pNeighbor;
+    uint32_t neighborId;
+
+    if ((palData.neighborIdCallback == NULL) || (pData->pch >= PRIME_PAL_RF_CHN_MASK))
+    {
+        return;
+    }
+
+    neighborId = palData.neighborIdCallback(pData->pData, pData->dataLength, true);
+    if (neighborId == PAL_NEIGHBOR_ID_INVALID)
+    {
+        return;
+    }
+
+    pNeighbor = lPAL_TxPowerGetNeighbor(neighborId, false);
+    if (pNeighbor == NULL)
+    {
+        return;
+    }
+
+    if ((SRV_TIME_MANAGEMENT_GetTimeUS() - pNeighbor->lastUpdate) > PAL_TXPC_AGING_US)
+    {
+        /* Outdated link information: use full power */
+        pNeighbor->attOffset = 0;
+        return;
+    }
+
+    pData->attLevel += pNeighbor->attOffset;
+}
+
+</#if>
+<#if PAL_HYBRID_DUPLICATE == true>
+static bool lPAL_DupMergeConfirm(PAL_MSG_CONFIRM_DATA *pData)
+{
+    PAL_DUP_TX_DATA *pDup = &palData.dupTxData;
+    bool isRf = lPAL_IsRfPch(pData->pch);
+    uint8_t cfmFlag;
+
+    if (pDup->active == false)
+    {
+        return false;
+    }
+
+    /* Check if confirm corresponds to the duplicate transmission */
+    if (((pDup->pendingCfm & PAL_DUP_CFM_PRIMARY) != 0U) &&
+        (lPAL_IsRfPch(pDup->pchPrimary) == isRf) &&
+        (pData->bufId == pDup->bufIdPrimary))
+    {
+        cfmFlag = PAL_DUP_CFM_PRIMARY;
+    }
+    else if (((pDup->pendingCfm & PAL_DUP_CFM_SECONDARY) != 0U) &&
+             (lPAL_IsRfPch(pDup->pchSecondary) == isRf) &&
+             (pData->bufId == pDup->bufIdSecondary))
+    {
+        cfmFlag = PAL_DUP_CFM_SECONDARY;
+    }
+    else
+    {
+        return false;
+    }
+
+    pDup->pendingCfm &= (uint8_t)(~cfmFlag);
+
+    /* Keep the best result. Primary confirm has priority with same result */
+    if ((pDup->cfmValid == false) ||
+        ((pData->result == PAL_TX_RESULT_SUCCESS) && (pDup->cfmData.result != PAL_TX_RESULT_SUCCESS)) ||
+        ((cfmFlag == PAL_DUP_CFM_PRIMARY) && (pData->result == pDup->cfmData.result)))
+    {
+        pDup->cfmData = *pData;
+        pDup->cfmValid = true;
+    }
+
+    if (pDup->pendingCfm == 0U)
+    {
+        pDup->active = false;
+
+        if((palData.dataConfirmCallback) != NULL)
+        {
+            palData.dataConfirmCallback(&pDup->cfmData);
+        }
+    }
+
+    return true;
+}
+
+static uint32_t lPAL_DupGetSignature(uint8_t *pData, uint16_t length)
+{
+    uint32_t signature = 0x811C9DC5UL;
+    uint16_t index;
+
+    /* FNV-1a hash */
+    for (index = 0; index < length; index++)
+    {
+        signature ^= (uint32_t)pData[index];
+        signature *= 0x01000193UL;
+    }
+
+    return signature;
+}
+
+static bool lPAL_DupCheckIndication(PAL_MSG_INDICATION_DATA *pData)
+{
+    PAL_DUP_IND_ENTRY *pEntry;
+    uint32_t signature;
+    bool isRf = lPAL_IsRfPch(pData->pch);
+    uint8_t index;
+
+    signature = lPAL_DupGetSignature(pData->pData, pData->dataLength);
+
+    for (index = 0; index < PAL_DUP_IND_TABLE_SIZE; index++)
+    {
+        pEntry = &palData.dupIndTable[index];
+
+        if ((pEntry->valid == true) && (pEntry->signature == signature) &&
+            (pEntry->dataLength == pData->dataLength) &&
+            (lPAL_IsRfPch(pEntry->pch) != isRf) &&
+            ((uint32_t)(pData->rxTime - pEntry->rxTime) < PAL_DUP_IND_WINDOW_US))
+        {
+            /* Same message already received through the other medium */
+            pEntry->valid = false;
+            return true;
+        }
+    }
+
+    /* Store new message, replacing the oldest one */
+    pEntry = &palData.dupIndTable[palData.dupIndNext];
+    pEntry->signature = signature;
+    pEntry->rxTime = pData->rxTime;
+    pEntry->dataLength = pData->dataLength;
+    pEntry->pch = pData->pch;
+    pEntry->valid = true;
+
+    palData.dupIndNext = (palData.dupIndNext + 1U) % PAL_DUP_IND_TABLE_SIZE;
+
+    return false;
+}
+
+</#if>
+<#if PRIME_PAL_AIRTIME == true>
+static PAL_AIRTIME_CHANNEL *lPAL_AirtimeGetChannel(uint16_t pch, bool create)
+{
+    PAL_AIRTIME_CHANNEL *pChannel;
+    PAL_AIRTIME_CHANNEL *pFree = NULL;
+    uint8_t index;
+
+    for (index = 0; index < PAL_AIRTIME_NUM_CHANNELS; index++)
+    {
+        pChannel = &palData.airtimeChannels[index];
+        if (pChannel->valid == false)
+        {
+            if (pFree == NULL)
+            {
+                pFree = pChannel;
+            }
+        }
+        else if (pChannel->counters.pch == pch)
+        {
+            return pChannel;
+        }
+        else
+        {
+            /* Entry of other channel */
+        }
+    }
+
+    if ((create == false) || (pFree == NULL))
+    {
+        return NULL;
+    }
+
+    (void)memset(pFree, 0, sizeof(PAL_AIRTIME_CHANNEL));
+    pFree->counters.pch = pch;
+    pFree->valid = true;
+
+    return pFree;
+}
+
+static void lPAL_AirtimeUpdateWindow(void)
+{
+    PAL_AIRTIME_CHANNEL *pChannel;
+    uint64_t timeNow = SRV_TIME_MANAGEMENT_GetTimeUS64();
+    uint8_t index;
+
+    if ((timeNow - palData.airtimeSlotStart) >= PAL_AIRTIME_WINDOW_US)
+    {
+        /* The whole window has elapsed: clear all slots */
+        for (index = 0; index < PAL_AIRTIME_NUM_CHANNELS; index++)
+        {
+            pChannel = &palData.airtimeChannels[index];
+            (void)memset(pChannel->slotTime, 0, sizeof(pChannel->slotTime));
+            pChannel->counters.windowTime = 0;
+        }
+
+        palData.airtimeSlotStart = timeNow;
+        return;
+    }
+
+    while ((timeNow - palData.airtimeSlotStart) >= PAL_AIRTIME_SLOT_US)
+    {
+        palData.airtimeSlotStart += PAL_AIRTIME_SLOT_US;
+        palData.airtimeSlotIndex++;
+        if (palData.airtimeSlotIndex >= PAL_AIRTIME_NUM_SLOTS)
+        {
+            palData.airtimeSlotIndex = 0;
+        }
+
+        /* Remove the oldest slot from the window */
+        for (index = 0; index < PAL_AIRTIME_NUM_CHANNELS; index++)
+        {
+            pChannel = &palData.airtimeChannels[index];
+            pChannel->counters.windowTime -= pChannel->slotTime[palData.airtimeSlotIndex];
+            pChannel->slotTime[palData.airtimeSlotIndex] = 0;
+        }
+    }
+}
+
+static void lPAL_AirtimeConfirm(PAL_MSG_CONFIRM_DATA *pData)
+{
+    PAL_AIRTIME_CHANNEL *pChannel;
+    PAL_AIRTIME_TX *pTx;
+    uint8_t index;
+    uint8_t frameIndex;
+    uint8_t schemeIndex;
+
+    for (index = 0; index < PAL_AIRTIME_NUM_TX; index++)
+    {
+        pTx = &palData.airtimeTx[index];
+        if ((pTx->valid == true) && (pTx->bufId == pData->bufId) && (pTx->pch == pData->pch))
+        {
+            break;
+        }
+    }
+
+    if (index == PAL_AIRTIME_NUM_TX)
+    {
+        return;
+    }
+
+    pTx->valid = false;
+
+    /* Only transmitted messages use the medium */
+    if (pData->result != PAL_TX_RESULT_SUCCESS)
+    {
+        return;
+    }
+
+    lPAL_AirtimeUpdateWindow();
+
+    pChannel = lPAL_AirtimeGetChannel(pTx->pch, true);
+    if (pChannel == NULL)
+    {
+        return;
+    }
+
+    pChannel->counters.numFrames++;
+    pChannel->counters.windowTime += pTx->duration;
+    pChannel->slotTime[palData.airtimeSlotIndex] += pTx->duration;
+
+    switch (pTx->frameType)
+    {
+        case PAL_FRAME_TYPE_A:
+            frameIndex = 0U;
+            break;
+
+        case PAL_FRAME_TYPE_B:
+            frameIndex = 1U;
+            break;
+
+        case PAL_FRAME_TYPE_BC:
+            frameIndex = 2U;
+            break;
+
+        case PAL_FRAME_TYPE_RF:
+            frameIndex = 3U;
+            break;
+
+        default:
+            frameIndex = PAL_AIRTIME_NUM_FRAME_TYPES;
+            break;
+    }
+
+    if (frameIndex < PAL_AIRTIME_NUM_FRAME_TYPES)
+    {
+        pChannel->counters.frameTypeTime[frameIndex] += pTx->duration;
+    }
+
+    for (schemeIndex = 0; schemeIndex < PAL_AIRTIME_NUM_SCHEMES; schemeIndex++)
+    {
+        if (palAirtimeSchemes[schemeIndex] == pTx->scheme)
+        {
+            pChannel->counters.schemeTime[schemeIndex] += pTx->duration;
+            break;
+        }
+    }
+}
+
+</#if>
+<#if PRIME_PAL_TX_SCHEDULER == true>
+static uint8_t lPAL_TxSchedGetMedium(uint16_t pch)
+{
+    if (pch < PRIME_PAL_RF_CHN_MASK)
+    {
+        return PAL_TX_SCHED_MEDIUM_PLC;
+    }
+
+    return PAL_TX_SCHED_MEDIUM_RF;
+}
+
+static void lPAL_TxSchedRemove(uint8_t index)
+{
+    uint8_t next;
+
+    /* Keep the table compacted and sorted by start time */
+    for (next = index + 1U; next < palData.txSchedCounters.numActive; next++)
+    {
+        palData.txSchedTable[next - 1U] = palData.txSchedTable[next];
+    }
+
+    palData.txSchedCounters.numActive--;
+}
+
+static void lPAL_TxSchedRelease(uint8_t medium, uint8_t bufId)
+{
+    PAL_TX_SCHED_ENTRY *pEntry;
+    uint8_t index;
+
+    for (index = 0; index < palData.txSchedCounters.numActive; index++)
+    {
+        pEntry = &palData.txSchedTable[index];
+        if ((pEntry->medium == medium) && (pEntry->bufId == bufId))
+        {
+            lPAL_TxSchedRemove(index);
+            return;
+        }
+    }
+}
+
+static void lPAL_TxSchedPurge(uint32_t timeNow)
+{
+    uint8_t index = 0;
+
+    /* Reservations whose confirm has been lost expire at their end time */
+    while (index < palData.txSchedCounters.numActive)
+    {
+        if ((int32_t)(timeNow - palData.txSchedTable[index].endTime) > 0)
+        {
+            lPAL_TxSchedRemove(index);
+        }
+        else
+        {
+            index++;
+        }
+    }
+
+    for (index = 0; index < PAL_TX_SCHED_NUM_MEDIUMS; index++)
+    {
+        if ((palData.txSchedSwitch[index].valid == true) &&
+            ((int32_t)(timeNow - palData.txSchedSwitch[index].time) > 0))
+        {
+            palData.txSchedSwitch[index].valid = false;
+        }
+    }
+}
+
+static void lPAL_TxSchedConfirm(PAL_MSG_CONFIRM_DATA *pData)
+{
+    lPAL_TxSchedRelease(lPAL_TxSchedGetMedium(pData->pch), pData->bufId);
+}
+
+</#if>
+<#if PRIME_PAL_PER_TEST == true>
+static uint16_t lPAL_PerGetCrc(uint8_t *pData, uint16_t length)
+{
+    uint16_t crc = 0xFFFFU;
+    uint16_t index;
+    uint8_t bit;
+
+    /* CRC-16/CCITT */
+    for (index = 0; index < length; index++)
+    {
+        crc ^= (uint16_t)pData[index] << 8;
+        for (bit = 0; bit < 8U; bit++)
+        {
+            if ((crc & 0x8000U) != 0U)
+            {
+                crc = (uint16_t)((crc << 1) ^ 0x1021U);
+            }
+            else
+            {
+                crc <<= 1;
+            }
+        }
+    }
+
+    return crc;
+}
+
+static uint8_t lPAL_PerGetBitErrors(uint8_t value)
+{
+    uint8_t count = 0;
+
+    while (value != 0U)
+    {
+        value &= (uint8_t)(value - 1U);
+        count++;
+    }
+
+    return count;
+}
+
+static PAL_PER_RX_GROUP *lPAL_PerGetRxGroup(PAL_SCHEME scheme, uint8_t attLevel)
+{
+    PAL_PER_RX_GROUP *pGroup;
+    uint8_t index;
+
+    for (index = 0; index < PAL_PER_NUM_GROUPS; index++)
+    {
+        pGroup = &palData.perTest.rxGroups[index];
+
+        if (pGroup->valid == false)
+        {
+            (void)memset(pGroup, 0, sizeof(PAL_PER_RX_GROUP));
+            pGroup->scheme = scheme;
+            pGroup->attLevel = attLevel;
+            pGroup->valid = true;
+            return pGroup;
+        }
+
+        if ((pGroup->scheme == scheme) && (pGroup->attLevel == attLevel))
+        {
+            return pGroup;
+        }
+    }
+
+    return NULL;
+}
+
+static void lPAL_PerBuildFrame(void)
+{
+    PAL_PER_TEST_DATA *pTest = &palData.perTest;
+    uint8_t *pData = pTest->txData;
+    uint16_t crc;
+    uint16_t index;
+
+    pData[0] = (uint8_t)'P';
+    pData[1] = (uint8_t)'E';
+    pData[2] = (uint8_t)'R';
+    pData[3] = (uint8_t)'T';
+    pData[4] = pTest->testId;
+    pData[5] = (uint8_t)pTest->schemes[pTest->schemeIndex];
+    pData[6] = pTest->attLevels[pTest->attIndex];
+    pData[7] = (uint8_t)(pTest->frameIndex >> 8);
+    pData[8] = (uint8_t)pTest->frameIndex;
+    pData[9] = (uint8_t)(pTest->numFrames >> 8);
+    pData[10] = (uint8_t)pTest->numFrames;
+
+    /* Known pattern to count bit errors */
+    for (index = PAL_PER_HEADER_SIZE; index < (pTest->dataLength - PAL_PER_CRC_SIZE); index++)
+    {
+        pData[index] = (uint8_t)(pTest->frameIndex + index);
+    }
+
+    crc = lPAL_PerGetCrc(pData, pTest->dataLength - PAL_PER_CRC_SIZE);
+    pData[index] = (uint8_t)(crc >> 8);
+    pData[index + 1U] = (uint8_t)crc;
+}
+
+static void lPAL_PerSendTxResult(void)
+{
+    PAL_PER_TEST_DATA *pTest = &palData.perTest;
+    uint8_t txResult[6];
+
+    txResult[0] = PAL_PER_CMD_TX_RESULT;
+    txResult[1] = pTest->testId;
+    txResult[2] = (uint8_t)(pTest->numSent >> 8);
+    txResult[3] = (uint8_t)pTest->numSent;
+    txResult[4] = (uint8_t)(pTest->numSuccess >> 8);
+    txResult[5] = (uint8_t)pTest->numSuccess;
+
+    (void)SRV_USI_Send_Message(pTest->usiHandler, SRV_USI_PROT_ID_PHY, txResult, sizeof(txResult));
+}
+
+static void lPAL_PerSendRxResults(void)
+{
+    PAL_PER_TEST_DATA *pTest = &palData.perTest;
+    PAL_PER_RX_GROUP *pGroup;
+    uint8_t rxResult[16 + (4U * PAL_PER_NUM_BINS)];
+    uint8_t *pData;
+    uint8_t numGroups = 0;
+    uint8_t index;
+    uint8_t bin;
+
+    for (index = 0; index < PAL_PER_NUM_GROUPS; index++)
+    {
+        pGroup = &pTest->rxGroups[index];
+        if (pGroup->valid == false)
+        {
+            break;
+        }
+
+        pData = rxResult;
+        *pData++ = PAL_PER_CMD_RX_RESULT;
+        *pData++ = (uint8_t)pGroup->scheme;
+        *pData++ = pGroup->attLevel;
+        *pData++ = (uint8_t)(pGroup->numFrames >> 8);
+        *pData++ = (uint8_t)pGroup->numFrames;
+        *pData++ = (uint8_t)(pGroup->received >> 8);
+        *pData++ = (uint8_t)pGroup->received;
+        *pData++ = (uint8_t)(pGroup->crcErrors >> 8);
+        *pData++ = (uint8_t)pGroup->crcErrors;
+        *pData++ = (uint8_t)(pGroup->bitErrors >> 24);
+        *pData++ = (uint8_t)(pGroup->bitErrors >> 16);
+        *pData++ = (uint8_t)(pGroup->bitErrors >> 8);
+        *pData++ = (uint8_t)pGroup->bitErrors;
+        *pData++ = (uint8_t)(pGroup->bitsReceived >> 24);
+        *pData++ = (uint8_t)(pGroup->bitsReceived >> 16);
+        *pData++ = (uint8_t)(pGroup->bitsReceived >> 8);
+        *pData++ = (uint8_t)pGroup->bitsReceived;
+        for (bin = 0; bin < PAL_PER_NUM_BINS; bin++)
+        {
+            *pData++ = (uint8_t)(pGroup->cinrHist[bin] >> 8);
+            *pData++ = (uint8_t)pGroup->cinrHist[bin];
+        }
+
+        for (bin = 0; bin < PAL_PER_NUM_BINS; bin++)
+        {
+            *pData++ = (uint8_t)(pGroup->evmHist[bin] >> 8);
+            *pData++ = (uint8_t)pGroup->evmHist[bin];
+        }
+
+        (void)SRV_USI_Send_Message(pTest->usiHandler, SRV_USI_PROT_ID_PHY,
+                rxResult, (size_t)(pData - rxResult));
+        numGroups++;
+    }
+
+    /* Frames with CRC error not matching any combination */
+    rxResult[0] = PAL_PER_CMD_RX_RESULT_END;
+    rxResult[1] = numGroups;
+    rxResult[2] = (uint8_t)(pTest->crcErrors >> 8);
+    rxResult[3] = (uint8_t)pTest->crcErrors;
+    (void)SRV_USI_Send_Message(pTest->usiHandler, SRV_USI_PROT_ID_PHY, rxResult, 4);
+}
+
+static bool lPAL_PerConfirm(PAL_MSG_CONFIRM_DATA *pData)
+{
+    PAL_PER_TEST_DATA *pTest = &palData.perTest;
+
+    if ((pTest->state != PAL_PER_STATE_TX_WAIT_CFM) || (pData->pch != pTest->pch) ||
+        (pData->bufId != PAL_PER_BUFFER_ID))
+    {
+        return false;
+    }
+
+    if (pData->result == PAL_TX_RESULT_SUCCESS)
+    {
+        pTest->numSuccess++;
+    }
+
+    pTest->state = PAL_PER_STATE_TX;
+
+    /* Confirm of a test frame is not reported to upper layer */
+    return true;
+}
+
+static bool lPAL_PerIndication(PAL_MSG_INDICATION_DATA *pData)
+{
+    PAL_PER_TEST_DATA *pTest = &palData.perTest;
+    PAL_PER_RX_GROUP *pGroup;
+    uint8_t *pRxData = pData->pData;
+    uint16_t crc;
+    uint16_t index;
+    uint16_t frameIndex;
+    uint16_t payloadEnd;
+    uint16_t bin;
+<#if PRIME_PAL_PLC_EN == true>
+    uint16_t evm;
+    uint8_t cinr;
+</#if>
+
+    if ((pData->dataLength < PAL_PER_MIN_DATA_SIZE) ||
+        (pRxData[0] != (uint8_t)'P') || (pRxData[1] != (uint8_t)'E') ||
+        (pRxData[2] != (uint8_t)'R') || (pRxData[3] != (uint8_t)'T'))
+    {
+        return false;
+    }
+
+    if (pTest->state != PAL_PER_STATE_RX)
+    {
+        /* Test frames are never reported to upper layer */
+        return true;
+    }
+
+    payloadEnd = pData->dataLength - PAL_PER_CRC_SIZE;
+    crc = ((uint16_t)pRxData[payloadEnd] << 8) | pRxData[payloadEnd + 1U];
+    if (crc != lPAL_PerGetCrc(pRxData, payloadEnd))
+    {
+        /* Header is not reliable: count the error in the combination of the
+         * last valid frame, which is sent in sequence with this one */
+        pGroup = pTest->pLastRxGroup;
+        if ((pGroup != NULL) && (pGroup->scheme == pData->scheme))
+        {
+            pGroup->crcErrors++;
+        }
+        else
+        {
+            pTest->crcErrors++;
+        }
+
+        return true;
+    }
+
+    pGroup = lPAL_PerGetRxGroup(pData->scheme, pRxData[6]);
+    if (pGroup == NULL)
+    {
+        return true;
+    }
+
+    pTest->pLastRxGroup = pGroup;
+    frameIndex = ((uint16_t)pRxData[7] << 8) | pRxData[8];
+    pGroup->numFrames = ((uint16_t)pRxData[9] << 8) | pRxData[10];
+    pGroup->received++;
+
+    for (index = PAL_PER_HEADER_SIZE; index < payloadEnd; index++)
+    {
+        pGroup->bitErrors += lPAL_PerGetBitErrors(pRxData[index] ^ (uint8_t)(frameIndex + index));
+    }
+
+    pGroup->bitsReceived += (uint32_t)(payloadEnd - PAL_PER_HEADER_SIZE) << 3;
+
+    /* LQI distribution for RF */
+    bin = (uint16_t)pData->lqi >> 4;
+
+<#if PRIME_PAL_PLC_EN == true>
+    if (pData->pch < PRIME_PAL_RF_CHN_MASK)
+    {
+        /* CINR distribution in 2 dB bins (CINR in 1/4 dB) for PLC */
+        PAL_PLC_GetRxQuality(&cinr, &evm);
+        bin = (uint16_t)cinr >> 3;
+
+        /* EVM distribution in 16 bins over the whole range */
+        pGroup->evmHist[evm >> 12]++;
+    }
+
+</#if>
+    if (bin >= PAL_PER_NUM_BINS)
+    {
+        bin = PAL_PER_NUM_BINS - 1U;
+    }
+
+    pGroup->cinrHist[bin]++;
+
+    return true;
+}
+
+static void lPAL_PerTasks(void)
+{
+    PAL_PER_TEST_DATA *pTest = &palData.perTest;
+    PAL_MSG_REQUEST_DATA txData;
+
+    if (pTest->state == PAL_PER_STATE_TX_WAIT_CFM)
+    {
+        if ((SRV_TIME_MANAGEMENT_GetTimeUS() - pTest->cfmWaitTime) >= PAL_PER_CFM_TIMEOUT_US)
+        {
+            /* Confirm lost: count the frame as failed and go on */
+            pTest->state = PAL_PER_STATE_TX;
+        }
+
+        return;
+    }
+
+    if (pTest->state != PAL_PER_STATE_TX)
+    {
+        return;
+    }
+
+    if (pTest->macTxPending > 0U)
+    {
+        /* Test frames share the TX buffer with the MAC frames still in flight */
+        if ((SRV_TIME_MANAGEMENT_GetTimeUS() - pTest->cfmWaitTime) < PAL_PER_CFM_TIMEOUT_US)
+        {
+            return;
+        }
+
+        /* Confirms lost */
+        pTest->macTxPending = 0;
+    }
+
+    if (pTest->frameIndex >= pTest->numFrames)
+    {
+        /* Next scheme, then next attenuation level */
+        pTest->frameIndex = 0;
+        pTest->schemeIndex++;
+        if (pTest->schemeIndex >= pTest->numSchemes)
+        {
+            pTest->schemeIndex = 0;
+            pTest->attIndex++;
+        }
+
+        if (pTest->attIndex >= pTest->numAttLevels)
+        {
+            pTest->state = PAL_PER_STATE_IDLE;
+            lPAL_PerSendTxResult();
+            return;
+        }
+    }
+
+    if ((int32_t)(SRV_TIME_MANAGEMENT_GetTimeUS() - pTest->nextTxTime) < 0)
+    {
+        return;
+    }
+
+    lPAL_PerBuildFrame();
+
+    (void)memset(&txData, 0, sizeof(txData));
+    txData.pData = pTest->txData;
+    txData.dataLength = pTest->dataLength;
+    txData.pch = pTest->pch;
+    txData.buffId = PAL_PER_BUFFER_ID;
+    txData.attLevel = pTest->attLevels[pTest->attIndex];
+    txData.scheme = pTest->schemes[pTest->schemeIndex];
+    txData.frameType = pTest->frameType;
+    txData.timeMode = PAL_TX_MODE_RELATIVE;
+    txData.disableRx = 1;
+
+    pTest->nextTxTime += pTest->periodUs;
+    pTest->frameIndex++;
+    pTest->numSent++;
+    pTest->cfmWaitTime = SRV_TIME_MANAGEMENT_GetTimeUS();
+    pTest->state = PAL_PER_STATE_TX_WAIT_CFM;
+
+    if (PAL_DataRequest(&txData) != (uint8_t)PAL_TX_RESULT_PROCESS)
+    {
+        pTest->state = PAL_PER_STATE_TX;
+    }
+}
+
+static void lPAL_PerStartTx(uint8_t *pData, size_t length)
+{
+    PAL_PER_TEST_DATA *pTest = &palData.perTest;
+    uint8_t numSchemes;
+    uint8_t numAttLevels;
+    uint8_t index;
+
+    /* Command, test id, pch (2), frames (2), period ms (2), length (2),
+       frame type, number of schemes, schemes, number of att levels, levels */
+    if (length < 12U)
+    {
+        return;
+    }
+
+    numSchemes = pData[11];
+    if ((numSchemes == 0U) || (numSchemes > PAL_PER_MAX_SCHEMES) ||
+        (length < (13U + (size_t)numSchemes)))
+    {
+        return;
+    }
+
+    numAttLevels = pData[12U + numSchemes];
+    if ((numAttLevels == 0U) || (numAttLevels > PAL_PER_MAX_ATT_LEVELS) ||
+        (length < (13U + (size_t)numSchemes + (size_t)numAttLevels)))
+    {
+        return;
+    }
+
+    pTest->testId = pData[1];
+    pTest->pch = ((uint16_t)pData[2] << 8) | pData[3];
+    pTest->numFrames = ((uint16_t)pData[4] << 8) | pData[5];
+    pTest->periodUs = (((uint32_t)pData[6] << 8) | pData[7]) * 1000U;
+    pTest->dataLength = ((uint16_t)pData[8] << 8) | pData[9];
+    pTest->frameType = (PAL_FRAME)pData[10];
+
+    if ((pTest->dataLength < PAL_PER_MIN_DATA_SIZE) || (pTest->dataLength > PAL_PER_MAX_DATA_SIZE))
+    {
+        return;
+    }
+
+    for (index = 0; index < numSchemes; index++)
+    {
+        pTest->schemes[index] = (PAL_SCHEME)pData[12U + index];
+    }
+
+    for (index = 0; index < numAttLevels; index++)
+    {
+        pTest->attLevels[index] = pData[13U + numSchemes + index];
+    }
+
+    pTest->numSchemes = numSchemes;
+    pTest->numAttLevels = numAttLevels;
+    pTest->schemeIndex = 0;
+    pTest->attIndex = 0;
+    pTest->frameIndex = 0;
+    pTest->numSent = 0;
+    pTest->numSuccess = 0;
+    pTest->nextTxTime = SRV_TIME_MANAGEMENT_GetTimeUS();
+    pTest->cfmWaitTime = pTest->nextTxTime;
+    pTest->state = PAL_PER_STATE_TX;
+}
+
+static void lPAL_PerUsiEventCb(uint8_t *pData, size_t length)
+{
+    PAL_PER_TEST_DATA *pTest = &palData.perTest;
+
+    /* Protection for invalid length */
+    if (length == 0U)
+    {
+        return;
+    }
+
+    switch (*pData)
+    {
+        case PAL_PER_CMD_START_TX:
+            lPAL_PerStartTx(pData, length);
+            break;
+
+        case PAL_PER_CMD_START_RX:
+            if (length >= 3U)
+            {
+                (void)memset(pTest->rxGroups, 0, sizeof(pTest->rxGroups));
+                pTest->pLastRxGroup = NULL;
+                pTest->crcErrors = 0;
+                pTest->pch = ((uint16_t)pData[1] << 8) | pData[2];
+                pTest->state = PAL_PER_STATE_RX;
+            }
+            break;
+
+        case PAL_PER_CMD_STOP:
+            if (pTest->state != PAL_PER_STATE_RX)
+            {
+                lPAL_PerSendTxResult();
+            }
+
+            pTest->state = PAL_PER_STATE_IDLE;
+            break;
+
+        case PAL_PER_CMD_GET_RESULTS:
+            lPAL_PerSendRxResults();
+            break;
+
+        default:
+            /* Unknown command */
+            break;
+    }
+}
+
+</#if>
+<#if (PRIME_PAL_PLC_EN == true) || (PRIME_PAL_RF_EN == true)>
+static void lPAL_DataConfirm(PAL_MSG_CONFIRM_DATA *pData)
+{
+<#if PRIME_PAL_AIRTIME == true>
+    /* Every transmission releases its airtime, test frames included */
+    lPAL_AirtimeConfirm(pData);
+
+</#if>
+<#if PRIME_PAL_PER_TEST == true>
+    if (lPAL_PerConfirm(pData) == true)
+    {
+        /* Test frame handled by the PER test engine */
+        return;
+    }
+
+    if (palData.perTest.macTxPending > 0U)
+    {
+        palData.perTest.macTxPending--;
+    }
+
+</#if>
+<#if PRIME_PAL_TX_SCHEDULER == true>
+    lPAL_TxSchedConfirm(pData);
+
+</#if>
+<#if PAL_MEDIUM_ADVISOR == true>
+    lPAL_AdvisorConfirm(pData);
+
+</#if>
+<#if PAL_HYBRID_DUPLICATE == true>
+    if (lPAL_DupMergeConfirm(pData) == true)
+    {
+        return;
+    }
+
+</#if>
+    if((palData.dataConfirmCallback) != NULL)
+    {
+        palData.dataConfirmCallback(pData);
+    }
+}
+
+</#if>
+<#if PRIME_PAL_PLC_EN == true>
+static void lPAL_PlcDataConfirmCallback(PAL_MSG_CONFIRM_DATA *pData)
+{
+    lPAL_DataConfirm(pData);
+}
+
+static void lPAL_PlcDataIndicationCallback(PAL_MSG_INDICATION_DATA *pData)
+{
+<#if PRIME_PAL_PER_TEST == true>
+    if (lPAL_PerIndication(pData) == true)
+    {
+        /* Test frame handled by the PER test engine */
+        return;
+    }
+
+</#if><#if PAL_PLC_TX_POWER_CONTROL == true>
+    lPAL_TxPowerIndication(pData);
+
+</#if><#if PAL_MEDIUM_ADVISOR == true>
+    lPAL_AdvisorIndication(pData);
+
+</#if>
+<#if PAL_HYBRID_DUPLICATE == true>
+    if (lPAL_DupCheckIndication(pData) == true)
+    {
+        /* Discard duplicated message */
+        return;
+    }
+
+</#if>
+    if((palData.dataIndicationCallback) != NULL)
+    {
+        palData.dataIndicationCallback(pData);
+    }
+}
+
+static void lPAL_PlcChannelSwitchCallback(uint16_t pch)
+{
+    if ((palData.channelSwitchCallback) != NULL)
+    {
+        palData.channelSwitchCallback(pch);
+    }
+}
+
+</#if>
+<#if PRIME_PAL_RF_EN == true>
+static void lPAL_RfDataConfirmCallback(PAL_MSG_CONFIRM_DATA *pData)
+{
+    lPAL_DataConfirm(pData);
+}
+
+static void lPAL_RfDataIndicationCallback(PAL_MSG_INDICATION_DATA *pData)
+{
+<#if PRIME_PAL_PER_TEST == true>
+    if (lPAL_PerIndication(pData) == true)
+    {
+        /* Test frame handled by the PER test engine */
+        return;
+    }
+
+</#if><#if PAL_MEDIUM_ADVISOR == true>
+    lPAL_AdvisorIndication(pData);
+
+</#if>
+<#if PAL_HYBRID_DUPLICATE == true>
+    if (lPAL_DupCheckIndication(pData) == true)
+    {
+        /* Discard duplicated message */
+        return;
+    }
+
+</#if>
+    if((palData.dataIndicationCallback) != NULL)
+    {
+        palData.dataIndicationCallback(pData);
+    }
+}
+
+<#if PRIME_PAL_RF_FREQ_HOPPING == true>
+static void lPAL_RfCHannelSwitchCallback(uint16_t pch)
+{
+    if ((palData.channelSwitchCallback) != NULL)
+    {
+        palData.channelSwitchCallback(pch);
+    }
+}
+
+</#if>
+</#if>
+<#if PRIME_PAL_SERIAL_EN == true>
+static void lPAL_SerialDataConfirmCallback(PAL_MSG_CONFIRM_DATA *pData)
+{
+    if((palData.dataConfirmCallback) != NULL)
+    {
+        palData.dataConfirmCallback(pData);
+    }
+}
+
+static void lPAL_SerialDataIndicationCallback(PAL_MSG_INDICATION_DATA *pData)
+{
+    if((palData.dataIndicationCallback) != NULL)
+    {
+        palData.dataIndicationCallback(pData);
+    }
+}
+
+</#if>
+<#if PRIME_PAL_PHY_SNIFFER == true>
+static void lPAL_PhySnifferCallback(uint8_t *pData, uint16_t length)
+{
+    if(palData.snifferEnabled > 0U)
+    {
+        (void)SRV_USI_Send_Message(palData.usiHandler, SRV_USI_PROT_ID_SNIF_PRIME,
+                pData, length);
+    }
+}
+
+static void lPAL_UsiSnifferEventCb(uint8_t *pData, size_t length)
+{
+    uint8_t command;
+
+    /* Protection for invalid length */
+    if(length == 0U)
+    {
+        return;
+    }
+
+    /* Process received command */
+    command = *pData;
+
+    switch(command)
+    {
+<#if (srv_psniffer.SRV_PSNF_PLC_PROFILE)??>
+        case (uint8_t)SRV_PSNIFFER_CMD_SET_PLC_CHANNEL:
+        {
+            uint8_t channel;
+
+            channel = *(pData + 1);
+            (void)PAL_SetConfiguration(1, (uint16_t)PLC_ID_CHANNEL_CFG, &channel, 1);
+            break;
+        }
+</#if>
+
+<#if (srv_rsniffer.SRV_RSNF_PROTOCOL)??>
+        case (uint8_t)SRV_RSNIFFER_CMD_SET_RF_BAND_OPM_CHANNEL:
+        {
+            uint16_t rfBandOpMode, rfChannel;
+            uint16_t rfPhyChannel=0U;
+
+            /* Parse Band, Operating Mode and Channel parameters */
+            SRV_RSNIFFER_ParseConfigCommand(pData, &rfBandOpMode, &rfChannel);
+
+            /* Set configuration in RF PHY */
+            (void)PAL_SetConfiguration(PRIME_PAL_RF_CHN_MASK, (uint16_t)PAL_ID_RF_PHY_BAND_OPERATING_MODE, &rfBandOpMode, 2U);
+
+            rfPhyChannel = (uint16_t)(PRIME_PAL_RF_CHN_MASK | rfChannel);
+
+            (void)PAL_SetChannel(rfPhyChannel);
+
+            break;
+        }
+</#if>
+
+        default:
+            /* Do Nothing */
+            break;
+    }
+}
+
+</#if>
+
+static __inline__ PAL_INTERFACE* __attribute__((always_inline)) lPAL_PointerToPalInterface(void const * pParam)
+{
+    union
+    {
+        const void* pPtr;
+        PAL_INTERFACE * pPalIntf;
+    }PAL_INTF_UNION;
+
+    PAL_INTF_UNION.pPtr = pParam;
+    return PAL_INTF_UNION.pPalIntf;
+}
+
+static PAL_INTERFACE * lPAL_GetInterface(uint16_t pch)
+{
+<#if PRIME_PAL_PLC_EN == true && PRIME_PAL_RF_EN == false && PRIME_PAL_SERIAL_EN == false>
+    (void)pch;
+    return lPAL_PointerToPalInterface(&PAL_PLC_Interface);
+<#elseif PRIME_PAL_PLC_EN == false && PRIME_PAL_RF_EN == true && PRIME_PAL_SERIAL_EN == false>
+    (void)pch;
+    return lPAL_PointerToPalInterface(&PAL_RF_Interface);
+<#elseif PRIME_PAL_PLC_EN == false && PRIME_PAL_RF_EN == false && PRIME_PAL_SERIAL_EN == true>
+    (void)pch;
+    return lPAL_PointerToPalInterface(&PAL_SERIAL_Interface);
+<#elseif PRIME_PAL_PLC_EN == false && PRIME_PAL_RF_EN == false && PRIME_PAL_SERIAL_EN == false>
+    #warning PAL interface is not defined. Please, review PRIME PAL interface configuration in MCC.
+<#else>
+  <#if PRIME_PAL_PLC_EN == true>
+    if (pch < PRIME_PAL_RF_CHN_MASK)
+    {
+        return lPAL_PointerToPalInterface(&PAL_PLC_Interface);
+    }
+
+  </#if>
+  <#if PRIME_PAL_RF_EN == true>
+    if (pch < PRIME_PAL_SERIAL_CHN_MASK)
+    {
+        return lPAL_PointerToPalInterface(&PAL_RF_Interface);
+    }
+
+  </#if>
+  <#if PRIME_PAL_SERIAL_EN == true>
+    if (pch == PRIME_PAL_SERIAL_CHN_MASK)
+    {
+        return lPAL_PointerToPalInterface(&PAL_SERIAL_Interface);
+    }
+
+  </#if>
+    return NULL;
+</#if>
+}
+
+static uint8_t lPAL_GetConfigurationIface(PAL_INTERFACE *palIface, uint16_t id, void *val,
+    uint16_t length)
+{
+    if(id == (uint16_t)PAL_ID_PHY_SNIFFER_EN)
+    {
+<#if PRIME_PAL_PHY_SNIFFER == true>
+        *(uint8_t *)val = palData.snifferEnabled;
+<#else>
+        *(uint8_t *)val = 0U;
+</#if>
+        return (uint8_t)PAL_CFG_SUCCESS;
+    }
+
+    return(palIface->MPAL_GetConfiguration(id, val, length));
+}
+
+static uint8_t lPAL_SetConfigurationIface(PAL_INTERFACE *palIface, uint16_t id, void *val,
+    uint16_t length)
+{
+    if (id == (uint16_t)PAL_ID_PHY_SNIFFER_EN)
+    {
+<#if PRIME_PAL_PHY_SNIFFER == true>
+        palData.snifferEnabled = *(uint8_t *)val;
+<#else>
+        palData.snifferEnabled = 0U;
+</#if>
+        return (uint8_t)PAL_CFG_SUCCESS;
+    }
+
+    return(palIface->MPAL_SetConfiguration(id, val, length));
+}
+
+<#if PRIME_PAL_AIRTIME == true>
+static uint64_t lPAL_AirtimeGetBudgetTime(PAL_AIRTIME_CHANNEL *pChannel)
+{
+    return (((uint64_t)PAL_AIRTIME_WINDOW_US * pChannel->counters.dutyCycleBudget) / 1000U);
+}
+
+static bool lPAL_AirtimeCheckBudget(PAL_AIRTIME_CHANNEL *pChannel, uint32_t duration)
+{
+    uint64_t usedTime;
+    uint8_t index;
+
+    if (pChannel->counters.dutyCycleBudget == 0U)
+    {
+        return true;
+    }
+
+    /* Take into account transmissions waiting for confirm */
+    usedTime = (uint64_t)pChannel->counters.windowTime + duration;
+    for (index = 0; index < PAL_AIRTIME_NUM_TX; index++)
+    {
+        if ((palData.airtimeTx[index].valid == true) &&
+            (palData.airtimeTx[index].pch == pChannel->counters.pch))
+        {
+            usedTime += palData.airtimeTx[index].duration;
+        }
+    }
+
+    return (usedTime <= lPAL_AirtimeGetBudgetTime(pChannel));
+}
+
+static uint8_t lPAL_AirtimeStoreTx(PAL_MSG_REQUEST_DATA *pData, uint32_t duration, PAL_AIRTIME_TX *pSaved)
+{
+    PAL_AIRTIME_TX *pTx;
+    uint8_t index;
+
+    /* Reuse the entry of the same buffer, if any */
+    for (index = 0; index < PAL_AIRTIME_NUM_TX; index++)
+    {
+        pTx = &palData.airtimeTx[index];
+        if ((pTx->valid == true) && (pTx->bufId == pData->buffId) && (pTx->pch == pData->pch))
+        {
+            break;
+        }
+    }
+
+    if (index == PAL_AIRTIME_NUM_TX)
+    {
+        pTx = &palData.airtimeTx[palData.airtimeTxNext];
+        index = palData.airtimeTxNext;
+        palData.airtimeTxNext = (uint8_t)((palData.airtimeTxNext + 1U) % PAL_AIRTIME_NUM_TX);
+    }
+
+    /* Stored before the PHY request, which may confirm synchronously. The
+     * entry is restored if the request is rejected */
+    *pSaved = *pTx;
+    pTx->duration = duration;
+    pTx->pch = pData->pch;
+    pTx->bufId = pData->buffId;
+    pTx->scheme = pData->scheme;
+    pTx->frameType = pData->frameType;
+    pTx->valid = true;
+
+    return index;
+}
+
+static void lPAL_AirtimeReleaseTx(uint8_t index, PAL_AIRTIME_TX *pSaved)
+{
+    /* Rejected request: no confirm comes, so the airtime is not charged */
+    palData.airtimeTx[index] = *pSaved;
+}
+
+static void lPAL_AirtimeDeferredConfirm(PAL_MSG_REQUEST_DATA *pData, PAL_TX_RESULT result)
+{
+    PAL_MSG_CONFIRM_DATA cfmData;
+
+    cfmData.txTime = 0;
+    cfmData.pch = pData->pch;
+    cfmData.rmsCalc = 0;
+    cfmData.frameType = pData->frameType;
+    cfmData.bufId = pData->buffId;
+    cfmData.result = result;
+
+    /* Same path as confirms from the PHY layer */
+    lPAL_DataConfirm(&cfmData);
+}
+
+static bool lPAL_AirtimeRequest(PAL_INTERFACE *palIface, PAL_MSG_REQUEST_DATA *pData, uint8_t *pResult)
+{
+    PAL_AIRTIME_TX txSaved;
+    PAL_AIRTIME_CHANNEL *pChannel;
+    PAL_AIRTIME_DEFERRED *pDeferred;
+    PAL_AIRTIME_DEFERRED *pFree = NULL;
+    uint32_t duration = 0;
+    uint8_t index;
+    uint8_t txIndex;
+    bool queued = false;
+
+    if (pData->pch >= PRIME_PAL_SERIAL_CHN_MASK)
+    {
+        return false;
+    }
+
+    if (pData->timeMode == PAL_TX_MODE_CANCEL)
+    {
+        /* Cancel a deferred request, which is not in the PHY layer yet */
+        for (index = 0; index < PAL_AIRTIME_NUM_DEFERRED; index++)
+        {
+            pDeferred = &palData.airtimeDeferred[index];
+            if ((pDeferred->valid == true) && (pDeferred->request.pData == pData->pData))
+            {
+                pDeferred->valid = false;
+                lPAL_AirtimeDeferredConfirm(&pDeferred->request, PAL_TX_RESULT_CANCELLED);
+                *pResult = (uint8_t)PAL_TX_RESULT_PROCESS;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    if (palIface->MPAL_GetMsgDuration(pData->dataLength, pData->scheme,
+            pData->frameType, &duration) != (uint8_t)PAL_CFG_SUCCESS)
+    {
+        return false;
+    }
+
+    lPAL_AirtimeUpdateWindow();
+
+    pChannel = lPAL_AirtimeGetChannel(pData->pch, false);
+    if ((pChannel != NULL) && (pChannel->counters.dutyCycleBudget != 0U))
+    {
+        if ((uint64_t)duration > lPAL_AirtimeGetBudgetTime(pChannel))
+        {
+            /* The message never fits in the budget */
+            *pResult = (uint8_t)PAL_TX_RESULT_INV_LENGTH;
+            return true;
+        }
+
+        for (index = 0; index < PAL_AIRTIME_NUM_DEFERRED; index++)
+        {
+            pDeferred = &palData.airtimeDeferred[index];
+            if (pDeferred->valid == false)
+            {
+                if (pFree == NULL)
+                {
+                    pFree = pDeferred;
+                }
+            }
+            else if (pDeferred->request.pch == pData->pch)
+            {
+                /* Keep order of requests of the same channel */
+                queued = true;
+            }
+            else
+            {
+                /* Deferred request of other channel */
+            }
+        }
+
+        if ((queued == true) || (lPAL_AirtimeCheckBudget(pChannel, duration) == false))
+        {
+            if (pFree == NULL)
+            {
+                *pResult = (uint8_t)PAL_TX_RESULT_BUSY_TX;
+                return true;
+            }
+
+            pFree->request = *pData;
+            pFree->duration = duration;
+            pFree->valid = true;
+            pChannel->counters.numDeferred++;
+
+            *pResult = (uint8_t)PAL_TX_RESULT_PROCESS;
+            return true;
+        }
+    }
+
+    txIndex = lPAL_AirtimeStoreTx(pData, duration, &txSaved);
+    *pResult = palIface->MPAL_DataRequest(pData);
+    if (*pResult != (uint8_t)PAL_TX_RESULT_PROCESS)
     {
-        palData.dataConfirmCallback(pData);
+        lPAL_AirtimeReleaseTx(txIndex, &txSaved);
     }
+
+    return true;
 }
 
-static void lPAL_PlcDataIndicationCallback(PAL_MSG_INDICATION_DATA *pData)
+static void lPAL_AirtimeTasks(void)
 {
-    if((palData.dataIndicationCallback) != NULL)
+    PAL_AIRTIME_CHANNEL *pChannel;
+    PAL_AIRTIME_DEFERRED *pDeferred;
+    PAL_MSG_REQUEST_DATA *pRequest;
+    PAL_INTERFACE *palIface;
+    PAL_AIRTIME_TX txSaved;
+    uint8_t index;
+    uint8_t txIndex;
+    uint8_t result;
+
+    lPAL_AirtimeUpdateWindow();
+
+    for (index = 0; index < PAL_AIRTIME_NUM_DEFERRED; index++)
     {
-        palData.dataIndicationCallback(pData);
+        pDeferred = &palData.airtimeDeferred[index];
+        if (pDeferred->valid == false)
+        {
+            continue;
+        }
+
+        pRequest = &pDeferred->request;
+        pChannel = lPAL_AirtimeGetChannel(pRequest->pch, false);
+        if ((pChannel != NULL) && (lPAL_AirtimeCheckBudget(pChannel, pDeferred->duration) == false))
+        {
+            continue;
+        }
+
+        palIface = lPAL_GetInterface(pRequest->pch);
+        if (palIface == NULL)
+        {
+            pDeferred->valid = false;
+            lPAL_AirtimeDeferredConfirm(pRequest, PAL_TX_RESULT_PHY_ERROR);
+            continue;
+        }
+
+        /* Absolute time is kept: the PHY layer reports a request whose time
+         * has passed while it was deferred */
+        txIndex = lPAL_AirtimeStoreTx(pRequest, pDeferred->duration, &txSaved);
+        result = palIface->MPAL_DataRequest(pRequest);
+        if (result != (uint8_t)PAL_TX_RESULT_PROCESS)
+        {
+            lPAL_AirtimeReleaseTx(txIndex, &txSaved);
+        }
+
+        if (result == (uint8_t)PAL_TX_RESULT_BUSY_TX)
+        {
+            /* PHY layer busy: keep the request deferred */
+            continue;
+        }
+
+        pDeferred->valid = false;
+
+        if (result != (uint8_t)PAL_TX_RESULT_PROCESS)
+        {
+            lPAL_AirtimeDeferredConfirm(pRequest, (PAL_TX_RESULT)result);
+        }
     }
 }
 
 </#if>
-<#if PRIME_PAL_RF_EN == true>
-static void lPAL_RfDataConfirmCallback(PAL_MSG_CONFIRM_DATA *pData)
+<#if PRIME_PAL_TX_SCHEDULER == true>
+static bool lPAL_TxSchedSameFrontEnd(uint8_t mediumA, uint8_t mediumB)
 {
-    if((palData.dataConfirmCallback) != NULL)
-    {
-        palData.dataConfirmCallback(pData);
-    }
+<#if PRIME_PAL_TX_SCHED_SHARED_FE == true>
+    /* PLC and RF transmissions use the same front-end */
+    (void)mediumA;
+    (void)mediumB;
+
+    return true;
+<#else>
+    return (mediumA == mediumB);
+</#if>
 }
 
-static void lPAL_RfDataIndicationCallback(PAL_MSG_INDICATION_DATA *pData)
+static bool lPAL_TxSchedFindConflict(uint8_t medium, uint32_t startTime,
+    uint32_t endTime, uint32_t *pConflictEnd, bool *pSwitch)
 {
-    if((palData.dataIndicationCallback) != NULL)
+    PAL_TX_SCHED_ENTRY *pEntry;
+    PAL_TX_SCHED_SWITCH *pSwitchData;
+    uint8_t index;
+
+    for (index = 0; index < palData.txSchedCounters.numActive; index++)
     {
-        palData.dataIndicationCallback(pData);
+        pEntry = &palData.txSchedTable[index];
+        if (lPAL_TxSchedSameFrontEnd(medium, pEntry->medium) == false)
+        {
+            continue;
+        }
+
+        if (((int32_t)(startTime - (pEntry->endTime + PAL_TX_SCHED_GUARD_US)) < 0) &&
+            ((int32_t)(pEntry->startTime - (endTime + PAL_TX_SCHED_GUARD_US)) < 0))
+        {
+            *pConflictEnd = pEntry->endTime;
+            *pSwitch = false;
+            return true;
+        }
     }
-}
 
-<#if PRIME_PAL_RF_FREQ_HOPPING == true>
-static void lPAL_RfCHannelSwitchCallback(uint16_t pch)
-{
-    if ((palData.channelSwitchCallback) != NULL)
+    for (index = 0; index < PAL_TX_SCHED_NUM_MEDIUMS; index++)
     {
-        palData.channelSwitchCallback(pch);
+        pSwitchData = &palData.txSchedSwitch[index];
+        if ((pSwitchData->valid == false) || (lPAL_TxSchedSameFrontEnd(medium, index) == false))
+        {
+            continue;
+        }
+
+        /* Channel must not be switched during the transmission */
+        if (((int32_t)(pSwitchData->time - (startTime - PAL_TX_SCHED_GUARD_US)) >= 0) &&
+            ((int32_t)((endTime + PAL_TX_SCHED_GUARD_US) - pSwitchData->time) >= 0))
+        {
+            *pConflictEnd = pSwitchData->time;
+            *pSwitch = true;
+            return true;
+        }
     }
+
+    return false;
 }
 
-</#if>
-</#if>
-<#if PRIME_PAL_SERIAL_EN == true>
-static void lPAL_SerialDataConfirmCallback(PAL_MSG_CONFIRM_DATA *pData)
+static void lPAL_TxSchedInsert(uint8_t medium, PAL_MSG_REQUEST_DATA *pData,
+    uint32_t startTime, uint32_t endTime)
 {
-    if((palData.dataConfirmCallback) != NULL)
+    PAL_TX_SCHED_ENTRY *pEntry;
+    uint8_t index;
+
+    /* A buffer identifier has only one transmission in progress */
+    lPAL_TxSchedRelease(medium, pData->buffId);
+
+    if (palData.txSchedCounters.numActive >= PAL_TX_SCHED_SIZE)
     {
-        palData.dataConfirmCallback(pData);
+        /* Transmit without reservation */
+        palData.txSchedCounters.numOverflows++;
+        return;
     }
-}
 
-static void lPAL_SerialDataIndicationCallback(PAL_MSG_INDICATION_DATA *pData)
-{
-    if((palData.dataIndicationCallback) != NULL)
+    index = palData.txSchedCounters.numActive;
+    while ((index > 0U) &&
+           ((int32_t)(palData.txSchedTable[index - 1U].startTime - startTime) > 0))
     {
-        palData.dataIndicationCallback(pData);
+        palData.txSchedTable[index] = palData.txSchedTable[index - 1U];
+        index--;
     }
+
+    pEntry = &palData.txSchedTable[index];
+    pEntry->startTime = startTime;
+    pEntry->endTime = endTime;
+    pEntry->pData = pData->pData;
+    pEntry->bufId = pData->buffId;
+    pEntry->medium = medium;
+
+    palData.txSchedCounters.numActive++;
+    palData.txSchedCounters.numReservations++;
 }
 
-</#if>
-<#if PRIME_PAL_PHY_SNIFFER == true>
-static void lPAL_PhySnifferCallback(uint8_t *pData, uint16_t length)
+static uint8_t lPAL_TxSchedRequest(PAL_INTERFACE *palIface, PAL_MSG_REQUEST_DATA *pData)
 {
-    if(palData.snifferEnabled > 0U)
+    uint32_t duration = 0;
+    uint32_t startTime;
+    uint32_t endTime;
+    uint32_t conflictEnd = 0;
+    uint8_t medium;
+    uint8_t index;
+    bool isSwitch = false;
+    bool overlapTx = false;
+    bool overlapSwitch = false;
+
+    if (pData->pch >= PRIME_PAL_SERIAL_CHN_MASK)
     {
-        (void)SRV_USI_Send_Message(palData.usiHandler, SRV_USI_PROT_ID_SNIF_PRIME,
-                pData, length);
+        return((uint8_t)PAL_TX_RESULT_PROCESS);
     }
-}
 
-static void lPAL_UsiSnifferEventCb(uint8_t *pData, size_t length)
-{
-    uint8_t command;
+    medium = lPAL_TxSchedGetMedium(pData->pch);
 
-    /* Protection for invalid length */
-    if(length == 0U)
+    if (pData->timeMode == PAL_TX_MODE_CANCEL)
     {
-        return;
+        for (index = 0; index < palData.txSchedCounters.numActive; index++)
+        {
+            if ((palData.txSchedTable[index].medium == medium) &&
+                (palData.txSchedTable[index].pData == pData->pData))
+            {
+                lPAL_TxSchedRemove(index);
+                break;
+            }
+        }
+
+        return((uint8_t)PAL_TX_RESULT_PROCESS);
     }
 
-    /* Process received command */
-    command = *pData;
+    /* Only transmissions in absolute time are reserved */
+    if (pData->timeMode != PAL_TX_MODE_ABSOLUTE)
+    {
+        return((uint8_t)PAL_TX_RESULT_PROCESS);
+    }
 
-    switch(command)
+    if (palIface->MPAL_GetMsgDuration(pData->dataLength, pData->scheme,
+            pData->frameType, &duration) != (uint8_t)PAL_CFG_SUCCESS)
     {
-<#if (srv_psniffer.SRV_PSNF_PLC_PROFILE)??>
-        case (uint8_t)SRV_PSNIFFER_CMD_SET_PLC_CHANNEL:
-        {
-            uint8_t channel;
+        /* Unknown duration: let the PHY layer validate the request */
+        return((uint8_t)PAL_TX_RESULT_PROCESS);
+    }
 
-            channel = *(pData + 1);
-            (void)PAL_SetConfiguration(1, (uint16_t)PLC_ID_CHANNEL_CFG, &channel, 1);
+    lPAL_TxSchedPurge(SRV_TIME_MANAGEMENT_GetTimeUS());
+
+    startTime = pData->timeDelay;
+    endTime = startTime + duration;
+
+    /* Each iteration moves the request after one conflict */
+    for (index = 0; index <= (PAL_TX_SCHED_SIZE + PAL_TX_SCHED_NUM_MEDIUMS); index++)
+    {
+        if (lPAL_TxSchedFindConflict(medium, startTime, endTime, &conflictEnd, &isSwitch) == false)
+        {
             break;
         }
-</#if>
 
-<#if (srv_rsniffer.SRV_RSNF_PROTOCOL)??>
-        case (uint8_t)SRV_RSNIFFER_CMD_SET_RF_BAND_OPM_CHANNEL:
+        if (isSwitch == true)
         {
-            uint16_t rfBandOpMode, rfChannel;
-            uint16_t rfPhyChannel=0U;
-
-            /* Parse Band, Operating Mode and Channel parameters */
-            SRV_RSNIFFER_ParseConfigCommand(pData, &rfBandOpMode, &rfChannel);
-
-            /* Set configuration in RF PHY */
-            (void)PAL_SetConfiguration(PRIME_PAL_RF_CHN_MASK, (uint16_t)PAL_ID_RF_PHY_BAND_OPERATING_MODE, &rfBandOpMode, 2U);
-
-            rfPhyChannel = (uint16_t)(PRIME_PAL_RF_CHN_MASK | rfChannel);
-
-            (void)PAL_SetChannel(rfPhyChannel);
+            overlapSwitch = true;
+        }
+        else
+        {
+            overlapTx = true;
+        }
 
+<#if PRIME_PAL_TX_SCHED_DELAY == true>
+        startTime = conflictEnd + PAL_TX_SCHED_GUARD_US;
+        endTime = startTime + duration;
+        if ((startTime - pData->timeDelay) > PAL_TX_SCHED_MAX_DELAY_US)
+        {
             break;
         }
+<#else>
+        break;
 </#if>
+    }
 
-        default:
-            /* Do Nothing */
-            break;
+    if (overlapTx == true)
+    {
+        palData.txSchedCounters.numConflicts++;
     }
-}
 
-</#if>
+    if (overlapSwitch == true)
+    {
+        palData.txSchedCounters.numSwitchConflicts++;
+    }
 
-static __inline__ PAL_INTERFACE* __attribute__((always_inline)) lPAL_PointerToPalInterface(void const * pParam)
-{
-    union
+<#if PRIME_PAL_TX_SCHED_DELAY == true>
+    if ((overlapTx == true) || (overlapSwitch == true))
     {
-        const void* pPtr;
-        PAL_INTERFACE * pPalIntf;
-    }PAL_INTF_UNION;
+        if ((index > (PAL_TX_SCHED_SIZE + PAL_TX_SCHED_NUM_MEDIUMS)) ||
+            ((startTime - pData->timeDelay) > PAL_TX_SCHED_MAX_DELAY_US))
+        {
+            palData.txSchedCounters.numRejected++;
+            return((uint8_t)PAL_TX_RESULT_BUSY_TX);
+        }
 
-    PAL_INTF_UNION.pPtr = pParam;
-    return PAL_INTF_UNION.pPalIntf;
+        /* Transmit after the conflicting reservations */
+        palData.txSchedCounters.numDelayed++;
+        pData->timeDelay = startTime;
+    }
+<#else>
+    if ((overlapTx == true) || (overlapSwitch == true))
+    {
+        palData.txSchedCounters.numRejected++;
+        return((uint8_t)PAL_TX_RESULT_BUSY_TX);
+    }
+</#if>
+
+    lPAL_TxSchedInsert(medium, pData, startTime, endTime);
+
+    return((uint8_t)PAL_TX_RESULT_PROCESS);
 }
 
-static PAL_INTERFACE * lPAL_GetInterface(uint16_t pch)
+static void lPAL_TxSchedProgramSwitch(uint32_t timeSync, uint16_t pch, uint8_t timeMode)
 {
-<#if PRIME_PAL_PLC_EN == true && PRIME_PAL_RF_EN == false && PRIME_PAL_SERIAL_EN == false>
-    (void)pch;
-    return lPAL_PointerToPalInterface(&PAL_PLC_Interface);
-<#elseif PRIME_PAL_PLC_EN == false && PRIME_PAL_RF_EN == true && PRIME_PAL_SERIAL_EN == false>
-    (void)pch;
-    return lPAL_PointerToPalInterface(&PAL_RF_Interface);
-<#elseif PRIME_PAL_PLC_EN == false && PRIME_PAL_RF_EN == false && PRIME_PAL_SERIAL_EN == true>
-    (void)pch;
-    return lPAL_PointerToPalInterface(&PAL_SERIAL_Interface);
-<#elseif PRIME_PAL_PLC_EN == false && PRIME_PAL_RF_EN == false && PRIME_PAL_SERIAL_EN == false>
-    #warning PAL interface is not defined. Please, review PRIME PAL interface configuration in MCC.
-<#else>
-  <#if PRIME_PAL_PLC_EN == true>
-    if (pch < PRIME_PAL_RF_CHN_MASK)
+    PAL_TX_SCHED_SWITCH *pSwitch;
+
+    if (pch >= PRIME_PAL_SERIAL_CHN_MASK)
     {
-        return lPAL_PointerToPalInterface(&PAL_PLC_Interface);
+        return;
     }
 
-  </#if>
-  <#if PRIME_PAL_RF_EN == true>
-    if (pch < PRIME_PAL_SERIAL_CHN_MASK)
+    pSwitch = &palData.txSchedSwitch[lPAL_TxSchedGetMedium(pch)];
+
+    if (timeMode == (uint8_t)PAL_TX_MODE_ABSOLUTE)
     {
-        return lPAL_PointerToPalInterface(&PAL_RF_Interface);
+        pSwitch->time = timeSync;
+        pSwitch->valid = true;
+    }
+    else if (timeMode == (uint8_t)PAL_TX_MODE_RELATIVE)
+    {
+        pSwitch->time = SRV_TIME_MANAGEMENT_GetTimeUS() + timeSync;
+        pSwitch->valid = true;
     }
+    else
+    {
+        pSwitch->valid = false;
+    }
+}
 
-  </#if>
-  <#if PRIME_PAL_SERIAL_EN == true>
-    if (pch == PRIME_PAL_SERIAL_CHN_MASK)
+</#if>
+static uint8_t lPAL_TxRequest(PAL_INTERFACE *palIface, PAL_MSG_REQUEST_DATA *pData)
+{
+<#if PRIME_PAL_AIRTIME == true>
+    uint8_t result;
+
+    /* Request may be deferred or rejected by the duty-cycle budget. Otherwise
+     * it is sent and its airtime is charged only if the PHY layer takes it */
+    if (lPAL_AirtimeRequest(palIface, pData, &result) == true)
     {
-        return lPAL_PointerToPalInterface(&PAL_SERIAL_Interface);
+        return result;
     }
 
-  </#if>
-    return NULL;
 </#if>
+    return(palIface->MPAL_DataRequest(pData));
 }
 
 // *****************************************************************************
@@ -273,6 +2103,35 @@ SYS_MODULE_OBJ PAL_Initialize(const SYS_MODULE_INDEX index)
     }
 
     palData.snifferEnabled = 0;
+<#if (PAL_MEDIUM_ADVISOR == true) || (PAL_PLC_TX_POWER_CONTROL == true)>
+    palData.neighborIdCallback = NULL;
+</#if>
+<#if PAL_PLC_TX_POWER_CONTROL == true>
+    (void)memset(palData.txpcTable, 0, sizeof(palData.txpcTable));
+</#if>
+<#if PAL_MEDIUM_ADVISOR == true>
+    (void)memset(palData.advisorTable, 0, sizeof(palData.advisorTable));
+    palData.advisorTxNeighborId[PAL_ADVISOR_MEDIUM_PLC] = PAL_NEIGHBOR_ID_INVALID;
+    palData.advisorTxNeighborId[PAL_ADVISOR_MEDIUM_RF] = PAL_NEIGHBOR_ID_INVALID;
+</#if>
+<#if PRIME_PAL_AIRTIME == true>
+    (void)memset(palData.airtimeChannels, 0, sizeof(palData.airtimeChannels));
+    (void)memset(palData.airtimeTx, 0, sizeof(palData.airtimeTx));
+    (void)memset(palData.airtimeDeferred, 0, sizeof(palData.airtimeDeferred));
+    palData.airtimeSlotStart = SRV_TIME_MANAGEMENT_GetTimeUS64();
+    palData.airtimeSlotIndex = 0;
+    palData.airtimeTxNext = 0;
+</#if>
+<#if PRIME_PAL_TX_SCHEDULER == true>
+    (void)memset(palData.txSchedTable, 0, sizeof(palData.txSchedTable));
+    (void)memset(palData.txSchedSwitch, 0, sizeof(palData.txSchedSwitch));
+    (void)memset(&palData.txSchedCounters, 0, sizeof(palData.txSchedCounters));
+</#if>
+<#if PAL_HYBRID_DUPLICATE == true>
+    (void)memset(&palData.dupTxData, 0, sizeof(palData.dupTxData));
+    (void)memset(palData.dupIndTable, 0, sizeof(palData.dupIndTable));
+    palData.dupIndNext = 0;
+</#if>
 
 <#if PRIME_PAL_PHY_SNIFFER == true>
     /* Open USI */
@@ -287,6 +2146,25 @@ SYS_MODULE_OBJ PAL_Initialize(const SYS_MODULE_INDEX index)
             SRV_USI_PROT_ID_SNIF_PRIME, lPAL_UsiSnifferEventCb);
 
 
+</#if>
+<#if PRIME_PAL_PER_TEST == true>
+    /* Open USI for PER test engine */
+    (void)memset(&palData.perTest, 0, sizeof(palData.perTest));
+    palData.perTest.state = PAL_PER_STATE_IDLE;
+<#if (PRIME_PAL_PHY_SNIFFER == true) && (PRIME_PAL_PER_TEST_USI_INSTANCE == PRIME_PAL_PHY_SNIFFER_USI_INSTANCE)>
+    /* USI instance already opened for PHY sniffer */
+    palData.perTest.usiHandler = palData.usiHandler;
+<#else>
+    palData.perTest.usiHandler = SRV_USI_Open(PRIME_PAL_PER_TEST_USI_INSTANCE);
+    if (palData.perTest.usiHandler == DRV_HANDLE_INVALID)
+    {
+        return SYS_MODULE_OBJ_INVALID;
+    }
+</#if>
+
+    SRV_USI_CallbackRegister(palData.perTest.usiHandler,
+            SRV_USI_PROT_ID_PHY, lPAL_PerUsiEventCb);
+
 </#if>
 <#if PRIME_PAL_PLC_EN == true>
     if (PAL_PLC_Initialize() == SYS_MODULE_OBJ_INVALID)
@@ -296,6 +2174,7 @@ SYS_MODULE_OBJ PAL_Initialize(const SYS_MODULE_INDEX index)
 
     PAL_PLC_DataConfirmCallbackRegister(lPAL_PlcDataConfirmCallback);
     PAL_PLC_DataIndicationCallbackRegister(lPAL_PlcDataIndicationCallback);
+    PAL_PLC_ChannelSwitchCallbackRegister(lPAL_PlcChannelSwitchCallback);
 
   <#if PRIME_PAL_PHY_SNIFFER == true>
     /* Register PLC PHY Sniffer callback */
@@ -352,6 +2231,7 @@ void PAL_Enable(SYS_MODULE_OBJ object, uint8_t enablePAL)
         /* Remove callbacks */
         PAL_PLC_DataConfirmCallbackRegister(NULL);
         PAL_PLC_DataIndicationCallbackRegister(NULL);
+        PAL_PLC_ChannelSwitchCallbackRegister(NULL);
 
   <#if PRIME_PAL_PHY_SNIFFER == true>
         PAL_PLC_USISnifferCallbackRegister(palData.usiHandler, NULL);
@@ -362,6 +2242,7 @@ void PAL_Enable(SYS_MODULE_OBJ object, uint8_t enablePAL)
         /* Register callbacks */
         PAL_PLC_DataConfirmCallbackRegister(lPAL_PlcDataConfirmCallback);
         PAL_PLC_DataIndicationCallbackRegister(lPAL_PlcDataIndicationCallback);
+        PAL_PLC_ChannelSwitchCallbackRegister(lPAL_PlcChannelSwitchCallback);
 
   <#if PRIME_PAL_PHY_SNIFFER == true>
         /* Register PLC PHY Sniffer callback */
@@ -444,6 +2325,119 @@ void PAL_Tasks(SYS_MODULE_OBJ object)
     PAL_SERIAL_Tasks();
 
 </#if>
+<#if PRIME_PAL_AIRTIME == true>
+    lPAL_AirtimeTasks();
+
+</#if>
+<#if PRIME_PAL_PER_TEST == true>
+    lPAL_PerTasks();
+
+</#if>
+}
+
+uint32_t PAL_GetNextDeadline(SYS_MODULE_OBJ object)
+{
+    uint32_t deadline = PAL_DEADLINE_NONE;
+<#if (PRIME_PAL_PLC_EN == true) || (PRIME_PAL_RF_EN == true) || (PRIME_PAL_SERIAL_EN == true)>
+    uint32_t deadlineMedium;
+</#if>
+<#if PRIME_PAL_AIRTIME == true>
+    uint64_t slotEnd;
+    uint64_t timeNow;
+    uint8_t index;
+</#if>
+<#if PRIME_PAL_PER_TEST == true>
+    uint32_t timeTarget;
+    int32_t timeToTx;
+</#if>
+
+    if (object != PRIME_PAL_INDEX)
+    {
+        return PAL_DEADLINE_NONE;
+    }
+
+<#if PRIME_PAL_PLC_EN == true>
+    deadlineMedium = PAL_PLC_GetNextDeadline();
+    if (deadlineMedium < deadline)
+    {
+        deadline = deadlineMedium;
+    }
+
+</#if>
+<#if PRIME_PAL_RF_EN == true>
+    deadlineMedium = PAL_RF_GetNextDeadline();
+    if (deadlineMedium < deadline)
+    {
+        deadline = deadlineMedium;
+    }
+
+</#if>
+<#if PRIME_PAL_SERIAL_EN == true>
+    deadlineMedium = PAL_SERIAL_GetNextDeadline();
+    if (deadlineMedium < deadline)
+    {
+        deadline = deadlineMedium;
+    }
+
+</#if>
+<#if PRIME_PAL_AIRTIME == true>
+    for (index = 0; index < PAL_AIRTIME_NUM_DEFERRED; index++)
+    {
+        if (palData.airtimeDeferred[index].valid == true)
+        {
+            /* Deferred requests are retried when budget is released */
+            slotEnd = palData.airtimeSlotStart + PAL_AIRTIME_SLOT_US;
+            timeNow = SRV_TIME_MANAGEMENT_GetTimeUS64();
+            if (slotEnd <= timeNow)
+            {
+                deadline = 0;
+            }
+            else if ((slotEnd - timeNow) < (uint64_t)deadline)
+            {
+                deadline = (uint32_t)(slotEnd - timeNow);
+            }
+            else
+            {
+                /* Later than other deadlines */
+            }
+
+            break;
+        }
+    }
+
+</#if>
+<#if PRIME_PAL_PER_TEST == true>
+    if ((palData.perTest.state == PAL_PER_STATE_TX) ||
+        (palData.perTest.state == PAL_PER_STATE_TX_WAIT_CFM))
+    {
+        if ((palData.perTest.state == PAL_PER_STATE_TX_WAIT_CFM) ||
+            (palData.perTest.macTxPending > 0U))
+        {
+            /* Waiting for a confirm: wake up when it is given up */
+            timeTarget = palData.perTest.cfmWaitTime + PAL_PER_CFM_TIMEOUT_US;
+        }
+        else
+        {
+            timeTarget = palData.perTest.nextTxTime;
+        }
+
+        timeToTx = (int32_t)(timeTarget - SRV_TIME_MANAGEMENT_GetTimeUS());
+        if (timeToTx <= 0)
+        {
+            deadline = 0;
+        }
+        else if ((uint32_t)timeToTx < deadline)
+        {
+            deadline = (uint32_t)timeToTx;
+        }
+        else
+        {
+            /* Later than other deadlines */
+        }
+    }
+
+</#if>
+    return deadline;
 }
 
 SYS_STATUS PAL_Status(SYS_MODULE_OBJ object)
@@ -563,15 +2557,292 @@ void PAL_CallbackRegister(PAL_CALLBACKS *pCallbacks)
 uint8_t PAL_DataRequest(PAL_MSG_REQUEST_DATA *pData)
 {
     PAL_INTERFACE *palIface = lPAL_GetInterface(pData->pch);
+    uint8_t result;
+<#if PAL_PLC_TX_POWER_CONTROL == true>
+    uint8_t attLevel;
+</#if>
+<#if PRIME_PAL_TX_SCHEDULER == true>
+    uint32_t timeDelay;
+</#if>
+<#if PRIME_PAL_PER_TEST == true>
+    bool macFrame = (pData->pData != palData.perTest.txData);
+
+    if ((palData.perTest.state != PAL_PER_STATE_IDLE) && (macFrame == true))
+    {
+        /* PHY and TX buffer in use by the PER test */
+        return((uint8_t)PAL_TX_RESULT_BUSY_TX);
+    }
+</#if>
 
     if (palIface != NULL)
     {
-        return(palIface->MPAL_DataRequest(pData));
+<#if PAL_MEDIUM_ADVISOR == true>
+        lPAL_AdvisorRequest(pData);
+
+</#if>
+<#if PAL_PLC_TX_POWER_CONTROL == true>
+        attLevel = pData->attLevel;
+        lPAL_TxPowerRequest(pData);
+
+</#if>
+<#if PRIME_PAL_TX_SCHEDULER == true>
+        /* Absolute time requests may be delayed or rejected on conflict */
+        timeDelay = pData->timeDelay;
+        result = lPAL_TxSchedRequest(palIface, pData);
+        if (result == (uint8_t)PAL_TX_RESULT_PROCESS)
+        {
+            result = lPAL_TxRequest(palIface, pData);
+            if ((result != (uint8_t)PAL_TX_RESULT_PROCESS) && (pData->timeMode == PAL_TX_MODE_ABSOLUTE))
+            {
+                /* Rejected by the PHY layer: release the reservation */
+                lPAL_TxSchedRelease(lPAL_TxSchedGetMedium(pData->pch), pData->buffId);
+            }
+        }
+
+        /* Restore the time requested by the upper layer */
+        pData->timeDelay = timeDelay;
+<#else>
+        result = lPAL_TxRequest(palIface, pData);
+</#if>
+<#if PAL_PLC_TX_POWER_CONTROL == true>
+
+        /* Restore the attenuation level requested by the upper layer */
+        pData->attLevel = attLevel;
+</#if>
+<#if PRIME_PAL_PER_TEST == true>
+
+        if ((result == (uint8_t)PAL_TX_RESULT_PROCESS) && (macFrame == true))
+        {
+            /* Test frames wait for the confirm of this frame */
+            palData.perTest.macTxPending++;
+        }
+</#if>
+
+        return result;
     }
 
     return((uint8_t)PAL_TX_RESULT_PHY_ERROR);
 }
 
+uint8_t PAL_DataRequestDuplicate(PAL_MSG_REQUEST_DATA *pDataPrimary,
+    PAL_MSG_REQUEST_DATA *pDataSecondary)
+{
+<#if PAL_HYBRID_DUPLICATE == true>
+    PAL_DUP_TX_DATA *pDup = &palData.dupTxData;
+    uint8_t resultPrimary;
+    uint8_t resultSecondary;
+
+    /* Both requests must use different mediums */
+    if (lPAL_IsRfPch(pDataPrimary->pch) == lPAL_IsRfPch(pDataSecondary->pch))
+    {
+        return((uint8_t)PAL_TX_RESULT_INV_PARAM);
+    }
+
+    if (pDup->active == true)
+    {
+        return((uint8_t)PAL_TX_RESULT_BUSY_TX);
+    }
+
+    pDup->pchPrimary = pDataPrimary->pch;
+    pDup->pchSecondary = pDataSecondary->pch;
+    pDup->bufIdPrimary = pDataPrimary->buffId;
+    pDup->bufIdSecondary = pDataSecondary->buffId;
+    pDup->pendingCfm = PAL_DUP_CFM_PRIMARY | PAL_DUP_CFM_SECONDARY;
+    pDup->cfmValid = false;
+    pDup->active = true;
+
+    resultSecondary = PAL_DataRequest(pDataSecondary);
+    if (resultSecondary != (uint8_t)PAL_TX_RESULT_PROCESS)
+    {
+        pDup->pendingCfm &= (uint8_t)(~PAL_DUP_CFM_SECONDARY);
+    }
+
+    resultPrimary = PAL_DataRequest(pDataPrimary);
+    if (resultPrimary != (uint8_t)PAL_TX_RESULT_PROCESS)
+    {
+        pDup->pendingCfm &= (uint8_t)(~PAL_DUP_CFM_PRIMARY);
+    }
+
+    if ((resultPrimary != (uint8_t)PAL_TX_RESULT_PROCESS) &&
+        (resultSecondary != (uint8_t)PAL_TX_RESULT_PROCESS))
+    {
+        pDup->active = false;
+        return resultPrimary;
+    }
+
+    if (pDup->cfmValid == false)
+    {
+        /* Report the error of a rejected request if the other one fails */
+        if (resultPrimary != (uint8_t)PAL_TX_RESULT_PROCESS)
+        {
+            pDup->cfmData.txTime = 0;
+            pDup->cfmData.pch = pDataPrimary->pch;
+            pDup->cfmData.rmsCalc = 0;
+            pDup->cfmData.frameType = pDataPrimary->frameType;
+            pDup->cfmData.bufId = pDataPrimary->buffId;
+            pDup->cfmData.result = (PAL_TX_RESULT)resultPrimary;
+            pDup->cfmValid = true;
+        }
+        else if (resultSecondary != (uint8_t)PAL_TX_RESULT_PROCESS)
+        {
+            pDup->cfmData.txTime = 0;
+            pDup->cfmData.pch = pDataSecondary->pch;
+            pDup->cfmData.rmsCalc = 0;
+            pDup->cfmData.frameType = pDataSecondary->frameType;
+            pDup->cfmData.bufId = pDataSecondary->buffId;
+            pDup->cfmData.result = (PAL_TX_RESULT)resultSecondary;
+            pDup->cfmValid = true;
+        }
+        else
+        {
+            /* Both requests in process */
+        }
+    }
+
+    if (pDup->pendingCfm == 0U)
+    {
+        /* Confirm of the accepted request already received */
+        pDup->active = false;
+
+        if((palData.dataConfirmCallback) != NULL)
+        {
+            palData.dataConfirmCallback(&pDup->cfmData);
+        }
+    }
+
+    return((uint8_t)PAL_TX_RESULT_PROCESS);
+<#else>
+    (void)pDataSecondary;
+
+    return PAL_DataRequest(pDataPrimary);
+</#if>
+}
+
+void PAL_NeighborIdCallbackRegister(PAL_NEIGHBOR_ID_CB callback)
+{
+<#if (PAL_MEDIUM_ADVISOR == true) || (PAL_PLC_TX_POWER_CONTROL == true)>
+    palData.neighborIdCallback = callback;
+<#else>
+    (void)callback;
+</#if>
+}
+
+uint8_t PAL_GetBestMedium(uint32_t neighborId, uint16_t *pPch, PAL_SCHEME *pScheme)
+{
+<#if PAL_MEDIUM_ADVISOR == true>
+    PAL_ADVISOR_NEIGHBOR *pNeighbor;
+    PAL_ADVISOR_MEDIUM_INFO *pMedium;
+    uint32_t timeNow;
+    uint32_t goodput;
+    uint32_t bestGoodput = 0;
+    uint8_t medium;
+    uint8_t result = (uint8_t)PAL_CFG_INVALID_INPUT;
+
+    pNeighbor = lPAL_AdvisorGetNeighbor(neighborId, false);
+    if (pNeighbor == NULL)
+    {
+        return((uint8_t)PAL_CFG_INVALID_INPUT);
+    }
+
+    timeNow = SRV_TIME_MANAGEMENT_GetTimeUS();
+
+    for (medium = 0; medium < PAL_ADVISOR_NUM_MEDIUMS; medium++)
+    {
+        pMedium = &pNeighbor->medium[medium];
+
+        if ((pMedium->valid == false) ||
+            ((timeNow - pMedium->lastUpdate) > PAL_ADVISOR_AGING_US))
+        {
+            continue;
+        }
+
+        /* Expected goodput: bitrate weighted by transmission success ratio */
+        goodput = (pMedium->bitrateAvg * pMedium->successRatio) >> 8;
+
+        if (goodput > bestGoodput)
+        {
+            bestGoodput = goodput;
+            *pPch = pMedium->pch;
+            *pScheme = pMedium->scheme;
+            result = (uint8_t)PAL_CFG_SUCCESS;
+        }
+    }
+
+    return result;
+<#else>
+    (void)neighborId;
+    (void)pPch;
+    (void)pScheme;
+
+    return((uint8_t)PAL_CFG_INVALID_INPUT);
+</#if>
+}
+
+void PAL_TxPowerAckReport(uint32_t neighborId, bool ackReceived)
+{
+<#if PAL_PLC_TX_POWER_CONTROL == true>
+    PAL_TXPC_NEIGHBOR *pNeighbor = lPAL_TxPowerGetNeighbor(neighborId, false);
+
+    if (pNeighbor == NULL)
+    {
+        return;
+    }
+
+    if (ackReceived == true)
+    {
+        pNeighbor->ackFails = 0;
+        if (pNeighbor->holdAcks > 0U)
+        {
+            pNeighbor->holdAcks--;
+        }
+
+        return;
+    }
+
+    /* Missing ACK: raise power and hold it for the next messages */
+    pNeighbor->holdAcks = PAL_TXPC_HOLD_ACKS;
+    if (pNeighbor->ackFails < 0xFFU)
+    {
+        pNeighbor->ackFails++;
+    }
+
+    if ((pNeighbor->ackFails >= PAL_TXPC_MAX_ACK_FAILS) ||
+        (pNeighbor->attOffset <= PAL_TXPC_ATT_STEP_UP))
+    {
+        pNeighbor->attOffset = 0;
+    }
+    else
+    {
+        pNeighbor->attOffset -= PAL_TXPC_ATT_STEP_UP;
+    }
+<#else>
+    (void)neighborId;
+    (void)ackReceived;
+</#if>
+}
+
+uint8_t PAL_GetTxPowerOffset(uint32_t neighborId, uint8_t *pAttOffset)
+{
+<#if PAL_PLC_TX_POWER_CONTROL == true>
+    PAL_TXPC_NEIGHBOR *pNeighbor = lPAL_TxPowerGetNeighbor(neighborId, false);
+
+    if ((pNeighbor == NULL) ||
+        ((SRV_TIME_MANAGEMENT_GetTimeUS() - pNeighbor->lastUpdate) > PAL_TXPC_AGING_US))
+    {
+        *pAttOffset = 0;
+        return((uint8_t)PAL_CFG_INVALID_INPUT);
+    }
+
+    *pAttOffset = pNeighbor->attOffset;
+    return((uint8_t)PAL_CFG_SUCCESS);
+<#else>
+    (void)neighborId;
+
+    *pAttOffset = 0;
+    return((uint8_t)PAL_CFG_INVALID_INPUT);
+</#if>
+}
+
 uint8_t PAL_GetSNR(uint16_t pch, uint8_t *snr, uint8_t qt)
 {
     PAL_INTERFACE *palIface = lPAL_GetInterface(pch);
@@ -723,6 +2994,9 @@ void PAL_ProgramChannelSwitch(uint32_t timeSync, uint16_t pch, uint8_t timeMode)
 
     if (palIface != NULL)
     {
+<#if PRIME_PAL_TX_SCHEDULER == true>
+        lPAL_TxSchedProgramSwitch(timeSync, pch, timeMode);
+</#if>
         palIface->MPAL_ProgramChannelSwitch(timeSync, pch, timeMode);
     }
 }
@@ -737,39 +3011,232 @@ uint8_t PAL_GetConfiguration(uint16_t pch, uint16_t id, void *val, uint16_t leng
         return((uint8_t)PAL_CFG_INVALID_INPUT);
     }
 
-    if(id == (uint16_t)PAL_ID_PHY_SNIFFER_EN)
+    return(lPAL_GetConfigurationIface(palIface, id, val, length));
+}
+
+uint8_t PAL_SetConfiguration(uint16_t pch, uint16_t id, void *val, uint16_t length)
+{
+    PAL_INTERFACE *palIface = lPAL_GetInterface(pch);
+
+    if (palIface == NULL)
     {
-<#if PRIME_PAL_PHY_SNIFFER == true>
-        *(uint8_t *)val = palData.snifferEnabled;
-<#else>
-        *(uint8_t *)val = 0U;
-</#if>
-        return (uint8_t)PAL_CFG_SUCCESS;
+        return((uint8_t)PAL_CFG_INVALID_INPUT);
     }
 
-    return(palIface->MPAL_GetConfiguration(id, val, length));
+    return(lPAL_SetConfigurationIface(palIface, id, val, length));
 }
 
-uint8_t PAL_SetConfiguration(uint16_t pch, uint16_t id, void *val, uint16_t length)
+uint8_t PAL_GetConfigurationBatch(uint16_t pch, PAL_CFG_ITEM *pItems, uint8_t numItems)
 {
     PAL_INTERFACE *palIface = lPAL_GetInterface(pch);
+    PAL_CFG_ITEM *pItem;
+    PAL_CFG_ITEM *pPrevItem;
+    uint8_t result = (uint8_t)PAL_CFG_SUCCESS;
+    uint8_t index;
+    uint8_t prevIndex;
 
     if (palIface == NULL)
     {
+        for (index = 0; index < numItems; index++)
+        {
+            pItems[index].result = (uint8_t)PAL_CFG_INVALID_INPUT;
+        }
+
         return((uint8_t)PAL_CFG_INVALID_INPUT);
     }
 
-    if (id == (uint16_t)PAL_ID_PHY_SNIFFER_EN)
+    for (index = 0; index < numItems; index++)
     {
-<#if PRIME_PAL_PHY_SNIFFER == true>
-        palData.snifferEnabled = *(uint8_t *)val;
+        pItem = &pItems[index];
+        pItem->result = (uint8_t)PAL_CFG_INVALID_INPUT;
+
+        /* Reuse value if the attribute has already been read in this batch */
+        for (prevIndex = 0; prevIndex < index; prevIndex++)
+        {
+            pPrevItem = &pItems[prevIndex];
+            if ((pPrevItem->id == pItem->id) && (pPrevItem->length == pItem->length) &&
+                (pPrevItem->result == (uint8_t)PAL_CFG_SUCCESS))
+            {
+                (void)memcpy(pItem->pValue, pPrevItem->pValue, pItem->length);
+                pItem->result = (uint8_t)PAL_CFG_SUCCESS;
+                break;
+            }
+        }
+
+        if (pItem->result != (uint8_t)PAL_CFG_SUCCESS)
+        {
+            pItem->result = lPAL_GetConfigurationIface(palIface, pItem->id, pItem->pValue, pItem->length);
+        }
+
+        if (pItem->result != (uint8_t)PAL_CFG_SUCCESS)
+        {
+            result = (uint8_t)PAL_CFG_INVALID_INPUT;
+        }
+    }
+
+    return result;
+}
+
+uint8_t PAL_SetConfigurationBatch(uint16_t pch, PAL_CFG_ITEM *pItems, uint8_t numItems)
+{
+    PAL_INTERFACE *palIface = lPAL_GetInterface(pch);
+    PAL_CFG_ITEM *pItem;
+    uint8_t result = (uint8_t)PAL_CFG_SUCCESS;
+    uint8_t index;
+
+    if (palIface == NULL)
+    {
+        for (index = 0; index < numItems; index++)
+        {
+            pItems[index].result = (uint8_t)PAL_CFG_INVALID_INPUT;
+        }
+
+        return((uint8_t)PAL_CFG_INVALID_INPUT);
+    }
+
+    for (index = 0; index < numItems; index++)
+    {
+        pItem = &pItems[index];
+        pItem->result = lPAL_SetConfigurationIface(palIface, pItem->id, pItem->pValue, pItem->length);
+
+        if (pItem->result != (uint8_t)PAL_CFG_SUCCESS)
+        {
+            result = (uint8_t)PAL_CFG_INVALID_INPUT;
+        }
+    }
+
+    return result;
+}
+
+uint8_t PAL_GetChannelQualityMap(PAL_CHANNEL_QUALITY *pMap, uint8_t maxChannels, uint8_t *pNumChannels)
+{
+<#if (PRIME_PAL_PLC_EN == true) && (PRIME_PAL_PLC_CHANNEL_MONITOR == true)>
+    return PAL_PLC_GetChannelQualityMap(pMap, maxChannels, pNumChannels);
 <#else>
-        palData.snifferEnabled = 0U;
+    (void)pMap;
+    (void)maxChannels;
+
+    *pNumChannels = 0U;
+    return((uint8_t)PAL_CFG_INVALID_INPUT);
 </#if>
-        return (uint8_t)PAL_CFG_SUCCESS;
+}
+
+uint8_t PAL_GetAirtimeCounters(PAL_AIRTIME_COUNTERS *pCounters, uint8_t maxChannels,
+    uint8_t *pNumChannels)
+{
+<#if PRIME_PAL_AIRTIME == true>
+    PAL_AIRTIME_CHANNEL *pChannel;
+    uint8_t numChannels = 0;
+    uint8_t index;
+
+    lPAL_AirtimeUpdateWindow();
+
+    for (index = 0; index < PAL_AIRTIME_NUM_CHANNELS; index++)
+    {
+        pChannel = &palData.airtimeChannels[index];
+
+        if (pChannel->valid == false)
+        {
+            continue;
+        }
+
+        if (numChannels >= maxChannels)
+        {
+            break;
+        }
+
+        pChannel->counters.utilization = (uint16_t)(((uint64_t)pChannel->counters.windowTime * 1000U) /
+                PAL_AIRTIME_WINDOW_US);
+        pCounters[numChannels] = pChannel->counters;
+        numChannels++;
     }
 
-    return(palIface->MPAL_SetConfiguration(id, val, length));
+    *pNumChannels = numChannels;
+
+    return((uint8_t)PAL_CFG_SUCCESS);
+<#else>
+    (void)pCounters;
+    (void)maxChannels;
+
+    *pNumChannels = 0U;
+    return((uint8_t)PAL_CFG_INVALID_INPUT);
+</#if>
+}
+
+uint8_t PAL_SetDutyCycleBudget(uint16_t pch, uint16_t budget)
+{
+<#if PRIME_PAL_AIRTIME == true>
+    PAL_AIRTIME_CHANNEL *pChannel;
+
+    if ((budget > 1000U) || (pch >= PRIME_PAL_SERIAL_CHN_MASK) || (lPAL_GetInterface(pch) == NULL))
+    {
+        return((uint8_t)PAL_CFG_INVALID_INPUT);
+    }
+
+    pChannel = lPAL_AirtimeGetChannel(pch, true);
+    if (pChannel == NULL)
+    {
+        return((uint8_t)PAL_CFG_INVALID_INPUT);
+    }
+
+    pChannel->counters.dutyCycleBudget = budget;
+
+    return((uint8_t)PAL_CFG_SUCCESS);
+<#else>
+    (void)pch;
+    (void)budget;
+
+    return((uint8_t)PAL_CFG_INVALID_INPUT);
+</#if>
+}
+
+uint8_t PAL_SetAdaptiveCsma(uint16_t pch, bool enable)
+{
+<#if (PRIME_PAL_PLC_EN == true) && (PRIME_PAL_PLC_ADAPTIVE_CSMA == true)>
+    if (pch >= PRIME_PAL_RF_CHN_MASK)
+    {
+        return((uint8_t)PAL_CFG_INVALID_INPUT);
+    }
+
+    return PAL_PLC_SetAdaptiveCsma(enable);
+<#else>
+    (void)pch;
+    (void)enable;
+
+    return((uint8_t)PAL_CFG_INVALID_INPUT);
+</#if>
+}
+
+uint8_t PAL_GetCsmaStatus(uint16_t pch, PAL_CSMA_STATUS *pStatus)
+{
+<#if (PRIME_PAL_PLC_EN == true) && (PRIME_PAL_PLC_ADAPTIVE_CSMA == true)>
+    if (pch >= PRIME_PAL_RF_CHN_MASK)
+    {
+        return((uint8_t)PAL_CFG_INVALID_INPUT);
+    }
+
+    return PAL_PLC_GetCsmaStatus(pStatus);
+<#else>
+    (void)pch;
+    (void)pStatus;
+
+    return((uint8_t)PAL_CFG_INVALID_INPUT);
+</#if>
+}
+
+uint8_t PAL_GetTxScheduleCounters(PAL_TX_SCHED_COUNTERS *pCounters)
+{
+<#if PRIME_PAL_TX_SCHEDULER == true>
+    lPAL_TxSchedPurge(SRV_TIME_MANAGEMENT_GetTimeUS());
+
+    *pCounters = palData.txSchedCounters;
+
+    return((uint8_t)PAL_CFG_SUCCESS);
+<#else>
+    (void)pCounters;
+
+    return((uint8_t)PAL_CFG_INVALID_INPUT);
+</#if>
 }
 
 uint16_t PAL_GetSignalCapture(uint16_t pch, uint8_t *noiseCapture, PAL_FRAME frameType,
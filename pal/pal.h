@@ -183,6 +183,54 @@ void PAL_Tasks(SYS_MODULE_OBJ object);
 
 SYS_STATUS PAL_Status(SYS_MODULE_OBJ object);
 
+// *************************************************************************
+/* Function:
+    uint32_t PAL_GetNextDeadline(SYS_MODULE_OBJ object)
+
+  Summary:
+    Gets the time until PAL needs to run its state machine.
+
+  Description:
+    This routine reports how long PAL_Tasks can be left without being called,
+    so the application can enter WFI or a low-power mode until then. It takes
+    into account the state of PLC, RF and serial PAL modules, the PLC timer
+    synchronization and the optional features which run from PAL_Tasks.
+
+  Precondition:
+    Function PAL_Initialize should have been called before calling
+    this function.
+
+  Parameters:
+    object - Identifier for the object instance
+
+  Returns:
+    Time in microseconds until the next deadline. 0 if PAL_Tasks must be
+    called as soon as possible. PAL_DEADLINE_NONE if PAL only needs to run
+    after an interrupt.
+
+  Example:
+    <code>
+    SYS_MODULE_OBJ sysObjPal;
+    sysObjPal = PAL_Initialize(PRIME_PAL_INDEX);
+
+    __disable_irq();
+    if (PAL_GetNextDeadline(sysObjPal) > 1000U)
+    {
+        __WFI();
+    }
+    __enable_irq();
+    </code>
+
+  Remarks:
+    Confirms and indications are driven by the interrupts of the PHY
+    drivers, which wake up the CPU from WFI. Interrupts must be masked
+    (PRIMASK) between the deadline check and WFI. Otherwise an interrupt
+    taken in between is serviced before WFI and the CPU sleeps with work
+    pending. A pending interrupt still wakes up the CPU with PRIMASK set.
+*/
+
+uint32_t PAL_GetNextDeadline(SYS_MODULE_OBJ object);
+
 // *****************************************************************************
 /* Function:
   void PAL_Enable(SYS_MODULE_OBJ object, uint8_t enablePAL)
@@ -765,7 +813,8 @@ uint8_t PAL_SetChannel(uint16_t pch);
     </code>
 
   Remarks:
-    Only available for PHY RF.
+    Available for PHY PLC and PHY RF. The execution of the switch is notified
+    through the switchRfChannel callback.
 */
 void PAL_ProgramChannelSwitch(uint32_t timeSync, uint16_t pch, 
     uint8_t timeMode);
@@ -860,6 +909,333 @@ uint8_t PAL_GetConfiguration(uint16_t pch, uint16_t id, void *val,
 uint8_t PAL_SetConfiguration(uint16_t pch, uint16_t id, void *val,
     uint16_t length);
 
+// ****************************************************************************
+/* Function:
+    uint8_t PAL_GetConfigurationBatch(
+        uint16_t pch,
+        PAL_CFG_ITEM *pItems,
+        uint8_t numItems)
+
+  Summary:
+    Get several PHY attributes in one call.
+
+  Description:
+    This function is used to get a list of PHY attributes from the selected
+    medium. The medium interface is resolved once for the whole list, and the
+    result of every attribute is stored in its item. Attributes requested more
+    than once with the same length are only read once from the PHY layer.
+
+  Precondition:
+    The PAL_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    pch             Physical channel
+    pItems          Pointer to the list of attributes
+    numItems        Number of attributes in the list
+
+  Returns:
+    PAL_CFG_SUCCESS         - If all attributes are successfully read
+    PAL_CFG_INVALID_INPUT   - If any attribute cannot be read
+
+  Example:
+    <code>
+    uint8_t attenuation;
+    uint16_t channel;
+    PAL_CFG_ITEM items[2] = {
+        {&attenuation, PAL_ID_CFG_ATTENUATION, 1, 0},
+        {&channel, PAL_ID_CFG_TXRX_CHANNEL, 2, 0}
+    };
+
+    result = PAL_GetConfigurationBatch(1, items, 2);
+    </code>
+
+  Remarks:
+    The PHY drivers access one attribute at a time, so each distinct attribute
+    is still a separate access to the PHY layer.
+*/
+uint8_t PAL_GetConfigurationBatch(uint16_t pch, PAL_CFG_ITEM *pItems,
+    uint8_t numItems);
+
+// ****************************************************************************
+/* Function:
+    uint8_t PAL_SetConfigurationBatch(
+        uint16_t pch,
+        PAL_CFG_ITEM *pItems,
+        uint8_t numItems)
+
+  Summary:
+    Set several PHY attributes in one call.
+
+  Description:
+    This function is used to set a list of PHY attributes in the selected
+    medium, in the order of the list. The medium interface is resolved once
+    for the whole list, and the result of every attribute is stored in its
+    item.
+
+  Precondition:
+    The PAL_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    pch             Physical channel
+    pItems          Pointer to the list of attributes
+    numItems        Number of attributes in the list
+
+  Returns:
+    PAL_CFG_SUCCESS         - If all attributes are successfully written
+    PAL_CFG_INVALID_INPUT   - If any attribute cannot be written
+
+  Example:
+    <code>
+    uint8_t attenuation = 2;
+    PAL_CFG_ITEM items[1] = {
+        {&attenuation, PAL_ID_CFG_ATTENUATION, 1, 0}
+    };
+
+    result = PAL_SetConfigurationBatch(1, items, 1);
+    </code>
+
+  Remarks:
+    Not available for PHY Serial. Each attribute is a separate access to the
+    PHY layer.
+*/
+uint8_t PAL_SetConfigurationBatch(uint16_t pch, PAL_CFG_ITEM *pItems,
+    uint8_t numItems);
+
+// ****************************************************************************
+/* Function:
+    uint8_t PAL_GetChannelQualityMap(
+        PAL_CHANNEL_QUALITY *pMap,
+        uint8_t maxChannels,
+        uint8_t *pNumChannels)
+
+  Summary:
+    Get the quality statistics of the PLC channels.
+
+  Description:
+    This routine returns the noise level and occupancy statistics collected by
+    the PLC channel monitor for every PLC channel which has been monitored.
+
+  Precondition:
+    The PAL_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    pMap            Pointer to store the statistics of every channel
+    maxChannels     Maximum number of channels to store in pMap
+    pNumChannels    Pointer to store the number of channels stored in pMap
+
+  Returns:
+    PAL_CFG_SUCCESS         - If successful
+    PAL_CFG_INVALID_INPUT   - If the PLC channel monitor is not available
+
+  Example:
+    <code>
+    PAL_CHANNEL_QUALITY map[8];
+    uint8_t numChannels;
+
+    result = PAL_GetChannelQualityMap(map, 8, &numChannels);
+    </code>
+
+  Remarks:
+    Only available if the PLC channel monitor is enabled. Only the channel in
+    use is monitored, so statistics of other channels are kept from the last
+    time they were used. The noise level is the noise floor under each
+    received frame (RSSI minus CINR), read once per frame while the channel
+    is idle. It is 0 until a frame has been received in the channel.
+*/
+uint8_t PAL_GetChannelQualityMap(PAL_CHANNEL_QUALITY *pMap, uint8_t maxChannels,
+    uint8_t *pNumChannels);
+
+// ****************************************************************************
+/* Function:
+    uint8_t PAL_GetAirtimeCounters(
+        PAL_AIRTIME_COUNTERS *pCounters,
+        uint8_t maxChannels,
+        uint8_t *pNumChannels)
+
+  Summary:
+    Get the airtime counters of the physical channels.
+
+  Description:
+    This routine returns the on-air time accumulated per physical channel,
+    frame type and modulation scheme, the channel utilization in the sliding
+    window and the duty-cycle budget of every channel used to transmit.
+
+  Precondition:
+    The PAL_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    pCounters       Pointer to store the counters of every channel
+    maxChannels     Maximum number of channels to store in pCounters
+    pNumChannels    Pointer to store the number of channels stored in pCounters
+
+  Returns:
+    PAL_CFG_SUCCESS         - If successful
+    PAL_CFG_INVALID_INPUT   - If airtime accounting is not available
+
+  Example:
+    <code>
+    PAL_AIRTIME_COUNTERS counters[4];
+    uint8_t numChannels;
+
+    result = PAL_GetAirtimeCounters(counters, 4, &numChannels);
+    </code>
+
+  Remarks:
+    Only available if airtime accounting is enabled.
+*/
+uint8_t PAL_GetAirtimeCounters(PAL_AIRTIME_COUNTERS *pCounters, uint8_t maxChannels,
+    uint8_t *pNumChannels);
+
+// ****************************************************************************
+/* Function:
+    uint8_t PAL_SetDutyCycleBudget(uint16_t pch, uint16_t budget)
+
+  Summary:
+    Set the duty-cycle budget of a physical channel.
+
+  Description:
+    This routine sets the maximum on-air time of a physical channel within the
+    sliding window, in per mille. Transmission requests exceeding the budget
+    are deferred until enough on-air time is available in the window.
+
+  Precondition:
+    The PAL_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    pch     Physical channel
+    budget  Duty-cycle budget in per mille (1 to 1000). 0 disables the budget.
+
+  Returns:
+    PAL_CFG_SUCCESS         - If successful
+    PAL_CFG_INVALID_INPUT   - If the budget cannot be set
+
+  Example:
+    <code>
+    uint16_t pch = 512;
+
+    result = PAL_SetDutyCycleBudget(pch, 100);
+    </code>
+
+  Remarks:
+    Only available if airtime accounting is enabled. Deferred requests with
+    absolute time mode are transmitted as soon as the budget allows it.
+*/
+uint8_t PAL_SetDutyCycleBudget(uint16_t pch, uint16_t budget);
+
+// ****************************************************************************
+/* Function:
+    uint8_t PAL_SetAdaptiveCsma(uint16_t pch, bool enable)
+
+  Summary:
+    Enable or disable the adaptive CSMA mode.
+
+  Description:
+    This routine enables or disables the adaptive CSMA mode of a physical
+    channel. In adaptive mode, the number of channel senses and the delay
+    between them requested by the upper layer are scaled to the contention
+    measured from the results of previous transmissions.
+
+  Precondition:
+    The PAL_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    pch         Physical channel
+    enable      true to enable the adaptive mode
+
+  Returns:
+    PAL_CFG_SUCCESS         - If successful
+    PAL_CFG_INVALID_INPUT   - If adaptive CSMA is not available
+
+  Example:
+    <code>
+    result = PAL_SetAdaptiveCsma(1, true);
+    </code>
+
+  Remarks:
+    Only available for PLC if the adaptive CSMA is enabled. Contention
+    statistics are collected even if the adaptive mode is disabled.
+*/
+uint8_t PAL_SetAdaptiveCsma(uint16_t pch, bool enable);
+
+// ****************************************************************************
+/* Function:
+    uint8_t PAL_GetCsmaStatus(uint16_t pch, PAL_CSMA_STATUS *pStatus)
+
+  Summary:
+    Get the contention statistics and the state of the adaptive CSMA.
+
+  Description:
+    This routine returns the busy channel and collision counters, the rates
+    measured in the sliding window and the backoff level of the adaptive CSMA
+    of a physical channel.
+
+  Precondition:
+    The PAL_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    pch         Physical channel
+    pStatus     Pointer to store the CSMA status
+
+  Returns:
+    PAL_CFG_SUCCESS         - If successful
+    PAL_CFG_INVALID_INPUT   - If adaptive CSMA is not available
+
+  Example:
+    <code>
+    PAL_CSMA_STATUS status;
+
+    result = PAL_GetCsmaStatus(1, &status);
+    </code>
+
+  Remarks:
+    Only available for PLC if the adaptive CSMA is enabled.
+*/
+uint8_t PAL_GetCsmaStatus(uint16_t pch, PAL_CSMA_STATUS *pStatus);
+
+// ****************************************************************************
+/* Function:
+    uint8_t PAL_GetTxScheduleCounters(PAL_TX_SCHED_COUNTERS *pCounters)
+
+  Summary:
+    Get the counters of the TX reservation scheduler.
+
+  Description:
+    This routine returns the counters of the TX reservation scheduler, which
+    keeps the absolute time transmissions ordered by start time and detects
+    overlaps between them and with programmed channel switches.
+
+  Precondition:
+    The PAL_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    pCounters       Pointer to store the counters
+
+  Returns:
+    PAL_CFG_SUCCESS         - If successful
+    PAL_CFG_INVALID_INPUT   - If the TX scheduler is not available
+
+  Example:
+    <code>
+    PAL_TX_SCHED_COUNTERS counters;
+
+    result = PAL_GetTxScheduleCounters(&counters);
+    </code>
+
+  Remarks:
+    Only available if the TX reservation scheduler is enabled. Conflicting
+    requests are rejected with PAL_TX_RESULT_BUSY_TX, unless the scheduler is
+    configured to delay them.
+*/
+uint8_t PAL_GetTxScheduleCounters(PAL_TX_SCHED_COUNTERS *pCounters);
+
 // ****************************************************************************
 /* Function:
     uint16_t PAL_GetSignalCapture(
@@ -1035,6 +1411,219 @@ bool PAL_CheckMinimumQuality(uint16_t pch, uint8_t reference, uint8_t modulation
 */
 uint8_t PAL_GetLessRobustModulation(uint16_t pch, uint8_t mod1, uint8_t mod2);
 
+// ****************************************************************************
+/* Function:
+    uint8_t PAL_DataRequestDuplicate(
+        PAL_MSG_REQUEST_DATA *pDataPrimary,
+        PAL_MSG_REQUEST_DATA *pDataSecondary)
+
+  Summary:
+    Request to transmit the same message through PLC and RF.
+
+  Description:
+    This function is used to transmit the same MPDU through a PLC physical
+    channel and through a RF physical channel. Both confirms are merged and
+    only one confirm is notified through the data confirm callback, reporting
+    the best result. If both transmissions have the same result, the primary
+    confirm is reported.
+
+  Precondition:
+    The PAL_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    pDataPrimary       MPDU data transmission structure for the primary medium
+    pDataSecondary     MPDU data transmission structure for the secondary
+                       medium
+
+  Returns:
+    PAL_TX_RESULT_PROCESS if at least one of the transmissions is in progress.
+    Otherwise, the transmission result of the primary request.
+
+  Example:
+    <code>
+    uint8_t result;
+    PAL_MSG_REQUEST_DATA plcMsg;
+    PAL_MSG_REQUEST_DATA rfMsg;
+    uint8_t msg[30];
+
+    plcMsg.pData = msg;
+    plcMsg.dataLength = sizeof(msg);
+    plcMsg.pch = 1;
+    plcMsg.scheme = PAL_SCHEME_DBPSK_C;
+    plcMsg.frameType = PAL_FRAME_TYPE_A;
+
+    rfMsg = plcMsg;
+    rfMsg.pch = PRIME_PAL_RF_CHN_MASK;
+    rfMsg.scheme = PAL_SCHEME_RF_FSK_FEC_OFF;
+    rfMsg.frameType = PAL_FRAME_TYPE_RF;
+
+    result = PAL_DataRequestDuplicate(&plcMsg, &rfMsg);
+    </code>
+
+  Remarks:
+    Only available if PLC and RF interfaces and duplicate transmission are
+    enabled. Otherwise, only the primary request is transmitted.
+    Only one duplicate transmission can be in progress at a time.
+    Duplicated indications received through the other medium are discarded.
+*/
+uint8_t PAL_DataRequestDuplicate(PAL_MSG_REQUEST_DATA *pDataPrimary,
+    PAL_MSG_REQUEST_DATA *pDataSecondary);
+
+// ****************************************************************************
+/* Function:
+    void PAL_NeighborIdCallbackRegister(PAL_NEIGHBOR_ID_CB callback)
+
+  Summary:
+    Registers the callback used to identify the neighbor of a message.
+
+  Description:
+    This routine registers the function used by the medium advisor and the PLC
+    TX power control to get the neighbor identifier of every transmitted and
+    received message. Link estimates are only kept for messages with a valid
+    identifier.
+
+  Precondition:
+    The PAL_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    callback        Pointer to the function. NULL to disable the advisor.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    static uint32_t APP_GetNeighborId(uint8_t *pData, uint16_t length, bool isTx)
+    {
+        return PAL_NEIGHBOR_ID_INVALID;
+    }
+
+    PAL_NeighborIdCallbackRegister(APP_GetNeighborId);
+    </code>
+
+  Remarks:
+    Only available if PLC and RF interfaces and the medium advisor are enabled,
+    or if the PLC TX power control is enabled.
+*/
+void PAL_NeighborIdCallbackRegister(PAL_NEIGHBOR_ID_CB callback);
+
+// ****************************************************************************
+/* Function:
+    uint8_t PAL_GetBestMedium(
+        uint32_t neighborId,
+        uint16_t *pPch,
+        PAL_SCHEME *pScheme)
+
+  Summary:
+    Get the expected fastest physical channel and modulation for a neighbor.
+
+  Description:
+    This routine returns the physical channel and modulation scheme which are
+    expected to give the highest goodput to reach the given neighbor. The
+    goodput of every medium is estimated from the bitrate of the messages
+    received from the neighbor and from the result of the transmissions to it.
+
+  Precondition:
+    The PAL_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    neighborId      Neighbor identifier
+    pPch            Pointer to store the physical channel
+    pScheme         Pointer to store the modulation scheme
+
+  Returns:
+    PAL_CFG_SUCCESS         - If there is updated information for the neighbor
+    PAL_CFG_INVALID_INPUT   - Otherwise
+
+  Example:
+    <code>
+    uint16_t pch;
+    PAL_SCHEME scheme;
+
+    if (PAL_GetBestMedium(neighborId, &pch, &scheme) == PAL_CFG_SUCCESS)
+    {
+
+    }
+    </code>
+
+  Remarks:
+    Only available if PLC and RF interfaces and the medium advisor are enabled.
+*/
+uint8_t PAL_GetBestMedium(uint32_t neighborId, uint16_t *pPch, PAL_SCHEME *pScheme);
+
+// ****************************************************************************
+/* Function:
+    void PAL_TxPowerAckReport(uint32_t neighborId, bool ackReceived)
+
+  Summary:
+    Reports the ACK outcome of a message transmitted to a neighbor.
+
+  Description:
+    This routine is used by the upper layer to report whether a message
+    transmitted through PLC to the given neighbor has been acknowledged. A
+    missing ACK raises the transmission power to the neighbor, and power is
+    only reduced again after several acknowledged messages.
+
+  Precondition:
+    The PAL_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    neighborId      Neighbor identifier
+    ackReceived     true if the message has been acknowledged
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    PAL_TxPowerAckReport(neighborId, false);
+    </code>
+
+  Remarks:
+    Only available if the PLC TX power control is enabled.
+*/
+void PAL_TxPowerAckReport(uint32_t neighborId, bool ackReceived);
+
+// ****************************************************************************
+/* Function:
+    uint8_t PAL_GetTxPowerOffset(uint32_t neighborId, uint8_t *pAttOffset)
+
+  Summary:
+    Get the attenuation added to the PLC messages transmitted to a neighbor.
+
+  Description:
+    This routine returns the attenuation in dB added by the PLC TX power
+    control to the attenuation level requested by the upper layer for the
+    messages transmitted to the given neighbor.
+
+  Precondition:
+    The PAL_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    neighborId      Neighbor identifier
+    pAttOffset      Pointer to store the attenuation in dB
+
+  Returns:
+    PAL_CFG_SUCCESS         - If there is updated information for the neighbor
+    PAL_CFG_INVALID_INPUT   - Otherwise
+
+  Example:
+    <code>
+    uint8_t attOffset;
+
+    result = PAL_GetTxPowerOffset(neighborId, &attOffset);
+    </code>
+
+  Remarks:
+    Only available if the PLC TX power control is enabled.
+*/
+uint8_t PAL_GetTxPowerOffset(uint32_t neighborId, uint8_t *pAttOffset);
+
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
 
@@ -50,7 +50,7 @@ Microchip or any third party.
 #include <stdint.h>
 #include "pal.h"
 #include "pal_types.h"
-<#if PRIME_PAL_PHY_SNIFFER == true>
+<#if (PRIME_PAL_PHY_SNIFFER == true) || (PRIME_PAL_PER_TEST == true)>
 #include "service/usi/srv_usi.h"
 </#if>
 
@@ -101,6 +101,519 @@ typedef struct PAL_INTERFACE_TYPE
 
 } PAL_INTERFACE;        // PRIME PAL interface descriptor
 
+<#if (PRIME_PAL_PLC_EN == true) && (PRIME_PAL_RF_EN == true) && (PRIME_PAL_HYBRID_DUPLICATE == true)>
+/* Number of received messages stored to detect duplicated indications */
+#define PAL_DUP_IND_TABLE_SIZE        8U
+
+/* Maximum time in us between the reception of both copies of a message */
+#define PAL_DUP_IND_WINDOW_US         500000UL
+
+// *****************************************************************************
+/* PAL Duplicate Indication Entry
+
+  Summary:
+    Information of a received message used to detect duplicated indications.
+
+  Description:
+    This data type contains the signature of a message received through PLC or
+    RF. A message with the same signature received through the other medium
+    within PAL_DUP_IND_WINDOW_US is considered a duplicate and is discarded.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    uint32_t signature;
+
+    uint32_t rxTime;
+
+    uint16_t dataLength;
+
+    uint16_t pch;
+
+    bool valid;
+} PAL_DUP_IND_ENTRY;
+
+// *****************************************************************************
+/* PAL Duplicate Transmission Data
+
+  Summary:
+    Holds the state of a duplicate transmission through PLC and RF.
+
+  Description:
+    This data type contains the information needed to merge the confirms of a
+    message transmitted through PLC and RF in a single confirm.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    PAL_MSG_CONFIRM_DATA cfmData;
+
+    uint16_t pchPrimary;
+
+    uint16_t pchSecondary;
+
+    uint8_t bufIdPrimary;
+
+    uint8_t bufIdSecondary;
+
+    uint8_t pendingCfm;
+
+    bool active;
+
+    bool cfmValid;
+} PAL_DUP_TX_DATA;
+
+</#if>
+<#if (PRIME_PAL_PLC_EN == true) && (PRIME_PAL_RF_EN == true) && (PRIME_PAL_MEDIUM_ADVISOR == true)>
+/* Number of neighbors handled by the medium advisor */
+#define PAL_ADVISOR_NUM_NEIGHBORS     16U
+
+/* Time in us after which the information of a medium is outdated */
+#define PAL_ADVISOR_AGING_US          600000000UL
+
+/* Mediums handled by the medium advisor */
+#define PAL_ADVISOR_MEDIUM_PLC        0U
+#define PAL_ADVISOR_MEDIUM_RF         1U
+#define PAL_ADVISOR_NUM_MEDIUMS       2U
+
+// *****************************************************************************
+/* PAL Medium Advisor Medium Information
+
+  Summary:
+    Quality and airtime estimates of a medium to reach a neighbor.
+
+  Description:
+    This data type contains the averaged estimates of a medium for a neighbor.
+    Averages are exponentially weighted, with 1/8 weight for new samples.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    /* Time of last update in us */
+    uint32_t lastUpdate;
+
+    /* Average estimated bitrate in kbps [uQ12.4] */
+    uint32_t bitrateAvg;
+
+    /* Average transmission success ratio [uQ0.8] (256 = 100%) */
+    uint16_t successRatio;
+
+    /* Average LQI [uQ8.4] */
+    uint16_t lqiAvg;
+
+    /* Physical channel of last received message */
+    uint16_t pch;
+
+    /* Less robust modulation scheme of last received message */
+    PAL_SCHEME scheme;
+
+    bool valid;
+} PAL_ADVISOR_MEDIUM_INFO;
+
+// *****************************************************************************
+/* PAL Medium Advisor Neighbor Information
+
+  Summary:
+    Holds the estimates of all mediums for a neighbor.
+
+  Description:
+    This data type contains the neighbor identifier and the estimates of every
+    medium to reach it.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    PAL_ADVISOR_MEDIUM_INFO medium[PAL_ADVISOR_NUM_MEDIUMS];
+
+    uint32_t neighborId;
+
+    bool valid;
+} PAL_ADVISOR_NEIGHBOR;
+
+</#if>
+<#if (PRIME_PAL_PLC_EN == true) && (PRIME_PAL_PLC_TX_POWER_CONTROL == true)>
+/* Number of neighbors handled by the PLC TX power control */
+#define PAL_TXPC_NUM_NEIGHBORS        16U
+
+/* Target LQI at the destination */
+#define PAL_TXPC_TARGET_LQI           ${PRIME_PAL_PLC_TX_POWER_TARGET_LQI?string}U
+
+/* Maximum attenuation in dB added by the TX power control */
+#define PAL_TXPC_MAX_ATT_OFFSET       12U
+
+/* Attenuation in dB removed after a missing ACK */
+#define PAL_TXPC_ATT_STEP_UP          3U
+
+/* Consecutive missing ACKs to go back to full power */
+#define PAL_TXPC_MAX_ACK_FAILS        2U
+
+/* Consecutive ACKs needed to reduce power after a missing ACK */
+#define PAL_TXPC_HOLD_ACKS            4U
+
+/* Time in us after which the link information is outdated */
+#define PAL_TXPC_AGING_US             600000000UL
+
+// *****************************************************************************
+/* PAL TX Power Control Neighbor Information
+
+  Summary:
+    Link information used to set the PLC transmission power to a neighbor.
+
+  Description:
+    This data type contains the LQI of the messages received from a neighbor,
+    averaged with 1/8 weight for new samples, the attenuation added to the
+    messages transmitted to it and the ACK history.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    uint32_t neighborId;
+
+    /* Time of last received message in us */
+    uint32_t lastUpdate;
+
+    /* Average LQI [uQ8.4] */
+    uint16_t lqiAvg;
+
+    /* Attenuation in dB added to transmitted messages */
+    uint8_t attOffset;
+
+    /* Consecutive missing ACKs */
+    uint8_t ackFails;
+
+    /* ACKs to receive before reducing power again */
+    uint8_t holdAcks;
+
+    bool valid;
+} PAL_TXPC_NEIGHBOR;
+
+</#if>
+<#if PRIME_PAL_AIRTIME == true>
+/* Number of physical channels with airtime counters */
+#define PAL_AIRTIME_NUM_CHANNELS      8U
+
+/* Number of slots of the sliding window */
+#define PAL_AIRTIME_NUM_SLOTS         10U
+
+/* Length of the sliding window in us */
+#define PAL_AIRTIME_WINDOW_US         (${PRIME_PAL_AIRTIME_WINDOW?string}UL * 1000000UL)
+
+/* Length of a slot of the sliding window in us */
+#define PAL_AIRTIME_SLOT_US           (PAL_AIRTIME_WINDOW_US / PAL_AIRTIME_NUM_SLOTS)
+
+/* Number of transmissions waiting for confirm */
+#define PAL_AIRTIME_NUM_TX            4U
+
+/* Number of requests which can be deferred by the duty-cycle budget */
+#define PAL_AIRTIME_NUM_DEFERRED      4U
+
+// *****************************************************************************
+/* PAL Airtime Channel
+
+  Summary:
+    Airtime counters and sliding window of a physical channel.
+
+  Description:
+    This data type contains the airtime counters of a physical channel and the
+    on-air time of every slot of the sliding window.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    PAL_AIRTIME_COUNTERS counters;
+
+    uint32_t slotTime[PAL_AIRTIME_NUM_SLOTS];
+
+    bool valid;
+} PAL_AIRTIME_CHANNEL;
+
+// *****************************************************************************
+/* PAL Airtime Transmission
+
+  Summary:
+    Information of a transmission waiting for confirm.
+
+  Description:
+    This data type contains the parameters of a transmission needed to account
+    its on-air time when the confirm is received.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    uint32_t duration;
+
+    uint16_t pch;
+
+    uint8_t bufId;
+
+    PAL_SCHEME scheme;
+
+    PAL_FRAME frameType;
+
+    bool valid;
+} PAL_AIRTIME_TX;
+
+// *****************************************************************************
+/* PAL Airtime Deferred Request
+
+  Summary:
+    Transmission request deferred by the duty-cycle budget.
+
+  Description:
+    This data type contains a copy of a transmission request which is waiting
+    for enough on-air time in the sliding window of its channel.
+
+  Remarks:
+    The data buffer is not copied. It is kept by the upper layer until the
+    confirm is received.
+*/
+typedef struct
+{
+    PAL_MSG_REQUEST_DATA request;
+
+    uint32_t duration;
+
+    bool valid;
+} PAL_AIRTIME_DEFERRED;
+
+</#if>
+<#if PRIME_PAL_TX_SCHEDULER == true>
+/* Number of reservations of the TX scheduler */
+#define PAL_TX_SCHED_SIZE             8U
+
+/* Guard time in us between reservations of the same medium */
+#define PAL_TX_SCHED_GUARD_US         100UL
+
+/* Maximum delay in us of a conflicting transmission */
+#define PAL_TX_SCHED_MAX_DELAY_US     20000UL
+
+/* Mediums handled by the TX scheduler */
+#define PAL_TX_SCHED_MEDIUM_PLC       0U
+#define PAL_TX_SCHED_MEDIUM_RF        1U
+#define PAL_TX_SCHED_NUM_MEDIUMS      2U
+
+// *****************************************************************************
+/* PAL TX Scheduler Reservation
+
+  Summary:
+    Reservation of the medium for an absolute time transmission.
+
+  Description:
+    This data type contains the time interval in which a medium is used by a
+    transmission requested in absolute time mode.
+
+  Remarks:
+    Times are given in us, in the time base of PAL absolute requests.
+*/
+typedef struct
+{
+    uint32_t startTime;
+
+    uint32_t endTime;
+
+    uint8_t *pData;
+
+    uint8_t bufId;
+
+    uint8_t medium;
+} PAL_TX_SCHED_ENTRY;
+
+// *****************************************************************************
+/* PAL TX Scheduler Channel Switch
+
+  Summary:
+    Channel switch programmed in a medium.
+
+  Description:
+    This data type contains the time of a channel switch programmed with
+    PAL_ProgramChannelSwitch, which must not happen during a transmission.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    uint32_t time;
+
+    bool valid;
+} PAL_TX_SCHED_SWITCH;
+
+</#if>
+<#if PRIME_PAL_PER_TEST == true>
+#define PRIME_PAL_PER_TEST_USI_INSTANCE   SRV_USI_INDEX_${PRIME_PAL_PER_TEST_USI_INSTANCE?string}
+
+/* Maximum length of a test frame */
+#define PAL_PER_MAX_DATA_SIZE         256U
+
+/* Test frame header: magic (4), test id, scheme, attenuation, index (2),
+   number of frames (2). Test frames end with a CRC-16 */
+#define PAL_PER_HEADER_SIZE           11U
+#define PAL_PER_CRC_SIZE              2U
+#define PAL_PER_MIN_DATA_SIZE         (PAL_PER_HEADER_SIZE + PAL_PER_CRC_SIZE)
+
+/* Maximum number of schemes and attenuation levels of a TX sweep */
+#define PAL_PER_MAX_SCHEMES           11U
+#define PAL_PER_MAX_ATT_LEVELS        8U
+
+/* Number of scheme and attenuation combinations counted by the receiver */
+#define PAL_PER_NUM_GROUPS            16U
+
+/* Number of bins of the CINR and EVM distributions */
+#define PAL_PER_NUM_BINS              16U
+
+/* TX buffer of test frames: MAC data requests are rejected during the test
+   and test frames wait for the confirms of MAC frames still in flight */
+#define PAL_PER_BUFFER_ID             0U
+
+/* Time to wait for the confirm of a test frame */
+#define PAL_PER_CFM_TIMEOUT_US        1000000U
+
+/* USI commands of the PER test engine */
+#define PAL_PER_CMD_START_TX          0x01U
+#define PAL_PER_CMD_START_RX          0x02U
+#define PAL_PER_CMD_STOP              0x03U
+#define PAL_PER_CMD_GET_RESULTS       0x04U
+#define PAL_PER_CMD_TX_RESULT         0x81U
+#define PAL_PER_CMD_RX_RESULT         0x82U
+#define PAL_PER_CMD_RX_RESULT_END     0x83U
+
+// *****************************************************************************
+/* PAL PER Test State
+
+  Summary:
+    States of the PER test engine.
+
+  Description:
+    This data type defines the states of the PER test engine.
+
+  Remarks:
+    None.
+*/
+typedef enum
+{
+    PAL_PER_STATE_IDLE,
+    PAL_PER_STATE_TX,
+    PAL_PER_STATE_TX_WAIT_CFM,
+    PAL_PER_STATE_RX,
+} PAL_PER_STATE;
+
+// *****************************************************************************
+/* PAL PER Test Reception Group
+
+  Summary:
+    Reception results of a scheme and attenuation combination.
+
+  Description:
+    This data type contains the frame and bit error counters and the CINR and
+    EVM distributions of the test frames received with a given scheme and
+    transmitted with a given attenuation level.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    uint32_t bitErrors;
+
+    uint32_t bitsReceived;
+
+    uint16_t numFrames;
+
+    uint16_t received;
+
+    uint16_t crcErrors;
+
+    uint16_t cinrHist[PAL_PER_NUM_BINS];
+
+    uint16_t evmHist[PAL_PER_NUM_BINS];
+
+    PAL_SCHEME scheme;
+
+    uint8_t attLevel;
+
+    bool valid;
+} PAL_PER_RX_GROUP;
+
+// *****************************************************************************
+/* PAL PER Test Data
+
+  Summary:
+    Holds the state of the PER test engine.
+
+  Description:
+    This data type contains the configuration and progress of a TX sweep and
+    the results of the reception.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    PAL_PER_RX_GROUP rxGroups[PAL_PER_NUM_GROUPS];
+
+    uint8_t txData[PAL_PER_MAX_DATA_SIZE];
+
+    SRV_USI_HANDLE usiHandler;
+
+    PAL_PER_RX_GROUP *pLastRxGroup;
+
+    uint32_t nextTxTime;
+
+    uint32_t periodUs;
+
+    uint32_t cfmWaitTime;
+
+    uint16_t pch;
+
+    uint16_t dataLength;
+
+    uint16_t numFrames;
+
+    uint16_t frameIndex;
+
+    uint16_t numSent;
+
+    uint16_t numSuccess;
+
+    uint16_t crcErrors;
+
+    /* MAC frames accepted and not confirmed yet */
+    uint16_t macTxPending;
+
+    PAL_SCHEME schemes[PAL_PER_MAX_SCHEMES];
+
+    uint8_t attLevels[PAL_PER_MAX_ATT_LEVELS];
+
+    uint8_t numSchemes;
+
+    uint8_t numAttLevels;
+
+    uint8_t schemeIndex;
+
+    uint8_t attIndex;
+
+    uint8_t testId;
+
+    PAL_FRAME frameType;
+
+    PAL_PER_STATE state;
+} PAL_PER_TEST_DATA;
+
+</#if>
 // *****************************************************************************
 /* PAL Data
 
@@ -124,6 +637,56 @@ typedef struct
 <#if PRIME_PAL_PHY_SNIFFER == true>
     SRV_USI_HANDLE usiHandler;
 
+</#if>
+<#if (PRIME_PAL_PLC_EN == true) && (PRIME_PAL_RF_EN == true) && (PRIME_PAL_HYBRID_DUPLICATE == true)>
+    PAL_DUP_TX_DATA dupTxData;
+
+    PAL_DUP_IND_ENTRY dupIndTable[PAL_DUP_IND_TABLE_SIZE];
+
+    uint8_t dupIndNext;
+
+</#if>
+<#if (PRIME_PAL_PLC_EN == true) && (((PRIME_PAL_RF_EN == true) && (PRIME_PAL_MEDIUM_ADVISOR == true)) || (PRIME_PAL_PLC_TX_POWER_CONTROL == true))>
+    PAL_NEIGHBOR_ID_CB neighborIdCallback;
+
+</#if>
+<#if (PRIME_PAL_PLC_EN == true) && (PRIME_PAL_RF_EN == true) && (PRIME_PAL_MEDIUM_ADVISOR == true)>
+    PAL_ADVISOR_NEIGHBOR advisorTable[PAL_ADVISOR_NUM_NEIGHBORS];
+
+    uint32_t advisorTxNeighborId[PAL_ADVISOR_NUM_MEDIUMS];
+
+    uint8_t advisorTxBufId[PAL_ADVISOR_NUM_MEDIUMS];
+
+</#if>
+<#if (PRIME_PAL_PLC_EN == true) && (PRIME_PAL_PLC_TX_POWER_CONTROL == true)>
+    PAL_TXPC_NEIGHBOR txpcTable[PAL_TXPC_NUM_NEIGHBORS];
+
+</#if>
+<#if PRIME_PAL_AIRTIME == true>
+    PAL_AIRTIME_CHANNEL airtimeChannels[PAL_AIRTIME_NUM_CHANNELS];
+
+    PAL_AIRTIME_TX airtimeTx[PAL_AIRTIME_NUM_TX];
+
+    PAL_AIRTIME_DEFERRED airtimeDeferred[PAL_AIRTIME_NUM_DEFERRED];
+
+    uint64_t airtimeSlotStart;
+
+    uint8_t airtimeSlotIndex;
+
+    uint8_t airtimeTxNext;
+
+</#if>
+<#if PRIME_PAL_TX_SCHEDULER == true>
+    PAL_TX_SCHED_ENTRY txSchedTable[PAL_TX_SCHED_SIZE];
+
+    PAL_TX_SCHED_SWITCH txSchedSwitch[PAL_TX_SCHED_NUM_MEDIUMS];
+
+    PAL_TX_SCHED_COUNTERS txSchedCounters;
+
+</#if>
+<#if PRIME_PAL_PER_TEST == true>
+    PAL_PER_TEST_DATA perTest;
+
 </#if>
     uint8_t snifferEnabled;
 } PAL_DATA;
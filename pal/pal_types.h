@@ -81,6 +81,12 @@ about the modulation scheme to be used */
 #define PAL_RF_EN          0x02U
 #define PAL_SERIAL_EN      0x04U
 
+/* Invalid neighbor identifier for the medium advisor */
+#define PAL_NEIGHBOR_ID_INVALID    0xFFFFFFFFUL
+
+/* No deadline: PAL only needs to run after an interrupt */
+#define PAL_DEADLINE_NONE          0xFFFFFFFFUL
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Data Types
@@ -538,6 +544,175 @@ typedef struct {
     PAL_SWITCH_RF_CH_CB switchRfChannel;
 } PAL_CALLBACKS;
 
+// *****************************************************************************
+/* PAL Channel Quality
+
+  Summary:
+    Quality statistics of a PLC channel.
+
+  Description:
+    This data type contains the statistics of a PLC channel collected by the
+    PLC channel monitor while the channel is idle.
+
+  Remarks:
+    Noise levels are given in dBuV.
+*/
+typedef struct {
+    /* Number of samples taken in the channel */
+    uint32_t numSamples;
+    /* Physical channel */
+    uint16_t pch;
+    /* Average noise level (exponential moving average) */
+    uint8_t noiseAvg;
+    /* 90th percentile of the noise level */
+    uint8_t noiseP90;
+    /* Percentage of samples with carrier detected */
+    uint8_t occupancy;
+} PAL_CHANNEL_QUALITY;
+
+/* Number of frame types with airtime counters (Type A, Type B, Type BC, RF) */
+#define PAL_AIRTIME_NUM_FRAME_TYPES   4U
+
+/* Number of modulation schemes with airtime counters (PAL_SCHEME order) */
+#define PAL_AIRTIME_NUM_SCHEMES       11U
+
+// *****************************************************************************
+/* PAL Airtime Counters
+
+  Summary:
+    Airtime counters of a physical channel.
+
+  Description:
+    This data type contains the on-air time accumulated from the confirms of
+    the messages transmitted in a physical channel, the channel utilization in
+    the sliding window and the duty-cycle budget of the channel.
+
+  Remarks:
+    Times are given in us. Scheme counters follow the order of the PAL_SCHEME
+    definition.
+*/
+typedef struct {
+    /* On-air time per frame type (Type A, Type B, Type BC, RF) */
+    uint64_t frameTypeTime[PAL_AIRTIME_NUM_FRAME_TYPES];
+    /* On-air time per modulation scheme */
+    uint64_t schemeTime[PAL_AIRTIME_NUM_SCHEMES];
+    /* On-air time within the sliding window */
+    uint32_t windowTime;
+    /* Number of transmitted messages */
+    uint32_t numFrames;
+    /* Number of requests deferred by the duty-cycle budget */
+    uint32_t numDeferred;
+    /* Physical channel */
+    uint16_t pch;
+    /* Channel utilization within the sliding window [per mille] */
+    uint16_t utilization;
+    /* Duty-cycle budget [per mille] (0: no budget) */
+    uint16_t dutyCycleBudget;
+} PAL_AIRTIME_COUNTERS;
+
+// *****************************************************************************
+/* PAL CSMA Status
+
+  Summary:
+    Contention statistics and state of the adaptive CSMA.
+
+  Description:
+    This data type contains the number of transmissions, busy channel and
+    collision results, the rates measured in the sliding window and the
+    backoff level applied by the adaptive CSMA.
+
+  Remarks:
+    A collision is reported when a reception starts before the transmission.
+*/
+typedef struct {
+    /* Number of transmissions with CSMA result */
+    uint32_t numTx;
+    /* Number of transmissions aborted due to busy channel */
+    uint32_t numBusyCh;
+    /* Number of transmissions aborted due to reception in progress */
+    uint32_t numCollisions;
+    /* Percentage of busy channel results in the sliding window */
+    uint8_t busyRate;
+    /* Percentage of collisions in the sliding window */
+    uint8_t collisionRate;
+    /* Backoff level (0: quiet, 1: nominal, >1: contention) */
+    uint8_t backoffLevel;
+    /* Adaptive mode enabled */
+    bool adaptive;
+} PAL_CSMA_STATUS;
+
+// *****************************************************************************
+/* PAL TX Scheduler Counters
+
+  Summary:
+    Counters of the TX reservation scheduler.
+
+  Description:
+    This data type contains the number of reservations of absolute time
+    transmissions, the conflicts detected and how they have been solved.
+
+  Remarks:
+    None.
+*/
+typedef struct {
+    /* Number of reservations stored */
+    uint32_t numReservations;
+    /* Number of requests overlapping another reservation */
+    uint32_t numConflicts;
+    /* Number of requests overlapping a programmed channel switch */
+    uint32_t numSwitchConflicts;
+    /* Number of conflicting requests rejected */
+    uint32_t numRejected;
+    /* Number of conflicting requests delayed */
+    uint32_t numDelayed;
+    /* Number of requests not stored because the table is full */
+    uint32_t numOverflows;
+    /* Number of reservations in the table */
+    uint8_t numActive;
+} PAL_TX_SCHED_COUNTERS;
+
+// *****************************************************************************
+/* PAL Configuration Item
+
+  Summary:
+    Defines an attribute access of a batched configuration request.
+
+  Description:
+    This data type defines one attribute to be read or written through
+    PAL_GetConfigurationBatch or PAL_SetConfigurationBatch. The result of the
+    access is stored in the item.
+
+  Remarks:
+    None.
+*/
+typedef struct {
+    /* Pointer to the attribute value */
+    void *pValue;
+    /* Attribute identifier (PAL_ATTRIBUTE_ID) */
+    uint16_t id;
+    /* Length of the attribute value in bytes */
+    uint16_t length;
+    /* Result of the access (PAL_CFG_RESULT) */
+    uint8_t result;
+} PAL_CFG_ITEM;
+
+// *****************************************************************************
+/* PAL Neighbor Identifier Callback
+
+  Summary:
+    Callback used by the medium advisor to identify the neighbor of a message.
+
+  Description:
+    This callback is used by the PAL medium advisor to get the identifier of
+    the neighbor which transmitted a received message (isTx = false) or the
+    neighbor to which a message is transmitted (isTx = true). The callback
+    returns PAL_NEIGHBOR_ID_INVALID if the neighbor cannot be identified.
+
+  Remarks:
+    The format of the identifier is defined by the upper layer.
+*/
+typedef uint32_t (*PAL_NEIGHBOR_ID_CB)(uint8_t *pData, uint16_t length, bool isTx);
+
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
 
@@ -86,6 +86,9 @@ Microchip or any third party.
 /* It doesn't affect to relative time between RX and TX (compensated) */
 #define PAL_PLC_TIMER_SYNC_OFFSET    6U
 
+/* Error in us of a read of Host and PL360 timers, after offset compensation */
+#define PAL_PLC_TIMER_SYNC_ERROR_US  1U
+
 /* Maximum and minimum relative frequency between PL360 and host timers (F_host/F_360 [uQ1.24]) */
 /* It is used to detect wrong timer reads */
 #define SYNC_TIMER_REL_FREQ_MAX  0x01000D1BU /* +200 PPM */
@@ -165,6 +168,26 @@ static void lPAL_PLC_SysTimeCB( uintptr_t context )
     palPlcData.syncUpdate = true;
 }
 
+static void lPAL_PLC_ChannelSwitchTimeCB(uintptr_t context)
+{
+    /* Avoid warning */
+    (void)context;
+
+    /* Channel switch is executed from PAL_PLC_Tasks */
+    palPlcData.channelSwitchHandle = SYS_TIME_HANDLE_INVALID;
+    palPlcData.channelSwitchPending = true;
+}
+
+<#if PRIME_PAL_PLC_CHANNEL_MONITOR == true>
+static void lPAL_PLC_MonitorTimeCB(uintptr_t context)
+{
+    /* Avoid warning */
+    (void)context;
+
+    palPlcData.monitorUpdate = true;
+}
+
+</#if>
 static uint16_t lPAL_PLC_GetPCH(DRV_PLC_PHY_CHANNEL channel)
 {
     uint16_t pch;
@@ -259,6 +282,14 @@ static uint32_t lPAL_PLC_TimerSyncRead(uint32_t *pTimePlc)
     return timeHost;
 }
 
+static void lPAL_PLC_TimerSyncPublish(uint16_t driftPpm)
+{
+    /* Share PLC timer model with the clock domain translator */
+    SRV_TIME_MANAGEMENT_DomainUpdate(SRV_TIME_MANAGEMENT_DOMAIN_PLC,
+            palPlcData.timeRefPlc, palPlcData.timeRefHost,
+            palPlcData.syncTimerRelFreq, PAL_PLC_TIMER_SYNC_ERROR_US, driftPpm);
+}
+
 __STATIC_INLINE void lPAL_PLC_TimerSyncInitialize(void)
 {
     if (!palPlcData.syncEnable)
@@ -272,6 +303,7 @@ __STATIC_INLINE void lPAL_PLC_TimerSyncInitialize(void)
 
         /* Initialize relative frequency F_host/F_plc to 1 [uQ1.24] */
         palPlcData.syncTimerRelFreq = 1UL << 24;
+        lPAL_PLC_TimerSyncPublish(200);
 
         /* Program first interrupt after 50 ms (5 us deviation with 100 PPM) */
         palPlcData.syncDelay = 50000;
@@ -322,21 +354,25 @@ __STATIC_INLINE void lPAL_PLC_TimerSyncUpdate(void)
             case 0:
                 /* Next sync after 50 ms (5 us deviation with 100 PPM) */
                 palPlcData.syncDelay = 50000;
+                lPAL_PLC_TimerSyncPublish(100);
                 break;
 
             case 50000:
                 /* Next sync after 250 ms (5 us deviation with 20 PPM) */
                 palPlcData.syncDelay = 250000;
+                lPAL_PLC_TimerSyncPublish(20);
                 break;
 
             case 250000:
                 /* Next sync after 1 second (5 us deviation with 5 PPM) */
                 palPlcData.syncDelay = 1000000;
+                lPAL_PLC_TimerSyncPublish(5);
                 break;
 
             default:
                 /* Next sync after 5 seconds (5 us deviation with 1 PPM) */
                 palPlcData.syncDelay = 5000000;
+                lPAL_PLC_TimerSyncPublish(1);
                 break;
         }
 
@@ -435,20 +471,11 @@ static uint32_t lPAL_PLC_GetPlcTime(uint32_t timeHost)
     return (uint32_t)(timePlc);
 }
 
-static void lPAL_PLC_SetTxRxChannel(DRV_PLC_PHY_CHANNEL channel)
+static void lPAL_PLC_SetChannelCoupling(DRV_PLC_PHY_CHANNEL channel)
 {
-    /* Set channel configuration */
-    palPlcData.plcPIB.id = PLC_ID_CHANNEL_CFG;
-    palPlcData.plcPIB.length = 1;
-    palPlcData.plcPIB.pData = &channel;
-    (void)DRV_PLC_PHY_PIBSet(palPlcData.drvPhyHandle, &palPlcData.plcPIB);
-
     /* Set coupling configuration */
     (void)SRV_PCOUP_SetChannelConfig(palPlcData.drvPhyHandle, channel);
 
-    /* Initialize synchronization of PL360-Host timers when channel updated */
-    lPAL_PLC_TimerSyncInitialize();
-
 <#if PAL_PLC_COUP11 = true>
     if (palPlcData.networkDetected == true)
     {
@@ -468,6 +495,406 @@ static void lPAL_PLC_SetTxRxChannel(DRV_PLC_PHY_CHANNEL channel)
 </#if>
 }
 
+static void lPAL_PLC_SetTxRxChannel(DRV_PLC_PHY_CHANNEL channel)
+{
+    /* Set channel configuration */
+    palPlcData.plcPIB.id = PLC_ID_CHANNEL_CFG;
+    palPlcData.plcPIB.length = 1;
+    palPlcData.plcPIB.pData = &channel;
+    (void)DRV_PLC_PHY_PIBSet(palPlcData.drvPhyHandle, &palPlcData.plcPIB);
+
+    /* Initialize synchronization of PL360-Host timers when channel updated */
+    lPAL_PLC_TimerSyncInitialize();
+
+    lPAL_PLC_SetChannelCoupling(channel);
+}
+
+static uint16_t lPAL_PLC_GetPayloadSymbols(uint16_t length, PAL_SCHEME scheme, PAL_FRAME frameType)
+{
+    uint16_t frameLen;
+    uint16_t paySymbols;
+    uint8_t symbolSize;
+
+    frameLen = length;
+
+    if (frameType == PAL_FRAME_TYPE_A)
+    {
+        /* There are 7 bytes inside the header */
+        if (frameLen < 7U)
+        {
+            frameLen = 0;
+        }
+        else
+        {
+            frameLen -= 7U;
+        }
+    }
+
+    if ((uint8_t)scheme >= sizeof(palPlcSymbolSize))
+    {
+        return 0;
+    }
+
+    symbolSize = palPlcSymbolSize[scheme];
+    if (symbolSize == 0U)
+    {
+        return 0;
+    }
+
+    if (scheme >= PAL_SCHEME_DBPSK_C)
+    {
+        /* Increase a byte for flushing */
+        frameLen++;
+    }
+
+    paySymbols = (uint16_t)(frameLen / symbolSize);
+    if ((frameLen % symbolSize) > 0U) {
+        paySymbols++;
+    }
+
+    /* adjust ROB scheme */
+    if (((uint8_t)(scheme) & 0x08U) > 0U) {
+        paySymbols = (uint16_t)(paySymbols << 2);
+    }
+
+    return paySymbols;
+}
+
+static PAL_PLC_PIB_CACHE_INDEX lPAL_PLC_GetPibCacheIndex(DRV_PLC_PHY_ID plcID)
+{
+    switch (plcID)
+    {
+        case PLC_ID_VERSION_NUM:
+            /* Static: only changes after PLC device reset */
+            return PAL_PLC_PIB_CACHE_INFO_VERSION;
+
+        case PLC_ID_HOST_PRODUCT_ID:
+            /* Static: only changes after PLC device reset */
+            return PAL_PLC_PIB_CACHE_INFO_DEVICE;
+
+        case PLC_ID_HOST_VERSION_ID:
+            /* Invalidated when written */
+            return PAL_PLC_PIB_CACHE_HOST_VERSION;
+
+        default:
+            return PAL_PLC_PIB_CACHE_NONE;
+    }
+}
+
+<#if PRIME_PAL_PLC_ADAPTIVE_CSMA == true>
+static uint8_t lPAL_PLC_CsmaGetRate(uint32_t history)
+{
+    uint8_t count = 0;
+
+    while (history != 0U)
+    {
+        history &= (history - 1U);
+        count++;
+    }
+
+    return (uint8_t)(((uint32_t)count * 100U) / palPlcData.csmaNumSamples);
+}
+
+static void lPAL_PLC_CsmaUpdate(DRV_PLC_PHY_TX_RESULT result)
+{
+    PAL_CSMA_STATUS *pStatus = &palPlcData.csmaStatus;
+    uint8_t contentionRate;
+
+    /* Only results of transmissions which went through CSMA */
+    if ((result != DRV_PLC_PHY_TX_RESULT_SUCCESS) &&
+        (result != DRV_PLC_PHY_TX_RESULT_BUSY_CH) &&
+        (result != DRV_PLC_PHY_TX_RESULT_BUSY_RX))
+    {
+        return;
+    }
+
+    pStatus->numTx++;
+    palPlcData.csmaBusyHist <<= 1;
+    palPlcData.csmaCollisionHist <<= 1;
+
+    if (result == DRV_PLC_PHY_TX_RESULT_BUSY_CH)
+    {
+        pStatus->numBusyCh++;
+        palPlcData.csmaBusyHist |= 1U;
+    }
+    else if (result == DRV_PLC_PHY_TX_RESULT_BUSY_RX)
+    {
+        pStatus->numCollisions++;
+        palPlcData.csmaCollisionHist |= 1U;
+    }
+    else
+    {
+        /* Transmission without contention */
+    }
+
+    if (palPlcData.csmaNumSamples < PAL_PLC_CSMA_WINDOW)
+    {
+        palPlcData.csmaNumSamples++;
+    }
+
+    pStatus->busyRate = lPAL_PLC_CsmaGetRate(palPlcData.csmaBusyHist);
+    pStatus->collisionRate = lPAL_PLC_CsmaGetRate(palPlcData.csmaCollisionHist);
+
+    if ((pStatus->adaptive == false) || (palPlcData.csmaNumSamples < PAL_PLC_CSMA_MIN_SAMPLES))
+    {
+        return;
+    }
+
+    contentionRate = pStatus->busyRate + pStatus->collisionRate;
+    if ((contentionRate >= PAL_PLC_CSMA_HIGH_RATE) && (pStatus->backoffLevel < PAL_PLC_CSMA_MAX_LEVEL))
+    {
+        pStatus->backoffLevel++;
+    }
+    else if ((contentionRate <= PAL_PLC_CSMA_LOW_RATE) && (pStatus->backoffLevel > PAL_PLC_CSMA_LEVEL_QUIET))
+    {
+        pStatus->backoffLevel--;
+    }
+    else
+    {
+        /* Keep backoff level */
+        return;
+    }
+
+    /* Measure the contention with the new level */
+    palPlcData.csmaBusyHist = 0;
+    palPlcData.csmaCollisionHist = 0;
+    palPlcData.csmaNumSamples = 0;
+}
+
+static void lPAL_PLC_CsmaApply(PAL_MSG_REQUEST_DATA *pMessageData)
+{
+    uint32_t senseCount = pMessageData->numSenses;
+    uint32_t senseDelayMs = pMessageData->senseDelayMs;
+    uint32_t backoffWindow;
+    uint8_t level = palPlcData.csmaStatus.backoffLevel;
+
+    if ((palPlcData.csmaStatus.adaptive == true) && (senseCount > 0U))
+    {
+        if (level == PAL_PLC_CSMA_LEVEL_QUIET)
+        {
+            /* Quiet channel: half of the senses */
+            senseCount = (senseCount + 1U) >> 1;
+        }
+        else if (level > PAL_PLC_CSMA_LEVEL_NOMINAL)
+        {
+            /* Contention: more senses and random delay in a growing window */
+            senseCount += (uint32_t)level - PAL_PLC_CSMA_LEVEL_NOMINAL;
+            senseCount = MIN(senseCount, PAL_PLC_CSMA_MAX_SENSES);
+
+            backoffWindow = (MAX(senseDelayMs, 1U) << (level - PAL_PLC_CSMA_LEVEL_NOMINAL)) + 1U;
+            senseDelayMs += TRNG_ReadData() % backoffWindow;
+            senseDelayMs = MIN(senseDelayMs, 0xFFU);
+        }
+        else
+        {
+            /* Nominal: parameters from upper layer */
+        }
+    }
+
+    palPlcData.phyTxObj.csma.senseCount = (uint8_t)senseCount;
+    palPlcData.phyTxObj.csma.senseDelayMs = (uint8_t)senseDelayMs;
+}
+
+</#if>
+<#if PRIME_PAL_PLC_CHANNEL_MONITOR == true>
+static void lPAL_PLC_MonitorSample(void)
+{
+    DRV_PLC_PHY_CD_INFO cdData;
+    PAL_PLC_CHANNEL_STATS *pStats;
+    uint8_t noise;
+    uint8_t bin;
+    uint8_t index;
+
+    if (((uint8_t)palPlcData.channel == 0U) ||
+        ((uint8_t)palPlcData.channel > PAL_PLC_MONITOR_NUM_CHANNELS))
+    {
+        return;
+    }
+
+    /* Read Carrier Detect information from PL360 */
+    palPlcData.plcPIB.id = PLC_ID_RX_CD_INFO;
+    palPlcData.plcPIB.length = (uint16_t)(sizeof(cdData));
+    palPlcData.plcPIB.pData = (uint8_t *)&cdData;
+    (void)DRV_PLC_PHY_PIBGet(palPlcData.drvPhyHandle, &palPlcData.plcPIB);
+
+    pStats = &palPlcData.channelStats[(uint8_t)palPlcData.channel - 1U];
+    pStats->numSamples++;
+
+    if (cdData.cdRxState != CD_RX_IDLE)
+    {
+        /* Busy channel: only occupancy is updated */
+        pStats->occupancy -= (pStats->occupancy >> 4);
+        pStats->occupancy += (256U >> 4);
+        return;
+    }
+
+    pStats->occupancy -= (pStats->occupancy >> 4);
+
+    /* RSSI and CINR in Carrier Detect information belong to the last
+     * received frame: noise level is taken once per frame */
+    if (cdData.rxTimeEnd == palPlcData.monitorRxTimeEnd)
+    {
+        return;
+    }
+
+    palPlcData.monitorRxTimeEnd = cdData.rxTimeEnd;
+
+    /* Noise floor under the frame, as in PAL_PLC_GetNL. CINR is in 1/4 dB */
+    if (cdData.rssiAvg <= (cdData.cinrAvg >> 2))
+    {
+        return;
+    }
+
+    noise = cdData.rssiAvg - (cdData.cinrAvg >> 2);
+    pStats->numNoiseSamples++;
+    if (pStats->numNoiseSamples == 1U)
+    {
+        pStats->noiseAvg = (uint16_t)noise << 4;
+    }
+    else
+    {
+        pStats->noiseAvg -= (pStats->noiseAvg >> 4);
+        pStats->noiseAvg += (uint16_t)noise;
+    }
+
+    /* Same bins as PRIME RSSI: 0: <=70 dBuV; 1: <=72 dBuV; ... 15: >98 dBuV */
+    bin = (uint8_t)MAX(noise, 69U);
+    bin -= 69U;
+    bin >>= 1;
+    bin = MIN(bin, (uint8_t)(PAL_PLC_MONITOR_NUM_BINS - 1U));
+
+    if (pStats->noiseHist[bin] == 0xFFU)
+    {
+        for (index = 0; index < PAL_PLC_MONITOR_NUM_BINS; index++)
+        {
+            pStats->noiseHist[index] >>= 1;
+        }
+    }
+
+    pStats->noiseHist[bin]++;
+}
+
+</#if>
+static void lPAL_PLC_FlushPibCache(void)
+{
+    uint8_t index;
+
+    for (index = 0; index < (uint8_t)PAL_PLC_PIB_CACHE_NUM_ENTRIES; index++)
+    {
+        palPlcData.pibCache[index].valid = false;
+    }
+}
+<#if PRIME_PAL_PHY_SNIFFER == true>
+
+static void lPAL_PLC_SnifferCaptureCfm(DRV_PLC_PHY_TRANSMISSION_CFM_OBJ *pCfmObj)
+{
+    PAL_PLC_SNIFFER_ENTRY *pEntry;
+    uint16_t dataLength;
+
+    if (palPlcData.snifferQueueCount >= PAL_PLC_SNIFFER_QUEUE_SIZE)
+    {
+        /* Sniffer queue full: frame is not reported */
+        return;
+    }
+
+    dataLength = palPlcData.phyTxObj.dataLength;
+    if (dataLength > PAL_PLC_SNIFFER_MAX_DATA_SIZE)
+    {
+        dataLength = (uint16_t)PAL_PLC_SNIFFER_MAX_DATA_SIZE;
+    }
+
+    pEntry = &palPlcData.snifferQueue[palPlcData.snifferQueueTail];
+    pEntry->event = PAL_PLC_SNIFFER_EVENT_TX_CFM;
+    pEntry->channel = palPlcData.channel;
+    (void)memcpy(&pEntry->cfmObj, pCfmObj, sizeof(DRV_PLC_PHY_TRANSMISSION_CFM_OBJ));
+    (void)memcpy(&pEntry->txObj, &palPlcData.phyTxObj, sizeof(DRV_PLC_PHY_TRANSMISSION_OBJ));
+    (void)memcpy(pEntry->data, palPlcData.phyTxObj.pTransmitData, dataLength);
+    pEntry->txObj.dataLength = dataLength;
+
+    palPlcData.snifferQueueTail = (palPlcData.snifferQueueTail + 1U) % PAL_PLC_SNIFFER_QUEUE_SIZE;
+    palPlcData.snifferQueueCount++;
+}
+
+static void lPAL_PLC_SnifferCaptureInd(DRV_PLC_PHY_RECEPTION_OBJ *pIndObj)
+{
+    PAL_PLC_SNIFFER_ENTRY *pEntry;
+    uint16_t dataLength;
+
+    if (palPlcData.snifferQueueCount >= PAL_PLC_SNIFFER_QUEUE_SIZE)
+    {
+        /* Sniffer queue full: frame is not reported */
+        return;
+    }
+
+    dataLength = pIndObj->dataLength;
+    if (dataLength > PAL_PLC_SNIFFER_MAX_DATA_SIZE)
+    {
+        dataLength = (uint16_t)PAL_PLC_SNIFFER_MAX_DATA_SIZE;
+    }
+
+    pEntry = &palPlcData.snifferQueue[palPlcData.snifferQueueTail];
+    pEntry->event = PAL_PLC_SNIFFER_EVENT_RX_IND;
+    pEntry->channel = palPlcData.channel;
+    (void)memcpy(&pEntry->indObj, pIndObj, sizeof(DRV_PLC_PHY_RECEPTION_OBJ));
+    (void)memcpy(pEntry->data, pIndObj->pReceivedData, dataLength);
+    pEntry->indObj.dataLength = dataLength;
+
+    palPlcData.snifferQueueTail = (palPlcData.snifferQueueTail + 1U) % PAL_PLC_SNIFFER_QUEUE_SIZE;
+    palPlcData.snifferQueueCount++;
+}
+
+static void lPAL_PLC_SnifferTasks(void)
+{
+    PAL_PLC_SNIFFER_ENTRY *pEntry;
+    size_t length;
+    uint16_t paySymbols;
+
+    while (palPlcData.snifferQueueCount > 0U)
+    {
+        pEntry = &palPlcData.snifferQueue[palPlcData.snifferQueueHead];
+
+        if (palPlcData.snifferCallback != NULL)
+        {
+            /* Report the channel in which the frame was captured */
+            SRV_PSNIFFER_SetPLCChannel((uint8_t)pEntry->channel);
+
+            if (pEntry->event == PAL_PLC_SNIFFER_EVENT_TX_CFM)
+            {
+                pEntry->txObj.pTransmitData = pEntry->data;
+                SRV_PSNIFFER_SetTxMessage(&pEntry->txObj);
+
+                paySymbols = lPAL_PLC_GetPayloadSymbols(pEntry->txObj.dataLength,
+                        (PAL_SCHEME)pEntry->txObj.scheme, (PAL_FRAME)pEntry->txObj.frameType);
+                SRV_PSNIFFER_SetTxPayloadSymbols(paySymbols);
+
+                length = SRV_PSNIFFER_SerialCfmMessage(palPlcData.snifferData, &pEntry->cfmObj);
+            }
+            else
+            {
+                pEntry->indObj.pReceivedData = pEntry->data;
+
+                paySymbols = lPAL_PLC_GetPayloadSymbols(pEntry->indObj.dataLength,
+                        (PAL_SCHEME)pEntry->indObj.scheme, (PAL_FRAME)pEntry->indObj.frameType);
+                SRV_PSNIFFER_SetRxPayloadSymbols(paySymbols);
+
+                length = SRV_PSNIFFER_SerialRxMessage(palPlcData.snifferData, &pEntry->indObj);
+            }
+
+            if (length != 0U)
+            {
+                palPlcData.snifferCallback(palPlcData.snifferData, length);
+            }
+        }
+
+        palPlcData.snifferQueueHead = (palPlcData.snifferQueueHead + 1U) % PAL_PLC_SNIFFER_QUEUE_SIZE;
+        palPlcData.snifferQueueCount--;
+    }
+
+    /* Restore current PLC channel in sniffer */
+    SRV_PSNIFFER_SetPLCChannel((uint8_t)palPlcData.channel);
+}
+</#if>
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Callback Functions
@@ -483,12 +910,18 @@ static void lPAL_PLC_PLC_DataCfmCb(DRV_PLC_PHY_TRANSMISSION_CFM_OBJ *pCfmObj, ui
         lPAL_PLC_TimerSyncInitialize();
     }
 
+    palPlcData.waitingTxCfm = false;
+
     if (palPlcData.status == PAL_PLC_STATUS_DETECT_IMPEDANCE)
     {
         palPlcData.detectImpedanceResult = pCfmObj->result;
         return;
     }
 
+<#if PRIME_PAL_PLC_ADAPTIVE_CSMA == true>
+    lPAL_PLC_CsmaUpdate(pCfmObj->result);
+
+</#if>
     if (palPlcData.plcCallbacks.dataConfirm != NULL)
     {
         PAL_MSG_CONFIRM_DATA dataCfm;
@@ -517,24 +950,8 @@ static void lPAL_PLC_PLC_DataCfmCb(DRV_PLC_PHY_TRANSMISSION_CFM_OBJ *pCfmObj, ui
 <#if PRIME_PAL_PHY_SNIFFER == true>
     if ((palPlcData.snifferCallback) != NULL)
     {
-        size_t dataLength;
-        uint16_t paySymbols;
-        uint16_t payloadSymbols;
-
-        palPlcData.plcPIB.id = PLC_ID_TX_PAY_SYMBOLS;
-        palPlcData.plcPIB.length = 2;
-        palPlcData.plcPIB.pData = (uint8_t *)&paySymbols;
-        (void)DRV_PLC_PHY_PIBGet(palPlcData.drvPhyHandle, &palPlcData.plcPIB);
-
-        payloadSymbols = (uint16_t)palPlcData.plcPIB.pData[0] | ((uint16_t)palPlcData.plcPIB.pData[1] << 8);
-        SRV_PSNIFFER_SetTxPayloadSymbols(payloadSymbols);
-
-        dataLength = SRV_PSNIFFER_SerialCfmMessage(palPlcData.snifferData, pCfmObj);
-
-        if (dataLength != 0U)
-        {
-            palPlcData.snifferCallback(palPlcData.snifferData, dataLength);
-        }
+        /* Serialization is deferred to PAL_PLC_Tasks */
+        lPAL_PLC_SnifferCaptureCfm(pCfmObj);
     }
 
 </#if>
@@ -591,22 +1008,8 @@ static void lPAL_PLC_PLC_DataIndCb(DRV_PLC_PHY_RECEPTION_OBJ *pIndObj, uintptr_t
 <#if PRIME_PAL_PHY_SNIFFER == true>
     if ((palPlcData.snifferCallback) != NULL)
     {
-        size_t length;
-        uint16_t paySymbols;
-
-        palPlcData.plcPIB.id = PLC_ID_RX_PAY_SYMBOLS;
-        palPlcData.plcPIB.length = 2;
-        palPlcData.plcPIB.pData = (uint8_t *)&paySymbols;
-        (void)DRV_PLC_PHY_PIBGet(palPlcData.drvPhyHandle, &palPlcData.plcPIB);
-
-        SRV_PSNIFFER_SetRxPayloadSymbols(paySymbols);
-
-        length = SRV_PSNIFFER_SerialRxMessage(palPlcData.snifferData, pIndObj);
-
-        if (length != 0U)
-        {
-            palPlcData.snifferCallback(palPlcData.snifferData, length);
-        }
+        /* Serialization is deferred to PAL_PLC_Tasks */
+        lPAL_PLC_SnifferCaptureInd(pIndObj);
     }
 
 </#if>
@@ -714,6 +1117,23 @@ SYS_MODULE_OBJ PAL_PLC_Initialize(void)
     palPlcData.palAttenuation = 0;
     palPlcData.syncEnable = false;
     palPlcData.syncHandle = SYS_TIME_HANDLE_INVALID;
+    palPlcData.channelSwitchHandle = SYS_TIME_HANDLE_INVALID;
+    palPlcData.channelSwitchPending = false;
+    lPAL_PLC_FlushPibCache();
+<#if PRIME_PAL_PLC_ADAPTIVE_CSMA == true>
+    (void)memset(&palPlcData.csmaStatus, 0, sizeof(palPlcData.csmaStatus));
+    palPlcData.csmaStatus.backoffLevel = PAL_PLC_CSMA_LEVEL_NOMINAL;
+    palPlcData.csmaBusyHist = 0;
+    palPlcData.csmaCollisionHist = 0;
+    palPlcData.csmaNumSamples = 0;
+</#if>
+<#if PRIME_PAL_PLC_CHANNEL_MONITOR == true>
+    palPlcData.monitorHandle = SYS_TIME_HANDLE_INVALID;
+    palPlcData.monitorUpdate = false;
+    palPlcData.monitorCfmDeadline = 0;
+    palPlcData.monitorRxTimeEnd = 0;
+    (void)memset(palPlcData.channelStats, 0, sizeof(palPlcData.channelStats));
+</#if>
 
     /* Read Default Channel */
     palPlcData.channel = SRV_PCOUP_GetDefaultChannel();
@@ -865,6 +1285,15 @@ void PAL_PLC_Tasks(void)
             palPlcData.channel = SRV_PCOUP_GetDefaultChannel();
             lPAL_PLC_SetTxRxChannel(palPlcData.channel);
 
+<#if PRIME_PAL_PLC_CHANNEL_MONITOR == true>
+            /* Start PLC channel monitor */
+            if (palPlcData.monitorHandle == SYS_TIME_HANDLE_INVALID)
+            {
+                palPlcData.monitorHandle = SRV_TIME_MANAGEMENT_CbRegisterMS(
+                        lPAL_PLC_MonitorTimeCB, 0, PAL_PLC_MONITOR_PERIOD_MS, SYS_TIME_PERIODIC);
+            }
+
+</#if>
             /* Set PAL status to ready */
             palPlcData.status = PAL_PLC_STATUS_READY;
             break;
@@ -876,6 +1305,43 @@ void PAL_PLC_Tasks(void)
                 /* Update synchronization between Host and PL360 timers */
                 lPAL_PLC_TimerSyncUpdate();
             }
+
+            if (palPlcData.channelSwitchPending == true)
+            {
+                /* Execute programmed channel switch: channel PIB prepared
+                 * when it was programmed, then timer synchronization and
+                 * coupling of the new channel before any other frame is sent */
+                palPlcData.channelSwitchPending = false;
+                (void)DRV_PLC_PHY_PIBSet(palPlcData.drvPhyHandle, &palPlcData.channelSwitchPIB);
+                palPlcData.channel = palPlcData.channelSwitchNext;
+                lPAL_PLC_TimerSyncInitialize();
+                lPAL_PLC_SetChannelCoupling(palPlcData.channel);
+
+                if (palPlcData.plcCallbacks.switchRfChannel != NULL)
+                {
+                    palPlcData.plcCallbacks.switchRfChannel(lPAL_PLC_GetPCH(palPlcData.channel));
+                }
+            }
+<#if PRIME_PAL_PLC_CHANNEL_MONITOR == true>
+
+            if (palPlcData.monitorUpdate == true)
+            {
+                palPlcData.monitorUpdate = false;
+
+                if ((palPlcData.waitingTxCfm == true) &&
+                    ((int32_t)(SRV_TIME_MANAGEMENT_GetTimeUS() - palPlcData.monitorCfmDeadline) >= 0))
+                {
+                    /* Confirm lost: do not stop sampling */
+                    palPlcData.waitingTxCfm = false;
+                }
+
+                /* Sample only when there is no transmission in progress */
+                if (palPlcData.waitingTxCfm == false)
+                {
+                    lPAL_PLC_MonitorSample();
+                }
+            }
+</#if>
             break;
         }
 
@@ -892,6 +1358,9 @@ void PAL_PLC_Tasks(void)
                     /* Restart exception flag */
                     palPlcData.exceptionPending = false;
 
+                    /* PLC device has been reset */
+                    lPAL_PLC_FlushPibCache();
+
                     /* Set Channel for impedance detection */
                     palPlcData.channel = SRV_PCOUP_GetChannelImpedanceDetection();
                     lPAL_PLC_SetTxRxChannel(palPlcData.channel);
@@ -914,6 +1383,64 @@ void PAL_PLC_Tasks(void)
             break;
         }
     }
+<#if PRIME_PAL_PHY_SNIFFER == true>
+
+    /* Report captured PLC frames to the sniffer */
+    lPAL_PLC_SnifferTasks();
+</#if>
+}
+
+uint32_t PAL_PLC_GetNextDeadline(void)
+{
+    int32_t timeToSync;
+
+    switch (palPlcData.status)
+    {
+        case PAL_PLC_STATUS_UNINITIALIZED:
+        case PAL_PLC_STATUS_INVALID_OBJECT:
+            return PAL_DEADLINE_NONE;
+
+        case PAL_PLC_STATUS_READY:
+            break;
+
+        case PAL_PLC_STATUS_ERROR:
+            if (palPlcData.exceptionPending == false)
+            {
+                return PAL_DEADLINE_NONE;
+            }
+
+            /* PLC Driver status is polled until it is READY */
+            return 0;
+
+        default:
+            /* Initialization in progress */
+            return 0;
+    }
+
+<#if PRIME_PAL_PLC_CHANNEL_MONITOR == true>
+    if ((palPlcData.syncUpdate == true) || (palPlcData.channelSwitchPending == true) ||
+        (palPlcData.monitorUpdate == true))
+<#else>
+    if ((palPlcData.syncUpdate == true) || (palPlcData.channelSwitchPending == true))
+</#if>
+    {
+        return 0;
+    }
+
+    if ((palPlcData.syncEnable == false) || (palPlcData.syncDelay == 0U))
+    {
+        return PAL_DEADLINE_NONE;
+    }
+
+    /* Next synchronization between Host and PL360 timers */
+    timeToSync = (int32_t)((palPlcData.timeRefHost + palPlcData.syncDelay) -
+            SRV_TIME_MANAGEMENT_GetTimeUS());
+    if (timeToSync < 0)
+    {
+        return 0;
+    }
+
+    return (uint32_t)timeToSync;
 }
 
 void PAL_PLC_DataConfirmCallbackRegister(PAL_DATA_CONFIRM_CB callback)
@@ -921,6 +1448,11 @@ void PAL_PLC_DataConfirmCallbackRegister(PAL_DATA_CONFIRM_CB callback)
     palPlcData.plcCallbacks.dataConfirm = callback;
 }
 
+void PAL_PLC_ChannelSwitchCallbackRegister(PAL_SWITCH_RF_CH_CB callback)
+{
+    palPlcData.plcCallbacks.switchRfChannel = callback;
+}
+
 void PAL_PLC_DataIndicationCallbackRegister(PAL_DATA_INDICATION_CB callback)
 {
     palPlcData.plcCallbacks.dataIndication = callback;
@@ -947,17 +1479,30 @@ uint8_t PAL_PLC_DataRequest(PAL_MSG_REQUEST_DATA *pMessageData)
     palPlcData.phyTxObj.mode = (uint8_t)(pMessageData->timeMode);
     palPlcData.phyTxObj.attenuation = palPlcData.palAttenuation + pMessageData->attLevel;
     palPlcData.phyTxObj.csma.disableRx = pMessageData->disableRx;
+<#if PRIME_PAL_PLC_ADAPTIVE_CSMA == true>
+    lPAL_PLC_CsmaApply(pMessageData);
+<#else>
     palPlcData.phyTxObj.csma.senseCount = pMessageData->numSenses;
     palPlcData.phyTxObj.csma.senseDelayMs = pMessageData->senseDelayMs;
+</#if>
     palPlcData.phyTxObj.bufferId = (DRV_PLC_PHY_BUFFER_ID)(pMessageData->buffId);
     palPlcData.phyTxObj.scheme = (DRV_PLC_PHY_SCH)pMessageData->scheme;
     palPlcData.phyTxObj.frameType = (DRV_PLC_PHY_FRAME_TYPE)pMessageData->frameType;
     palPlcData.phyTxObj.pTransmitData = pMessageData->pData;
 
-<#if PRIME_PAL_PHY_SNIFFER == true>
-    SRV_PSNIFFER_SetTxMessage(&palPlcData.phyTxObj);
+<#if PRIME_PAL_PLC_CHANNEL_MONITOR == true>
+    if (pMessageData->timeMode == PAL_TX_MODE_ABSOLUTE)
+    {
+        palPlcData.monitorCfmDeadline = pMessageData->timeDelay + PAL_PLC_MONITOR_CFM_TIMEOUT_US;
+    }
+    else
+    {
+        palPlcData.monitorCfmDeadline = SRV_TIME_MANAGEMENT_GetTimeUS() + pMessageData->timeDelay +
+                PAL_PLC_MONITOR_CFM_TIMEOUT_US;
+    }
 
 </#if>
+    palPlcData.waitingTxCfm = true;
     DRV_PLC_PHY_TxRequest(palPlcData.drvPhyHandle, &palPlcData.phyTxObj);
 
     return ((uint8_t)PAL_TX_RESULT_PROCESS);
@@ -965,9 +1510,78 @@ uint8_t PAL_PLC_DataRequest(PAL_MSG_REQUEST_DATA *pMessageData)
 
 void PAL_PLC_ProgramChannelSwitch(uint32_t timeSync, uint16_t pch, uint8_t timeMode)
 {
-    (void)timeSync;
-    (void)pch;
-    (void)timeMode;
+    uint32_t delay;
+    uint8_t channel;
+
+    if (palPlcData.status != PAL_PLC_STATUS_READY)
+    {
+        return;
+    }
+
+    /* Cancel previously programmed channel switch */
+    if (palPlcData.channelSwitchHandle != SYS_TIME_HANDLE_INVALID)
+    {
+        (void)SYS_TIME_TimerDestroy(palPlcData.channelSwitchHandle);
+        palPlcData.channelSwitchHandle = SYS_TIME_HANDLE_INVALID;
+    }
+
+    palPlcData.channelSwitchPending = false;
+
+    if ((timeMode == (uint8_t)PAL_TX_MODE_CANCEL) || (pch == 0U))
+    {
+        return;
+    }
+
+    /* Resolve channel when programming, so the switch only applies it */
+    channel = lPAL_PLC_GetChannelNumber(pch);
+    if (channel > 15U)
+    {
+        return;
+    }
+
+    /* Channel must be supported by the coupling configuration */
+    if ((palPlcData.channelList & (1U << (channel - 1U))) == 0U)
+    {
+        return;
+    }
+
+    /* Prepare channel PIB, so the switch instant only has to send it */
+    palPlcData.channelSwitchNext = (DRV_PLC_PHY_CHANNEL)channel;
+    palPlcData.channelSwitchPIB.id = PLC_ID_CHANNEL_CFG;
+    palPlcData.channelSwitchPIB.length = 1;
+    palPlcData.channelSwitchPIB.pData = (uint8_t *)&palPlcData.channelSwitchNext;
+
+    if (timeMode == (uint8_t)PAL_TX_MODE_ABSOLUTE)
+    {
+        int32_t timeDiff = (int32_t)(timeSync - SRV_TIME_MANAGEMENT_GetTimeUS());
+
+        if (timeDiff <= 0)
+        {
+            delay = 0;
+        }
+        else
+        {
+            delay = (uint32_t)timeDiff;
+        }
+    }
+    else
+    {
+        delay = timeSync;
+    }
+
+    if (delay == 0U)
+    {
+        palPlcData.channelSwitchPending = true;
+        return;
+    }
+
+    palPlcData.channelSwitchHandle = SRV_TIME_MANAGEMENT_CbRegisterUS(
+            lPAL_PLC_ChannelSwitchTimeCB, 0, delay, SYS_TIME_SINGLE);
+    if (palPlcData.channelSwitchHandle == SYS_TIME_HANDLE_INVALID)
+    {
+        /* Timer not available: switch as soon as possible */
+        palPlcData.channelSwitchPending = true;
+    }
 }
 
 uint8_t PAL_PLC_GetTimer(uint32_t *pTimer)
@@ -1301,12 +1915,44 @@ uint8_t PAL_PLC_GetConfiguration(uint16_t id, void *pValue, uint16_t length)
 
     if(askPhy)
     {
-        /* Get in phy layer */
-        palPlcData.plcPIB.id = plcID;
-        palPlcData.plcPIB.length = length;
-        palPlcData.plcPIB.pData = (uint8_t *)pValue;
-        (void)DRV_PLC_PHY_PIBGet(palPlcData.drvPhyHandle, &palPlcData.plcPIB);
-        result = PAL_CFG_SUCCESS;
+        PAL_PLC_PIB_CACHE_INDEX cacheIndex = lPAL_PLC_GetPibCacheIndex(plcID);
+        PAL_PLC_PIB_CACHE_ENTRY *pCache = NULL;
+
+        if (cacheIndex != PAL_PLC_PIB_CACHE_NONE)
+        {
+            pCache = &palPlcData.pibCache[cacheIndex];
+        }
+
+        if ((pCache != NULL) && (pCache->valid == true) && (pCache->length == length))
+        {
+            /* Get from PIB cache */
+            (void)memcpy(pValue, pCache->value, length);
+            result = PAL_CFG_SUCCESS;
+        }
+        else
+        {
+            /* Get in phy layer */
+            palPlcData.plcPIB.id = plcID;
+            palPlcData.plcPIB.length = length;
+            palPlcData.plcPIB.pData = (uint8_t *)pValue;
+            if (DRV_PLC_PHY_PIBGet(palPlcData.drvPhyHandle, &palPlcData.plcPIB) == true)
+            {
+                if ((pCache != NULL) && (length <= PAL_PLC_PIB_CACHE_MAX_LENGTH))
+                {
+                    /* Update PIB cache */
+                    (void)memcpy(pCache->value, pValue, length);
+                    pCache->length = length;
+                    pCache->valid = true;
+                }
+
+                result = PAL_CFG_SUCCESS;
+            }
+            else
+            {
+                /* Do not cache or report a failed read */
+                result = PAL_CFG_INVALID_INPUT;
+            }
+        }
     }
 
     return((uint8_t)result);
@@ -1424,6 +2070,14 @@ uint8_t PAL_PLC_SetConfiguration(uint16_t id, void *pValue, uint16_t length)
 
     if(updatePhy)
     {
+        PAL_PLC_PIB_CACHE_INDEX cacheIndex = lPAL_PLC_GetPibCacheIndex(plcID);
+
+        if (cacheIndex != PAL_PLC_PIB_CACHE_NONE)
+        {
+            /* Value will be read again from phy layer */
+            palPlcData.pibCache[cacheIndex].valid = false;
+        }
+
         /* Set in phy layer */
         palPlcData.plcPIB.id = plcID;
         palPlcData.plcPIB.length = length;
@@ -1562,8 +2216,6 @@ uint16_t PAL_PLC_GetSignalCapture(uint8_t *pData, PAL_FRAME frameType, uint32_t
 uint8_t PAL_PLC_GetMsgDuration(uint16_t length, PAL_SCHEME scheme, PAL_FRAME frameType, uint32_t *pDuration)
 {
     uint32_t frameDuration;
-    uint16_t frameLen;
-    uint8_t symbolSize = 0;
 
     if (length == 0U)
     {
@@ -1571,48 +2223,107 @@ uint8_t PAL_PLC_GetMsgDuration(uint16_t length, PAL_SCHEME scheme, PAL_FRAME fra
         return((uint8_t)PAL_CFG_INVALID_INPUT);
     }
 
-    frameLen = length;
+    /* Update tx frame duration */
+    frameDuration = (uint32_t)lPAL_PLC_GetPayloadSymbols(length, scheme, frameType);
 
-    if (frameType == PAL_FRAME_TYPE_A)
+    frameDuration *= PHY_SYMBOL_TIME;
+    /* Adjust chirp and header for PHY frame */
+    frameDuration += palPlcTimeChirpHeader[frameType];
+
+    *pDuration = frameDuration;
+
+    return((uint8_t)PAL_CFG_SUCCESS);
+}
+
+<#if PRIME_PAL_PER_TEST == true>
+void PAL_PLC_GetRxQuality(uint8_t *pCinrAvg, uint16_t *pEvmPayload)
+{
+    /* Parameters of the last received message */
+    *pCinrAvg = palPlcData.rxParameters.cinrAvg;
+    *pEvmPayload = palPlcData.rxParameters.evmPayload;
+}
+
+</#if>
+<#if PRIME_PAL_PLC_ADAPTIVE_CSMA == true>
+uint8_t PAL_PLC_SetAdaptiveCsma(bool enable)
+{
+    palPlcData.csmaStatus.adaptive = enable;
+    if (enable == false)
     {
-        /* There are 7 bytes inside the header */
-        if (frameLen < 7U)
+        palPlcData.csmaStatus.backoffLevel = PAL_PLC_CSMA_LEVEL_NOMINAL;
+    }
+
+    return((uint8_t)PAL_CFG_SUCCESS);
+}
+
+uint8_t PAL_PLC_GetCsmaStatus(PAL_CSMA_STATUS *pStatus)
+{
+    *pStatus = palPlcData.csmaStatus;
+
+    return((uint8_t)PAL_CFG_SUCCESS);
+}
+
+</#if>
+<#if PRIME_PAL_PLC_CHANNEL_MONITOR == true>
+uint8_t PAL_PLC_GetChannelQualityMap(PAL_CHANNEL_QUALITY *pMap, uint8_t maxChannels, uint8_t *pNumChannels)
+{
+    PAL_PLC_CHANNEL_STATS *pStats;
+    PAL_CHANNEL_QUALITY *pQuality;
+    uint32_t numHist;
+    uint32_t accHist;
+    uint8_t numChannels = 0;
+    uint8_t index;
+    uint8_t bin;
+
+    for (index = 0; index < PAL_PLC_MONITOR_NUM_CHANNELS; index++)
+    {
+        pStats = &palPlcData.channelStats[index];
+
+        if (pStats->numSamples == 0U)
         {
-            frameLen = 0;
+            continue;
         }
-        else
+
+        if (numChannels >= maxChannels)
         {
-            frameLen -= 7U;
+            break;
         }
-    }
 
-    symbolSize = palPlcSymbolSize[scheme];
-    if (scheme >= PAL_SCHEME_DBPSK_C)
-    {
-        /* Increase a byte for flushing */
-        frameLen++;
-    }
+        pQuality = &pMap[numChannels];
+        pQuality->numSamples = pStats->numSamples;
+        pQuality->pch = lPAL_PLC_GetPCH((DRV_PLC_PHY_CHANNEL)(index + 1U));
+        pQuality->noiseAvg = (uint8_t)DIV_ROUND(pStats->noiseAvg, 16U);
+        pQuality->occupancy = (uint8_t)DIV_ROUND((uint32_t)pStats->occupancy * 100U, 256U);
 
-    /* Update tx frame duration */
-    frameDuration =  (uint32_t)((uint32_t)(frameLen) / symbolSize);
-    if ((frameLen % symbolSize) > 0U) {
-        frameDuration++;
-    }
+        /* 90th percentile of noise level from histogram */
+        numHist = 0;
+        for (bin = 0; bin < PAL_PLC_MONITOR_NUM_BINS; bin++)
+        {
+            numHist += pStats->noiseHist[bin];
+        }
 
-    /* adjust ROB scheme */
-    if (((uint8_t)(scheme) & 0x08U) > 0U) {
-        frameDuration <<= 2;
-    }
+        accHist = 0;
+        for (bin = 0; bin < (PAL_PLC_MONITOR_NUM_BINS - 1U); bin++)
+        {
+            accHist += pStats->noiseHist[bin];
+            if ((accHist * 10U) >= (numHist * 9U))
+            {
+                break;
+            }
+        }
 
-    frameDuration *= PHY_SYMBOL_TIME;
-    /* Adjust chirp and header for PHY frame */
-    frameDuration += palPlcTimeChirpHeader[frameType];
+        /* Upper limit of the bin (last bin is >98 dBuV) */
+        pQuality->noiseP90 = (uint8_t)(70U + ((uint32_t)bin << 1));
 
-    *pDuration = frameDuration;
+        numChannels++;
+    }
+
+    *pNumChannels = numChannels;
 
     return((uint8_t)PAL_CFG_SUCCESS);
 }
 
+</#if>
 <#if PRIME_PAL_PHY_SNIFFER == true>
 void PAL_PLC_USISnifferCallbackRegister(SRV_USI_HANDLE usiHandler, PAL_USI_SNIFFER_CB callback)
 {
@@ -64,8 +64,10 @@ extern const PAL_INTERFACE PAL_PLC_Interface;
 SYS_MODULE_OBJ PAL_PLC_Initialize(void);
 SYS_STATUS PAL_PLC_Status(void);
 void PAL_PLC_Tasks(void);
+uint32_t PAL_PLC_GetNextDeadline(void);
 void PAL_PLC_DataConfirmCallbackRegister(PAL_DATA_CONFIRM_CB callback);
 void PAL_PLC_DataIndicationCallbackRegister(PAL_DATA_INDICATION_CB callback);
+void PAL_PLC_ChannelSwitchCallbackRegister(PAL_SWITCH_RF_CH_CB callback);
 uint8_t PAL_PLC_DataRequest(PAL_MSG_REQUEST_DATA *pMessageData);
 void PAL_PLC_ProgramChannelSwitch(uint32_t timeSync, uint16_t pch, uint8_t timeMode);
 uint8_t PAL_PLC_GetSNR(uint8_t *pSnr, uint8_t qt);
@@ -83,6 +85,16 @@ uint8_t PAL_PLC_GetConfiguration(uint16_t id, void *pValue, uint16_t length);
 uint8_t PAL_PLC_SetConfiguration(uint16_t id, void *pValue, uint16_t length);
 uint16_t PAL_PLC_GetSignalCapture(uint8_t *pData, PAL_FRAME frameType, uint32_t timeStart, uint32_t duration);
 uint8_t PAL_PLC_GetMsgDuration(uint16_t length, PAL_SCHEME scheme, PAL_FRAME frameType, uint32_t *pDuration);
+<#if PRIME_PAL_PLC_CHANNEL_MONITOR == true>
+uint8_t PAL_PLC_GetChannelQualityMap(PAL_CHANNEL_QUALITY *pMap, uint8_t maxChannels, uint8_t *pNumChannels);
+</#if>
+<#if PRIME_PAL_PER_TEST == true>
+void PAL_PLC_GetRxQuality(uint8_t *pCinrAvg, uint16_t *pEvmPayload);
+</#if>
+<#if PRIME_PAL_PLC_ADAPTIVE_CSMA == true>
+uint8_t PAL_PLC_SetAdaptiveCsma(bool enable);
+uint8_t PAL_PLC_GetCsmaStatus(PAL_CSMA_STATUS *pStatus);
+</#if>
 <#if PRIME_PAL_PHY_SNIFFER == true>
 void PAL_PLC_USISnifferCallbackRegister(SRV_USI_HANDLE usiHandler, PAL_USI_SNIFFER_CB callback);
 </#if>
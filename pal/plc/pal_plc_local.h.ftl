@@ -130,6 +130,186 @@ typedef struct
     uint8_t impPercent;
 }  PAL_PLC_RX_PHY_PARAMS;
 
+// *****************************************************************************
+/* PAL PLC PIB Cache Entries
+
+  Summary:
+    Identifies the PLC PHY attributes stored in the PIB cache.
+
+  Description:
+    This enumeration identifies the entries of the cache of PLC PHY attributes
+    which are read through SPI from the PLC device and do not change unless
+    the device is reset or the attribute is explicitly set.
+
+  Remarks:
+    None.
+*/
+typedef enum {
+    PAL_PLC_PIB_CACHE_INFO_VERSION = 0,
+    PAL_PLC_PIB_CACHE_INFO_DEVICE,
+    PAL_PLC_PIB_CACHE_HOST_VERSION,
+    PAL_PLC_PIB_CACHE_NUM_ENTRIES,
+    PAL_PLC_PIB_CACHE_NONE = PAL_PLC_PIB_CACHE_NUM_ENTRIES,
+} PAL_PLC_PIB_CACHE_INDEX;
+
+/* Maximum length in bytes of an attribute stored in the PIB cache */
+#define PAL_PLC_PIB_CACHE_MAX_LENGTH      4U
+
+// *****************************************************************************
+/* PAL PLC PIB Cache Entry
+
+  Summary:
+    Holds the cached value of a PLC PHY attribute.
+
+  Description:
+    This structure contains the value of a PLC PHY attribute read on first
+    access. The entry is invalidated when the attribute is set and when the
+    PLC device is reset.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    uint8_t value[PAL_PLC_PIB_CACHE_MAX_LENGTH];
+    uint16_t length;
+    bool valid;
+} PAL_PLC_PIB_CACHE_ENTRY;
+
+<#if PRIME_PAL_PLC_ADAPTIVE_CSMA == true>
+/* Number of transmission results in the sliding window of the adaptive CSMA */
+#define PAL_PLC_CSMA_WINDOW               32U
+
+/* Minimum number of results in the window to change the backoff level */
+#define PAL_PLC_CSMA_MIN_SAMPLES          8U
+
+/* Backoff levels: 0: quiet, 1: nominal (upper layer parameters), >1: contention */
+#define PAL_PLC_CSMA_LEVEL_QUIET          0U
+#define PAL_PLC_CSMA_LEVEL_NOMINAL        1U
+#define PAL_PLC_CSMA_MAX_LEVEL            4U
+
+/* Contention rate (%) to increase the backoff level */
+#define PAL_PLC_CSMA_HIGH_RATE            30U
+
+/* Contention rate (%) to decrease the backoff level */
+#define PAL_PLC_CSMA_LOW_RATE             5U
+
+/* Maximum number of channel senses */
+#define PAL_PLC_CSMA_MAX_SENSES           15U
+
+</#if>
+<#if PRIME_PAL_PLC_CHANNEL_MONITOR == true>
+/* Sampling period in ms of the PLC channel monitor */
+#define PAL_PLC_MONITOR_PERIOD_MS         100U
+
+/* Number of PLC channels handled by the channel monitor (single and double) */
+#define PAL_PLC_MONITOR_NUM_CHANNELS      15U
+
+/* Number of bins of the noise level histogram (2 dB steps, as PRIME RSSI) */
+#define PAL_PLC_MONITOR_NUM_BINS          16U
+
+/* Time in us after the programmed TX time to give up waiting for a confirm */
+#define PAL_PLC_MONITOR_CFM_TIMEOUT_US    1000000U
+
+// *****************************************************************************
+/* PAL PLC Channel Statistics
+
+  Summary:
+    Holds the statistics of a PLC channel collected by the channel monitor.
+
+  Description:
+    This structure contains the noise level and occupancy statistics of a PLC
+    channel. Averages are exponentially weighted, with 1/16 weight for new
+    samples. The noise histogram is halved when a bin saturates, so old
+    samples lose weight.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    /* Number of samples taken */
+    uint32_t numSamples;
+    /* Number of samples which updated the noise level */
+    uint32_t numNoiseSamples;
+    /* Average noise level in dBuV [uQ8.4] */
+    uint16_t noiseAvg;
+    /* Average ratio of busy samples [uQ0.8] (256 = 100%) */
+    uint16_t occupancy;
+    /* Histogram of noise level */
+    uint8_t noiseHist[PAL_PLC_MONITOR_NUM_BINS];
+} PAL_PLC_CHANNEL_STATS;
+
+</#if>
+<#if PRIME_PAL_PHY_SNIFFER == true>
+// *****************************************************************************
+/* PAL PLC Sniffer Queue Size
+
+  Summary:
+    Number of PLC frames that can be pending of being reported to the sniffer.
+
+  Description:
+    PLC driver callbacks only capture frames into the sniffer queue. The frames
+    are serialized and reported later from PAL_PLC_Tasks. If the queue is full
+    when a new frame is captured, that frame is not reported to the sniffer.
+
+  Remarks:
+    None.
+*/
+#define PAL_PLC_SNIFFER_QUEUE_SIZE        2U
+
+/* Maximum length of the PLC data stored in every sniffer queue entry */
+#define PAL_PLC_SNIFFER_MAX_DATA_SIZE     512U
+
+// *****************************************************************************
+/* PAL PLC Sniffer Event Type
+
+  Summary:
+    Identifies the type of PLC event stored in the sniffer queue.
+
+  Description:
+    This enumeration identifies if a sniffer queue entry corresponds to a
+    transmission confirm or to a received message.
+
+  Remarks:
+    None.
+*/
+typedef enum {
+    PAL_PLC_SNIFFER_EVENT_TX_CFM = 0,
+    PAL_PLC_SNIFFER_EVENT_RX_IND,
+} PAL_PLC_SNIFFER_EVENT;
+
+// *****************************************************************************
+/* PAL PLC Sniffer Queue Entry
+
+  Summary:
+    Raw information of a PLC frame pending of being reported to the sniffer.
+
+  Description:
+    This structure contains a copy of the PLC driver objects and of the frame
+    data, captured from the PLC driver callbacks. Pointers to data inside the
+    driver objects are updated to point to the local copy when serialized.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    /* Transmission object (only for PAL_PLC_SNIFFER_EVENT_TX_CFM) */
+    DRV_PLC_PHY_TRANSMISSION_OBJ txObj;
+    /* Transmission confirm object (only for PAL_PLC_SNIFFER_EVENT_TX_CFM) */
+    DRV_PLC_PHY_TRANSMISSION_CFM_OBJ cfmObj;
+    /* Reception object (only for PAL_PLC_SNIFFER_EVENT_RX_IND) */
+    DRV_PLC_PHY_RECEPTION_OBJ indObj;
+    /* Type of event */
+    PAL_PLC_SNIFFER_EVENT event;
+    /* PLC channel used in the transmission or reception */
+    DRV_PLC_PHY_CHANNEL channel;
+    /* Copy of the transmitted or received data */
+    uint8_t data[PAL_PLC_SNIFFER_MAX_DATA_SIZE];
+} PAL_PLC_SNIFFER_ENTRY;
+
+</#if>
 // *****************************************************************************
 /* PAL PLC Data
 
@@ -160,12 +340,16 @@ typedef struct
 
     SYS_TIME_HANDLE syncHandle;
 
+    SYS_TIME_HANDLE channelSwitchHandle;
+
     uint32_t hiTimerRef;
 
     uint32_t previousTimerRef;
 
     DRV_PLC_PHY_PIB_OBJ plcPIB;
 
+    DRV_PLC_PHY_PIB_OBJ channelSwitchPIB;
+
     DRV_PLC_PHY_TX_RESULT detectImpedanceResult;
 
     DRV_PLC_PHY_TRANSMISSION_OBJ phyTxObj;
@@ -174,6 +358,8 @@ typedef struct
 
     DRV_PLC_PHY_CHANNEL channel;
 
+    DRV_PLC_PHY_CHANNEL channelSwitchNext;
+
     SYS_STATUS drvPhyStatus;
 
     uint16_t channelList;
@@ -210,6 +396,33 @@ typedef struct
 
     bool networkDetected;
 
+    volatile bool channelSwitchPending;
+
+<#if PRIME_PAL_PLC_ADAPTIVE_CSMA == true>
+    PAL_CSMA_STATUS csmaStatus;
+
+    uint32_t csmaBusyHist;
+
+    uint32_t csmaCollisionHist;
+
+    uint8_t csmaNumSamples;
+
+</#if>
+<#if PRIME_PAL_PLC_CHANNEL_MONITOR == true>
+    PAL_PLC_CHANNEL_STATS channelStats[PAL_PLC_MONITOR_NUM_CHANNELS];
+
+    SYS_TIME_HANDLE monitorHandle;
+
+    uint32_t monitorCfmDeadline;
+
+    uint32_t monitorRxTimeEnd;
+
+    volatile bool monitorUpdate;
+
+</#if>
+
+    PAL_PLC_PIB_CACHE_ENTRY pibCache[PAL_PLC_PIB_CACHE_NUM_ENTRIES];
+
 <#if PRIME_PAL_PHY_SNIFFER == true>
     PAL_USI_SNIFFER_CB snifferCallback;
 
@@ -217,6 +430,14 @@ typedef struct
 
     uint8_t snifferData[PAL_SNIFFER_DATA_MAX_SIZE];
 
+    PAL_PLC_SNIFFER_ENTRY snifferQueue[PAL_PLC_SNIFFER_QUEUE_SIZE];
+
+    uint8_t snifferQueueHead;
+
+    uint8_t snifferQueueTail;
+
+    uint8_t snifferQueueCount;
+
 </#if>
 } PAL_PLC_DATA;
 
@@ -473,6 +473,17 @@ void PAL_RF_Tasks(void)
     }
 }
 
+uint32_t PAL_RF_GetNextDeadline(void)
+{
+    if (palRfCfmData.needsCfm == true)
+    {
+        /* Confirm pending to be reported from PAL_RF_Tasks */
+        return 0;
+    }
+
+    return PAL_DEADLINE_NONE;
+}
+
 void PAL_RF_DataConfirmCallbackRegister(PAL_DATA_CONFIRM_CB callback)
 {
     palRfData.rfCallbacks.dataConfirm = callback;
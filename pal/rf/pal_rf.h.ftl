@@ -63,6 +63,7 @@ extern const PAL_INTERFACE PAL_RF_Interface;
 SYS_MODULE_OBJ PAL_RF_Initialize(void);
 SYS_STATUS PAL_RF_Status(void);
 void PAL_RF_Tasks(void);
+uint32_t PAL_RF_GetNextDeadline(void);
 void PAL_RF_DataConfirmCallbackRegister(PAL_DATA_CONFIRM_CB callback);
 void PAL_RF_DataIndicationCallbackRegister(PAL_DATA_INDICATION_CB callback);
 <#if PRIME_PAL_RF_FREQ_HOPPING == true>
@@ -240,6 +240,12 @@ void PAL_SERIAL_Tasks(void)
     DRV_PHY_SERIAL_Tasks();
 }
 
+uint32_t PAL_SERIAL_GetNextDeadline(void)
+{
+    /* Serial PHY driver is polled from PAL_SERIAL_Tasks */
+    return 0;
+}
+
 void PAL_SERIAL_DataConfirmCallbackRegister(PAL_DATA_CONFIRM_CB callback)
 {
     palSerialData.serialCallbacks.dataConfirm = callback;
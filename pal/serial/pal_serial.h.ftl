@@ -63,6 +63,7 @@ extern const PAL_INTERFACE PAL_SERIAL_Interface;
 SYS_MODULE_OBJ PAL_SERIAL_Initialize(void);
 SYS_STATUS PAL_SERIAL_Status(void);
 void PAL_SERIAL_Tasks(void);
+uint32_t PAL_SERIAL_GetNextDeadline(void);
 void PAL_SERIAL_DataConfirmCallbackRegister(PAL_DATA_CONFIRM_CB callback);
 void PAL_SERIAL_DataIndicationCallbackRegister(PAL_DATA_INDICATION_CB callback);
 uint8_t PAL_SERIAL_DataRequest(PAL_MSG_REQUEST_DATA *requestMsg);
@@ -54,6 +54,10 @@ Microchip or any third party.
 <#if PRIME_MODE == "SN" && PRIME_PROJECT == "application project">
 #include "service/storage/srv_storage.h"
 </#if>
+<#if !(PRIME_MODE == "SN" && PRIME_PROJECT == "bin project")>
+#include "service/time_management/srv_time_management.h"
+#include "stack/pal/pal.h"
+</#if>
 
 // *****************************************************************************
 // *****************************************************************************
@@ -191,6 +195,32 @@ void PRIME_Tasks(SYS_MODULE_OBJ object)
     }
 }
 
+uint32_t PRIME_GetNextDeadline(void)
+{
+<#if PRIME_MODE == "SN" && PRIME_PROJECT == "bin project">
+    /* PAL and time management run in the application project */
+    return 0;
+<#else>
+    uint32_t deadline;
+    uint32_t deadlineTimers;
+
+    if (primeObj.status != PRIME_STATUS_RUNNING)
+    {
+        /* Initialization takes several cycles */
+        return 0;
+    }
+
+    deadline = PAL_GetNextDeadline((SYS_MODULE_OBJ)primeApiInit.palIndex);
+    deadlineTimers = SRV_TIME_MANAGEMENT_GetNextDeadline();
+    if (deadlineTimers < deadline)
+    {
+        deadline = deadlineTimers;
+    }
+
+    return deadline;
+</#if>
+}
+
 void PRIME_Restart(uint32_t *primePtr, uint8_t version)
 {
     /* Set PRIME API pointer */
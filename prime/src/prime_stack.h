@@ -152,6 +152,60 @@ SYS_MODULE_OBJ PRIME_Initialize(const SYS_MODULE_INDEX index,
 */
 void PRIME_Tasks(SYS_MODULE_OBJ object);
 
+// *****************************************************************************
+/* Function:
+    uint32_t PRIME_GetNextDeadline(void)
+
+  Summary:
+    Gets the time until the PRIME Stack needs to run.
+
+  Description:
+    This routine returns how long PRIME_Tasks can be left without being
+    called, so the application can sleep until then (tickless idle). It is
+    the earliest deadline reported by PAL and by the timers of the time
+    management service.
+
+  Precondition:
+    PRIME_Initialize routine must have been called before.
+
+  Parameters:
+    None.
+
+  Returns:
+    Time in microseconds until the next deadline. 0 if PRIME_Tasks must be
+    called as soon as possible. 0xFFFFFFFF if the stack only needs to run
+    after an interrupt.
+
+  Example:
+    <code>
+    while (true)
+    {
+        SYS_Tasks();
+
+        __disable_irq();
+        if (PRIME_GetNextDeadline() > 1000U)
+        {
+            __WFI();
+        }
+        __enable_irq();
+    }
+    </code>
+
+  Remarks:
+    MAC and management plane layers do not report deadlines. Their timers
+    are handled by SYS_TIME, whose interrupt wakes up the CPU from WFI.
+
+    The requests queued in the MAC and management plane are not covered
+    either. PRIME_Tasks must run after every call to a PRIME API before
+    the deadline is checked again, or the returned value must be capped to
+    the MAC tick period.
+
+    Interrupts must be masked (PRIMASK) between the deadline check and WFI,
+    so an interrupt taken in between does not leave work pending while the
+    CPU sleeps. A pending interrupt still wakes up the CPU with PRIMASK set.
+*/
+uint32_t PRIME_GetNextDeadline(void);
+
 // *****************************************************************************
 /* Function:
     void PRIME_Restart
@@ -97,6 +97,48 @@ def instantiateComponent(primeFirmwareUpgradeComponent):
     primeFUBufferReadSize.setDescription("Should be equal or bigger than the block write size")
     primeFUBufferReadSize.setHelp(prime_fu_helpkeyword)
 
+    primeFUBitmap = primeFirmwareUpgradeComponent.createBooleanSymbol("PRIME_FU_BITMAP", None)
+    primeFUBitmap.setLabel("Store bitmap of received pages")
+    primeFUBitmap.setVisible(True)
+    primeFUBitmap.setDefaultValue(False)
+    primeFUBitmap.setDescription("Keep the bitmap of received pages at the end of the Firmware upgrade region, so an interrupted upgrade of the same image (see SRV_FU_SetImageId) is resumed after a reset. The bitmap is only stored when the application sets the image identifier. Bitmap pages are programmed again without erasing them, which is not supported by memories with ECC or write-once pages")
+    primeFUBitmap.setHelp(prime_fu_helpkeyword)
+
+    primeFUReadCache = primeFirmwareUpgradeComponent.createBooleanSymbol("PRIME_FU_READ_CACHE", None)
+    primeFUReadCache.setLabel("Cache image reads")
+    primeFUReadCache.setVisible(True)
+    primeFUReadCache.setDefaultValue(True)
+    primeFUReadCache.setDescription("Keep the last image pages read in a small cache, so pages relayed to several nodes are read once from memory")
+    primeFUReadCache.setHelp(prime_fu_helpkeyword)
+
+    primeFUEraseOnDemand = primeFirmwareUpgradeComponent.createBooleanSymbol("PRIME_FU_ERASE_ON_DEMAND", None)
+    primeFUEraseOnDemand.setLabel("Erase memory on demand")
+    primeFUEraseOnDemand.setVisible(True)
+    primeFUEraseOnDemand.setDefaultValue(True)
+    primeFUEraseOnDemand.setDescription("Erase the blocks of the Firmware upgrade region just ahead of the received data, instead of the whole region when the upgrade starts. Other memory commands wait for each erase to end, so a memory driver queue of one command is enough")
+    primeFUEraseOnDemand.setHelp(prime_fu_helpkeyword)
+
+    primeFUDelta = primeFirmwareUpgradeComponent.createBooleanSymbol("PRIME_FU_DELTA", None)
+    primeFUDelta.setLabel("Support delta images")
+    primeFUDelta.setVisible(True)
+    primeFUDelta.setDefaultValue(False)
+    primeFUDelta.setDescription("Rebuild the new image from a delta image and the image running in the slot to upgrade. Only used in Service Node application projects")
+    primeFUDelta.setHelp(prime_fu_helpkeyword)
+
+    primeFUCompression = primeFirmwareUpgradeComponent.createBooleanSymbol("PRIME_FU_COMPRESSION", None)
+    primeFUCompression.setLabel("Support compressed images")
+    primeFUCompression.setVisible(True)
+    primeFUCompression.setDefaultValue(False)
+    primeFUCompression.setDescription("Decompress images compressed with a LZSS (heatshrink) stream before checking them. Only used in Service Node application projects")
+    primeFUCompression.setHelp(prime_fu_helpkeyword)
+
+    primeFUChunkHash = primeFirmwareUpgradeComponent.createBooleanSymbol("PRIME_FU_CHUNK_HASH", None)
+    primeFUChunkHash.setLabel("Check received chunks with a hash manifest")
+    primeFUChunkHash.setVisible(True)
+    primeFUChunkHash.setDefaultValue(False)
+    primeFUChunkHash.setDescription("Check each received chunk of the image against a signed manifest of chunk hashes, so only corrupted pages are received again. Only used in Service Node application projects")
+    primeFUChunkHash.setHelp(prime_fu_helpkeyword)
+
     ############################################################################
     #### Code Generation ####
     ############################################################################
@@ -66,6 +66,11 @@ Microchip or any third party.
 </#if>
 </#if>
 
+<#assign PRIME_FU_REBUILD = false>
+<#if (PRIME_FU_DELTA == true) || (PRIME_FU_COMPRESSION == true)>
+    <#assign PRIME_FU_REBUILD = true>
+</#if>
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Macro definitions
@@ -79,6 +84,31 @@ Microchip or any third party.
 #define MEMORY_WRITE_SIZE       (uint32_t)(${PRIME_FU_BUFFER_WRITE_SIZE?string})
 #define MAX_BUFFER_READ_SIZE    (uint32_t)(${PRIME_FU_BUFFER_READ_SIZE?string})
 
+/* Segment plus padding of the unaligned first and last blocks */
+#define WRITE_BUFFER_SIZE       (MAX_BUFFER_READ_SIZE + (2U * MEMORY_WRITE_SIZE))
+
+/* Number of segments which can be pending to be written */
+#define WRITE_NUM_SEGMENTS      2U
+<#if PRIME_FU_BITMAP == true>
+
+/* Page bitmap stored at the end of the FU region: header + 1024 bytes */
+#define SRV_FU_BITMAP_AREA_SIZE      1536U
+#define SRV_FU_BITMAP_OFFSET         (uint32_t)sizeof(SRV_FU_BITMAP_HEADER)
+#define SRV_FU_BITMAP_MAX_SIZE       1024U
+#define SRV_FU_BITMAP_MAX_PAGES      (SRV_FU_BITMAP_MAX_SIZE * 8U)
+#define SRV_FU_BITMAP_MAGIC          0x50465542UL
+
+/* Image identifier not set: bitmap is never resumed */
+#define SRV_FU_IMAGE_ID_UNKNOWN      0xFFFFFFFFUL
+</#if>
+<#if PRIME_FU_READ_CACHE == true>
+
+/* Cache of the image read by the PRIME stack */
+#define SRV_FU_READ_CACHE_LINES      4U
+#define SRV_FU_READ_CACHE_LINE_SIZE  256U
+#define SRV_FU_READ_CACHE_NO_LINE    0xFFFFFFFFUL
+</#if>
+
 <#if (prime_config)??>
 <#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
 
@@ -118,6 +148,43 @@ typedef enum
 
 /* Size for a signature ECDSA 256 in bytes */
 #define SIGNATURE_SIZE_ECDSA_256      64
+<#if PRIME_FU_REBUILD == true>
+
+/* Delta image identifier ("PFUD") */
+#define SRV_FU_DELTA_MAGIC            0x44554650UL
+
+/* Size of the delta image header */
+#define SRV_FU_DELTA_HEADER_SIZE      24U
+
+/* Delta image commands */
+#define SRV_FU_DELTA_CMD_COPY         1U
+#define SRV_FU_DELTA_CMD_ADD          2U
+#define SRV_FU_DELTA_CMD_INSERT       3U
+
+/* Size of a command with source offset */
+#define SRV_FU_DELTA_CMD_MAX_SIZE     9U
+</#if>
+<#if PRIME_FU_COMPRESSION == true>
+
+/* Compressed image identifier ("PFUZ") */
+#define SRV_FU_ZIP_MAGIC              0x5A554650UL
+
+/* Size of the compressed image header */
+#define SRV_FU_ZIP_HEADER_SIZE        16U
+
+/* Largest window of the compressed images */
+#define SRV_FU_ZIP_WINDOW_BITS        10U
+#define SRV_FU_ZIP_WINDOW_SIZE        (1UL << SRV_FU_ZIP_WINDOW_BITS)
+#define SRV_FU_ZIP_WINDOW_MASK        (SRV_FU_ZIP_WINDOW_SIZE - 1U)
+</#if>
+<#if PRIME_FU_CHUNK_HASH == true>
+
+/* Chunk hash manifest identifier ("PFUH") */
+#define SRV_FU_MANIFEST_MAGIC         0x48554650UL
+
+/* Size of the chunk hash manifest header */
+#define SRV_FU_MANIFEST_HEADER_SIZE   12U
+</#if>
 </#if>
 </#if>
 
@@ -137,10 +204,27 @@ static SRV_FU_MEM_TRANSFER_CB SRV_FU_MemTransferCallback;
 static SYS_MEDIA_GEOMETRY *nvmGeometry = NULL;
 
 /* NVM Data buffer */
+<#if PRIME_FU_BITMAP == true>
 static CACHE_ALIGN uint8_t pMemWrite[MEMORY_WRITE_SIZE];
 
+</#if>
 static CACHE_ALIGN uint8_t pBuffInput[MAX_BUFFER_READ_SIZE];
 
+/* Pages with unaligned data of SRV_FU_DataRead, not shared with other commands */
+static CACHE_ALIGN uint8_t pBuffRead[MAX_BUFFER_READ_SIZE];
+
+/* Write buffers: a segment is received while the previous one is written */
+static CACHE_ALIGN uint8_t pBuffWrite0[WRITE_BUFFER_SIZE];
+
+static CACHE_ALIGN uint8_t pBuffWrite1[WRITE_BUFFER_SIZE];
+
+static SRV_FU_WRITE_SEGMENT writeSegments[WRITE_NUM_SEGMENTS];
+
+/* Segment being written and number of segments pending */
+static uint8_t writeIndex;
+
+static uint8_t writeCount;
+
 static CACHE_ALIGN SRV_FU_MEM_INFO memInfo;
 
 static SRV_FU_INFO fuData;
@@ -153,8 +237,114 @@ static uint32_t crcSize;
 
 static uint32_t crcRemainingSize;
 
+/* Position of the CRC data in the input buffer */
+static uint32_t crcReadOffset;
+
 static uint32_t calculatedCrc;
 
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+/* Memory erased from the start of the FU region up to this address */
+static uint32_t eraseEnd;
+
+/* End of the memory to erase for the image */
+static uint32_t eraseLimit;
+
+/* Erase in progress ahead of the received data */
+static DRV_MEMORY_COMMAND_HANDLE eraseAheadHandle;
+
+static uint32_t eraseAheadEnd;
+
+static bool eraseAheadBusy;
+
+/* Erase of the region waiting for the erase ahead of the previous upgrade */
+static bool eraseRegionPending;
+
+/* End of the highest segment received */
+static uint32_t writeHighAddress;
+
+</#if>
+/* CRC (and hash) of the image prefix written in order */
+static bool streamValid;
+
+static uint32_t streamOffset;
+
+static uint32_t streamCrc;
+
+/* Image read in progress */
+static uint8_t *readBuffer;
+
+static uint32_t readAddress;
+
+static uint32_t readRemaining;
+
+static bool readBusy;
+
+/* Read started when the command in progress ends */
+static bool readQueued;
+
+static SRV_FU_MEM_TRANSFER_RESULT readResult;
+
+/* Pages read from memory, copied to the buffer when the read ends */
+static uint8_t *readLineData;
+
+static uint32_t readLineAddress;
+
+static uint32_t readLineSize;
+
+<#if PRIME_FU_READ_CACHE == true>
+/* Cache of the last lines read */
+static CACHE_ALIGN uint8_t readCacheData[SRV_FU_READ_CACHE_LINES][SRV_FU_READ_CACHE_LINE_SIZE];
+
+static SRV_FU_READ_CACHE_LINE readCacheLines[SRV_FU_READ_CACHE_LINES];
+
+/* Cache available with the attached memory */
+static bool readCacheEnabled;
+
+/* Line read from memory, if any */
+static uint32_t readCacheFillLine;
+
+static uint32_t readCacheTick;
+
+static uint32_t readCacheHits;
+
+static uint32_t readCacheMisses;
+
+</#if>
+<#if PRIME_FU_BITMAP == true>
+/* Copy in RAM of the page bitmap area. Received pages have their bit cleared */
+static CACHE_ALIGN uint8_t fuBitmapArea[SRV_FU_BITMAP_AREA_SIZE];
+
+static SRV_FU_BITMAP_HEADER fuBitmapHeader;
+
+/* Page bitmap area available in the attached memory */
+static bool fuBitmapEnabled;
+
+/* Page bitmap tracks the image being received */
+static bool fuBitmapValid;
+
+static uint32_t fuBitmapAddress;
+
+static uint32_t fuBitmapNumPages;
+
+static uint32_t fuBitmapNumRxPages;
+
+/* Range of the bitmap area pending to be written to memory */
+static uint32_t fuBitmapWriteStart;
+
+static uint32_t fuBitmapWriteEnd;
+
+/* Command reported when the bitmap area has been written */
+static SRV_FU_MEM_TRANSFER_CMD fuBitmapCmd;
+
+static bool fuBitmapNotify;
+
+/* Bitmap invalidation waiting for the memory to be idle */
+static bool fuBitmapInvalidate;
+
+/* Identifier of the next image, set by the application */
+static uint32_t fuImageId;
+
+</#if>
 
 <#if (prime_config)??>
 <#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
@@ -184,6 +374,118 @@ static uint32_t dsaSize;
 
 static uint32_t dsaRemainingSize;
 
+/* Position of the hash data in the input buffer */
+static uint32_t dsaReadOffset;
+
+static bool streamHashValid;
+
+<#if PRIME_FU_REBUILD == true>
+/* Delta image */
+static SRV_FU_DELTA_HEADER deltaHeader;
+
+static SRV_FU_DELTA_STATE deltaState;
+
+/* Image rebuilt from a delta image */
+static bool deltaValid;
+
+/* CRC and hash computed while writing are the ones of the rebuilt image */
+static bool streamRebuilt;
+
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+/* Verification waiting for the erase ahead to end */
+static bool deltaVerifyPending;
+
+</#if>
+<#if PRIME_FU_DELTA == true>
+/* Image slot the patch is applied to */
+static uint8_t *deltaSource;
+
+static uint32_t deltaSourceOffset;
+
+static uint32_t deltaSourceCrc;
+
+</#if>
+/* Patch data in the input buffer */
+static uint8_t *deltaIn;
+
+static uint32_t deltaReadAddress;
+
+static uint32_t deltaPatchEnd;
+
+static uint32_t deltaInOffset;
+
+static uint32_t deltaInSize;
+
+/* Patch command in progress */
+static uint8_t deltaCmd[SRV_FU_DELTA_CMD_MAX_SIZE];
+
+static uint32_t deltaCmdSize;
+
+static uint32_t deltaLength;
+
+/* Rebuilt image */
+static uint32_t deltaOutAddress;
+
+static uint32_t deltaOutSize;
+
+static uint32_t deltaOutWritten;
+
+static uint32_t deltaOutCount;
+
+static uint32_t deltaFlushSize;
+
+/* Offset of the image in the Firmware Upgrade region */
+static uint32_t imageOffset;
+
+<#if PRIME_FU_COMPRESSION == true>
+/* Compressed image */
+static SRV_FU_ZIP_HEADER zipHeader;
+
+static bool zipValid;
+
+/* Compressed data in the input buffer */
+static uint32_t zipInOffset;
+
+static uint32_t zipInSize;
+
+/* Decoder */
+static SRV_FU_ZIP_STATE zipState;
+
+static uint32_t zipBits;
+
+static uint32_t zipBitCount;
+
+static uint32_t zipCopyDistance;
+
+static uint32_t zipCopyLength;
+
+/* Decompressed data */
+static uint32_t zipOutSize;
+
+static uint32_t zipOutCrc;
+
+static uint32_t zipWindowPos;
+
+static uint8_t zipWindow[SRV_FU_ZIP_WINDOW_SIZE];
+
+</#if>
+</#if>
+<#if PRIME_FU_CHUNK_HASH == true>
+/* Chunk hash manifest */
+static SRV_FU_MANIFEST_HEADER manifestHeader;
+
+/* Chunk hashes, kept in the buffer of the application */
+static uint8_t *manifestHashes;
+
+/* Manifest signature verified */
+static bool manifestValid;
+
+/* Hash of the manifest and of each received chunk */
+static st_Crypto_Hash_Sha_Ctx chunkHashCtx;
+
+static uint8_t chunkDigest[HASH_SIZE_SHA_256];
+
+</#if>
 </#if>
 </#if>
 
@@ -194,7 +496,7 @@ static uint32_t dsaRemainingSize;
 // *****************************************************************************
 <#if (prime_config)??>
 <#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
-static void lSRV_FU_StoreImageInfo(uint32_t address, uint32_t size)
+static void lSRV_FU_StoreImageInfo(uint32_t address, uint8_t *pData, uint32_t size)
 {
     uint32_t iniMetadata, iniSignature;
     uint32_t offsetSegment, offsetMetadata, offsetSignature;
@@ -203,11 +505,11 @@ static void lSRV_FU_StoreImageInfo(uint32_t address, uint32_t size)
     /* The first segment contains the Vendor and Model */
     if (address == 0U)
     {
-        imageVendor = ((uint16_t) pBuffInput[0]) << 8;
-        imageVendor |= pBuffInput[1];
+        imageVendor = ((uint16_t) pData[0]) << 8;
+        imageVendor |= pData[1];
 
-        imageModel = ((uint16_t) pBuffInput[2]) << 8;
-        imageModel |= pBuffInput[3];
+        imageModel = ((uint16_t) pData[2]) << 8;
+        imageModel |= pData[3];
     }
     
     iniMetadata = fuData.imageSize - fuData.signLength - PRIME_METADATA_SIZE;
@@ -247,7 +549,7 @@ static void lSRV_FU_StoreImageInfo(uint32_t address, uint32_t size)
             sizeToCopy = size - offsetSegment;
         }
 
-        (void)memcpy(&imageMetadata[offsetMetadata], &pBuffInput[offsetSegment], sizeToCopy);
+        (void)memcpy(&imageMetadata[offsetMetadata], &pData[offsetSegment], sizeToCopy);
     }
         
     /* Signature */
@@ -283,7 +585,7 @@ static void lSRV_FU_StoreImageInfo(uint32_t address, uint32_t size)
         sizeToCopy = size - offsetSegment;
     }
 
-    (void)memcpy(&imageSignature[offsetSignature], &pBuffInput[offsetSegment], sizeToCopy);
+    (void)memcpy(&imageSignature[offsetSignature], &pData[offsetSegment], sizeToCopy);
 }
 
 static bool lSRV_FU_CheckImageData(void)
@@ -354,202 +656,1724 @@ static bool lSRV_FU_CheckImageData(void)
 
     return true;
 }
-</#if>
-</#if>
+<#if PRIME_FU_CHUNK_HASH == true>
 
-static void lSRV_FU_TransferHandler
-(
-    DRV_MEMORY_EVENT event,
-    DRV_MEMORY_COMMAND_HANDLE commandHandle,
-    uintptr_t context
-)
+static bool lSRV_FU_ManifestCheckChunks(uint32_t address, uint8_t *pData, uint32_t size)
 {
-    SRV_FU_MEM_TRANSFER_RESULT transferResult;
-    SRV_FU_MEM_TRANSFER_CMD transferCmd;
-    SRV_FU_MEM_INFO *mInfo = (SRV_FU_MEM_INFO *)context;
+    uint32_t chunk;
+    uint32_t chunkStart, chunkEnd;
+    uint32_t chunkSize;
+    crypto_Hash_Status_E stateCryptoHash;
 
-    switch(event)
+    if ((manifestValid == false) || (manifestHeader.imageSize != fuData.imageSize))
     {
-        case DRV_MEMORY_EVENT_COMMAND_COMPLETE:
-            transferResult = SRV_FU_MEM_TRANSFER_OK;
-            break;
-
-        case DRV_MEMORY_EVENT_COMMAND_ERROR:
-        default:
-            transferResult = SRV_FU_MEM_TRANSFER_ERROR;
-            break;
+        /* No manifest for this image: checked only at the end */
+        return true;
     }
 
-    if (commandHandle == mInfo->eraseHandle)
-    {
-        memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
-        transferCmd = SRV_FU_MEM_TRANSFER_CMD_ERASE;
-    }
-    else if (commandHandle == mInfo->readHandle)
+    /* Only the chunks fully contained in the segment are checked */
+    chunkSize = manifestHeader.chunkSize;
+    chunk = (address + chunkSize - 1U) / chunkSize;
+    chunkStart = chunk * chunkSize;
+
+    while (chunkStart < fuData.imageSize)
     {
-        if (memInfo.state == SRV_FU_CALCULATE_CRC_BLOCK)
+        chunkEnd = chunkStart + chunkSize;
+        if (chunkEnd > fuData.imageSize)
         {
-            /* Calculating CRC.... no callback*/
-            crcState = SRC_FU_CRC_CALCULATING;
-            return;
+            chunkEnd = fuData.imageSize;
         }
-<#if (prime_config)??>
-<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
-       else if (memInfo.state == SRV_FU_VERIFY_SIGNATURE_BLOCK)
+
+        if (chunkEnd > (address + size))
         {
-            /* Calculating SHA.... no callback*/
-            dsaState = SRV_FU_DSA_CALCULATING;
-            return;
+            break;
         }
-</#if>
-</#if>
-        else
+
+        stateCryptoHash = Crypto_Hash_Sha_Init(&chunkHashCtx, CRYPTO_HASH_SHA2_256,
+            CRYPTO_HANDLER_SW_WOLFCRYPT, SESSION_ID);
+
+        if (stateCryptoHash == CRYPTO_HASH_SUCCESS)
         {
-            memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
-            transferCmd = SRV_FU_MEM_TRANSFER_CMD_READ;
+            stateCryptoHash = Crypto_Hash_Sha_Update(&chunkHashCtx, &pData[chunkStart - address],
+                chunkEnd - chunkStart);
         }
-    }
-    else if (commandHandle == mInfo->writeHandle)
-    {
-        if (transferResult == SRV_FU_MEM_TRANSFER_OK)
+
+        if (stateCryptoHash == CRYPTO_HASH_SUCCESS)
         {
-            /* Continue with next transfer, not callback */
-            memInfo.state = SRV_FU_MEM_STATE_WRITE_ONE_BLOCK;
-            return;
+            stateCryptoHash = Crypto_Hash_Sha_Final(&chunkHashCtx, chunkDigest);
         }
-        else
+
+        if ((stateCryptoHash != CRYPTO_HASH_SUCCESS) ||
+            (memcmp(chunkDigest, &manifestHashes[chunk * HASH_SIZE_SHA_256], HASH_SIZE_SHA_256) != 0))
         {
-            memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
-            transferCmd = SRV_FU_MEM_TRANSFER_CMD_WRITE;
+            return false;
         }
-    }
-    else
-    {
-        memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
-        transferCmd = SRV_FU_MEM_TRANSFER_CMD_BAD;
-    }
 
-    if (SRV_FU_MemTransferCallback != NULL)
-    {
-        SRV_FU_MemTransferCallback(transferCmd, transferResult);
+        chunk++;
+        chunkStart = chunkEnd;
     }
+
+    return true;
 }
+</#if>
+</#if>
+</#if>
 
-static void lSRV_FU_EraseFuRegion(void)
+static void lSRV_FU_ReadEnd(SRV_FU_MEM_TRANSFER_RESULT result)
 {
+    memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
 
-    DRV_MEMORY_AsyncErase(memInfo.memoryHandle, &memInfo.eraseHandle,
-        memInfo.eraseBlockStart, memInfo.numFuRegionEraseBlocks);
-
-	memInfo.state = SRV_FU_MEM_STATE_ERASE_FLASH;
+    if (SRV_FU_MemTransferCallback != NULL)
+    {
+        SRV_FU_MemTransferCallback(SRV_FU_MEM_TRANSFER_CMD_READ, result);
+    }
 }
 
-<#if (prime_config)??>
-<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
-static void lSRV_FU_ConvertDerFormatSignature(void)
+static void lSRV_FU_ReadCopy(uint8_t *pLine, uint32_t lineAddress, uint32_t lineSize)
 {
-    uint8_t index;
-    
-    for (index = 0U; index < 32U; index++)
-    {
-        imageSignature[index] = imageSignature[4U + index];
-    }
+    uint32_t offset;
+    uint32_t copySize;
 
-    for (index = 0U; index < 32U; index++)
+    offset = readAddress - lineAddress;
+    copySize = lineSize - offset;
+    if (copySize > readRemaining)
     {
-        imageSignature[32U + index] = imageSignature[38U + index];
+        copySize = readRemaining;
     }
 
+    (void)memcpy(readBuffer, &pLine[offset], copySize);
+
+    readBuffer = &readBuffer[copySize];
+    readAddress += copySize;
+    readRemaining -= copySize;
 }
 
-static bool lSRV_FU_VerifySignature(void)
+static bool lSRV_FU_ReadPages(uint8_t *pData, uint32_t address, uint32_t size)
 {
-    crypto_Hash_Status_E stateCryptoHash;
-    
-    if (fuData.signAlgorithm == SRV_FU_SIGNATURE_ALGO_NO_SIGNATURE)
-    {
-        /* No need to check any signature, finish checking */
-        SRV_FU_ImageVerifyCallback(SRV_FU_VERIFY_RESULT_SUCCESS);
-        dsaState = SRV_FU_DSA_IDLE;
-        memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+    DRV_MEMORY_AsyncRead(memInfo.memoryHandle, &memInfo.readHandle, pData,
+        address / memInfo.readPageSize, size / memInfo.readPageSize);
 
-        return true;
-    } 
-    
-    if (fuData.signAlgorithm != SRV_FU_SIGNATURE_ALGO_ECDSA256_SHA256)
-    {
-        /* Only ECDSA256_SHA256 is supported */
-        return false;
-    } 
-    
-    if (dsaState != SRV_FU_DSA_IDLE)
+    if (DRV_MEMORY_COMMAND_HANDLE_INVALID == memInfo.readHandle)
     {
-        /* DSA state machine not idle */
         return false;
-    } 
-    
-    /* Check if signature comes in DER format */
-    if (fuData.signLength == 70UL) {
-        lSRV_FU_ConvertDerFormatSignature();
     }
-    
-    /* Start to verify the signature */
-    stateCryptoHash = Crypto_Hash_Sha_Init(&hashCtx, CRYPTO_HASH_SHA2_256, CRYPTO_HANDLER_SW_WOLFCRYPT, SESSION_ID);
 
-    if (stateCryptoHash != CRYPTO_HASH_SUCCESS)
-    {
-        return false;
-    }
-    else
-    {
-        uint32_t blockStart, nBlock;
-        uint32_t bytesPagesRead;
+    readBusy = true;
 
-    	dsaState = SRV_FU_DSA_WAIT_READ_BLOCK;
+    return true;
+}
 
-        dsaReadAddress = memInfo.startAdressFuRegion;
-        dsaRemainingSize = fuData.imageSize - fuData.signLength;
+<#if PRIME_FU_READ_CACHE == true>
+static void lSRV_FU_ReadCacheInvalidate(uint32_t start, uint32_t end)
+{
+    uint32_t line;
 
-        if (dsaRemainingSize < MAX_BUFFER_READ_SIZE)
+    /* Also the line being read, so it is not stored when the read ends */
+    for (line = 0; line < SRV_FU_READ_CACHE_LINES; line++)
+    {
+        if ((readCacheLines[line].address < end) &&
+            ((readCacheLines[line].address + SRV_FU_READ_CACHE_LINE_SIZE) > start))
         {
-            dsaSize = dsaRemainingSize;
+            readCacheLines[line].valid = false;
+            readCacheLines[line].address = SRV_FU_READ_CACHE_NO_LINE;
         }
-        else
+    }
+}
+
+static uint32_t lSRV_FU_ReadCacheGetLine(uint32_t lineAddress, bool *hit)
+{
+    uint32_t line;
+    uint32_t victim = 0;
+
+    for (line = 0; line < SRV_FU_READ_CACHE_LINES; line++)
+    {
+        if ((readCacheLines[line].valid == true) && (readCacheLines[line].address == lineAddress))
         {
-            dsaSize = MAX_BUFFER_READ_SIZE;
+            *hit = true;
+            return line;
         }
 
-        blockStart = dsaReadAddress / memInfo.readPageSize;
-        nBlock = dsaSize / memInfo.readPageSize;
-
-        bytesPagesRead = nBlock * memInfo.readPageSize;
-        /* Align SHA size with the readPageSize */
-        if (dsaSize > bytesPagesRead)
+        /* Replace a free line or else the least recently used */
+        if ((readCacheLines[victim].valid == true) &&
+            ((readCacheLines[line].valid == false) ||
+             (readCacheLines[line].lastUse < readCacheLines[victim].lastUse)))
         {
-            if (((nBlock + 1U) * memInfo.readPageSize) <= MAX_BUFFER_READ_SIZE)
+            victim = line;
+        }
+    }
+
+    *hit = false;
+    return victim;
+}
+
+</#if>
+static void lSRV_FU_ReadNext(void)
+{
+    uint32_t lineAddress;
+    uint32_t lineSize;
+    bool readStarted = false;
+<#if PRIME_FU_READ_CACHE == true>
+    uint32_t line;
+    bool hit;
+</#if>
+
+    if (readResult != SRV_FU_MEM_TRANSFER_OK)
+    {
+<#if PRIME_FU_READ_CACHE == true>
+        readCacheFillLine = SRV_FU_READ_CACHE_NO_LINE;
+</#if>
+        lSRV_FU_ReadEnd(readResult);
+        return;
+    }
+
+    if (readLineData != NULL)
+    {
+        /* Pages read from memory */
+<#if PRIME_FU_READ_CACHE == true>
+        if ((readCacheFillLine != SRV_FU_READ_CACHE_NO_LINE) &&
+            (readCacheLines[readCacheFillLine].address == readLineAddress))
+        {
+            readCacheLines[readCacheFillLine].valid = true;
+        }
+
+        readCacheFillLine = SRV_FU_READ_CACHE_NO_LINE;
+</#if>
+        lSRV_FU_ReadCopy(readLineData, readLineAddress, readLineSize);
+        readLineData = NULL;
+    }
+
+    while (readRemaining > 0U)
+    {
+<#if PRIME_FU_READ_CACHE == true>
+        if (readCacheEnabled == true)
+        {
+            lineAddress = (readAddress / SRV_FU_READ_CACHE_LINE_SIZE) * SRV_FU_READ_CACHE_LINE_SIZE;
+            line = lSRV_FU_ReadCacheGetLine(lineAddress, &hit);
+
+            readCacheTick++;
+            readCacheLines[line].lastUse = readCacheTick;
+
+            if (hit == true)
+            {
+                readCacheHits++;
+                lSRV_FU_ReadCopy(readCacheData[line], lineAddress, SRV_FU_READ_CACHE_LINE_SIZE);
+            }
+            else
+            {
+                /* Read the whole line to the cache */
+                readCacheMisses++;
+                readCacheLines[line].valid = false;
+                readCacheLines[line].address = lineAddress;
+                readCacheFillLine = line;
+
+                readLineData = readCacheData[line];
+                readLineAddress = lineAddress;
+                readLineSize = SRV_FU_READ_CACHE_LINE_SIZE;
+                readStarted = lSRV_FU_ReadPages(readLineData, readLineAddress, readLineSize);
+                break;
+            }
+        }
+        else
+</#if>
+        {
+            lineAddress = (readAddress / memInfo.readPageSize) * memInfo.readPageSize;
+
+            if ((readAddress == lineAddress) && ((readRemaining % memInfo.readPageSize) == 0U))
+            {
+                /* Aligned data: read directly to the buffer */
+                readStarted = lSRV_FU_ReadPages(readBuffer, readAddress, readRemaining);
+                if (readStarted == true)
+                {
+                    readRemaining = 0;
+                }
+            }
+            else if (memInfo.readPageSize <= MAX_BUFFER_READ_SIZE)
+            {
+                /* Read the pages with the data through the input buffer */
+                lineSize = readAddress - lineAddress + readRemaining;
+                lineSize = ((lineSize + memInfo.readPageSize - 1U) / memInfo.readPageSize) * memInfo.readPageSize;
+                if (lineSize > MAX_BUFFER_READ_SIZE)
+                {
+                    lineSize = (MAX_BUFFER_READ_SIZE / memInfo.readPageSize) * memInfo.readPageSize;
+                }
+
+                readLineData = pBuffRead;
+                readLineAddress = lineAddress;
+                readLineSize = lineSize;
+                readStarted = lSRV_FU_ReadPages(readLineData, readLineAddress, readLineSize);
+            }
+            else
+            {
+                /* Pages do not fit in the input buffer */
+            }
+
+            break;
+        }
+    }
+
+    if (readStarted == true)
+    {
+        /* Continue when the read ends */
+        return;
+    }
+
+    if (readRemaining > 0U)
+    {
+<#if PRIME_FU_READ_CACHE == true>
+        readCacheFillLine = SRV_FU_READ_CACHE_NO_LINE;
+</#if>
+        readLineData = NULL;
+        lSRV_FU_ReadEnd(SRV_FU_MEM_TRANSFER_ERROR);
+        return;
+    }
+
+    lSRV_FU_ReadEnd(SRV_FU_MEM_TRANSFER_OK);
+}
+
+static void lSRV_FU_WriteSegmentEnd(SRV_FU_MEM_TRANSFER_RESULT result)
+{
+    /* Release the buffer. The next segment, if any, is written from
+     * SRV_FU_MEM_STATE_CMD_WAIT after the queued read */
+    writeIndex = (uint8_t)((writeIndex + 1U) % WRITE_NUM_SEGMENTS);
+    writeCount--;
+
+    memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+
+    if (SRV_FU_MemTransferCallback != NULL)
+    {
+        SRV_FU_MemTransferCallback(SRV_FU_MEM_TRANSFER_CMD_WRITE, result);
+    }
+}
+
+<#if PRIME_FU_BITMAP == true>
+static uint32_t lSRV_FU_BitmapNumPages(uint32_t imageSize, uint8_t pageSize)
+{
+    if (pageSize == 0U)
+    {
+        return 0;
+    }
+
+    return (imageSize + (uint32_t)pageSize - 1U) / (uint32_t)pageSize;
+}
+
+static void lSRV_FU_BitmapCheck(void)
+{
+    uint32_t page;
+    uint8_t bitMask;
+
+    (void)memcpy(&fuBitmapHeader, fuBitmapArea, sizeof(fuBitmapHeader));
+
+    fuBitmapValid = false;
+    fuBitmapNumRxPages = 0;
+
+    if (fuBitmapHeader.magic != SRV_FU_BITMAP_MAGIC)
+    {
+        /* No upgrade in progress */
+        return;
+    }
+
+    fuBitmapNumPages = lSRV_FU_BitmapNumPages(fuBitmapHeader.imageSize, fuBitmapHeader.pageSize);
+    if ((fuBitmapNumPages == 0U) || (fuBitmapNumPages > SRV_FU_BITMAP_MAX_PAGES))
+    {
+        return;
+    }
+
+    /* Count received pages */
+    for (page = 0; page < fuBitmapNumPages; page++)
+    {
+        bitMask = (uint8_t)(1U << (page & 7U));
+        if ((fuBitmapArea[SRV_FU_BITMAP_OFFSET + (page >> 3)] & bitMask) == 0U)
+        {
+            fuBitmapNumRxPages++;
+        }
+    }
+
+    fuBitmapValid = true;
+}
+
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+static uint32_t lSRV_FU_BitmapRxEnd(void)
+{
+    uint32_t page;
+    uint32_t rxEnd;
+
+    /* Pages are written after erasing all blocks below them */
+    for (page = fuBitmapNumPages; page > 0U; page--)
+    {
+        if ((fuBitmapArea[SRV_FU_BITMAP_OFFSET + ((page - 1U) >> 3)] &
+             (uint8_t)(1U << ((page - 1U) & 7U))) == 0U)
+        {
+            break;
+        }
+    }
+
+    rxEnd = page * fuBitmapHeader.pageSize;
+    if (rxEnd > fuBitmapHeader.imageSize)
+    {
+        rxEnd = fuBitmapHeader.imageSize;
+    }
+
+    return rxEnd;
+}
+
+</#if>
+static void lSRV_FU_BitmapMarkPages(uint32_t address, uint32_t size)
+{
+    uint32_t page, lastPage;
+    uint32_t byteIndex;
+    uint8_t bitMask;
+
+    /* Nothing to write by default */
+    fuBitmapWriteStart = 0;
+    fuBitmapWriteEnd = 0;
+
+    if (size == 0U)
+    {
+        return;
+    }
+
+    page = address / fuBitmapHeader.pageSize;
+    lastPage = (address + size - 1U) / fuBitmapHeader.pageSize;
+    if (lastPage >= fuBitmapNumPages)
+    {
+        lastPage = fuBitmapNumPages - 1U;
+    }
+
+    for (; page <= lastPage; page++)
+    {
+        byteIndex = SRV_FU_BITMAP_OFFSET + (page >> 3);
+        bitMask = (uint8_t)(1U << (page & 7U));
+
+        if ((fuBitmapArea[byteIndex] & bitMask) != 0U)
+        {
+            fuBitmapArea[byteIndex] &= (uint8_t)~bitMask;
+            fuBitmapNumRxPages++;
+
+            if (fuBitmapWriteEnd == 0U)
+            {
+                fuBitmapWriteStart = byteIndex;
+            }
+
+            fuBitmapWriteEnd = byteIndex + 1U;
+        }
+    }
+}
+
+static void lSRV_FU_BitmapWrite(uint32_t start, uint32_t end, SRV_FU_MEM_TRANSFER_CMD cmd,
+    bool notify)
+{
+    fuBitmapWriteStart = start;
+    fuBitmapWriteEnd = end;
+    fuBitmapCmd = cmd;
+    fuBitmapNotify = notify;
+
+    memInfo.state = SRV_FU_MEM_STATE_WRITE_BITMAP;
+}
+
+static void lSRV_FU_BitmapWriteEnd(SRV_FU_MEM_TRANSFER_RESULT result)
+{
+    if (fuBitmapCmd == SRV_FU_MEM_TRANSFER_CMD_WRITE)
+    {
+        /* Bitmap of a written segment */
+        lSRV_FU_WriteSegmentEnd(result);
+        return;
+    }
+
+    memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+
+    if ((fuBitmapNotify == true) && (SRV_FU_MemTransferCallback != NULL))
+    {
+        SRV_FU_MemTransferCallback(fuBitmapCmd, result);
+    }
+}
+
+</#if>
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+<#if PRIME_FU_REBUILD == true>
+static void lSRV_FU_DeltaTransferEnd(SRV_FU_MEM_TRANSFER_RESULT result)
+{
+    if (result != SRV_FU_MEM_TRANSFER_OK)
+    {
+        deltaState = SRV_FU_DELTA_ERROR;
+        return;
+    }
+
+    switch (deltaState)
+    {
+        case SRV_FU_DELTA_WAIT_READ_HEADER:
+            deltaState = SRV_FU_DELTA_CHECK_HEADER;
+            break;
+
+        case SRV_FU_DELTA_WAIT_WRITE:
+            deltaState = SRV_FU_DELTA_WRITE_END;
+            break;
+
+        case SRV_FU_DELTA_WAIT_ERASE:
+        case SRV_FU_DELTA_WAIT_READ_BLOCK:
+        default:
+            deltaState = SRV_FU_DELTA_APPLYING;
+            break;
+    }
+}
+
+</#if>
+</#if>
+</#if>
+static void lSRV_FU_TransferHandler
+(
+    DRV_MEMORY_EVENT event,
+    DRV_MEMORY_COMMAND_HANDLE commandHandle,
+    uintptr_t context
+)
+{
+    SRV_FU_MEM_TRANSFER_RESULT transferResult;
+    SRV_FU_MEM_TRANSFER_CMD transferCmd;
+    SRV_FU_MEM_INFO *mInfo = (SRV_FU_MEM_INFO *)context;
+
+    switch(event)
+    {
+        case DRV_MEMORY_EVENT_COMMAND_COMPLETE:
+            transferResult = SRV_FU_MEM_TRANSFER_OK;
+            break;
+
+        case DRV_MEMORY_EVENT_COMMAND_ERROR:
+        default:
+            transferResult = SRV_FU_MEM_TRANSFER_ERROR;
+            break;
+    }
+
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+    if ((eraseAheadBusy == true) && (commandHandle == eraseAheadHandle))
+    {
+        /* Erase ahead of the received data.... no callback */
+        eraseAheadBusy = false;
+<#if PRIME_FU_READ_CACHE == true>
+        lSRV_FU_ReadCacheInvalidate(eraseEnd, eraseAheadEnd);
+</#if>
+        if ((transferResult == SRV_FU_MEM_TRANSFER_OK) && (eraseAheadEnd > eraseEnd))
+        {
+            eraseEnd = eraseAheadEnd;
+        }
+
+        if (memInfo.state == SRV_FU_MEM_STATE_ERASE_AHEAD_WAIT)
+        {
+            if (transferResult == SRV_FU_MEM_TRANSFER_OK)
+            {
+                /* Continue with the segment to write */
+                memInfo.state = SRV_FU_MEM_STATE_WRITE_ONE_BLOCK;
+            }
+            else
+            {
+                lSRV_FU_WriteSegmentEnd(transferResult);
+            }
+        }
+
+        return;
+    }
+
+</#if>
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+<#if PRIME_FU_REBUILD == true>
+    if (memInfo.state == SRV_FU_DELTA_BLOCK)
+    {
+        /* Rebuilding a delta image.... no callback */
+<#if PRIME_FU_READ_CACHE == true>
+        lSRV_FU_ReadCacheInvalidate(0, SRV_FU_READ_CACHE_NO_LINE);
+</#if>
+        lSRV_FU_DeltaTransferEnd(transferResult);
+        return;
+    }
+
+</#if>
+</#if>
+</#if>
+    if (commandHandle == mInfo->eraseHandle)
+    {
+<#if PRIME_FU_READ_CACHE == true>
+        lSRV_FU_ReadCacheInvalidate(0, SRV_FU_READ_CACHE_NO_LINE);
+
+</#if>
+<#if PRIME_FU_BITMAP == true>
+        if ((fuBitmapValid == true) && (transferResult == SRV_FU_MEM_TRANSFER_OK))
+        {
+            /* Store the bitmap header before reporting the erase */
+            lSRV_FU_BitmapWrite(0, SRV_FU_BITMAP_OFFSET, SRV_FU_MEM_TRANSFER_CMD_ERASE, true);
+            return;
+        }
+
+</#if>
+        memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+        transferCmd = SRV_FU_MEM_TRANSFER_CMD_ERASE;
+    }
+    else if (commandHandle == mInfo->readHandle)
+    {
+        if (memInfo.state == SRV_FU_CALCULATE_CRC_BLOCK)
+        {
+            /* Calculating CRC.... no callback*/
+            crcState = SRC_FU_CRC_CALCULATING;
+            return;
+        }
+<#if PRIME_FU_BITMAP == true>
+        else if (memInfo.state == SRV_FU_MEM_STATE_READ_BITMAP)
+        {
+            /* Bitmap read at initialization.... no callback */
+            if (transferResult == SRV_FU_MEM_TRANSFER_OK)
+            {
+                memInfo.state = SRV_FU_MEM_STATE_CHECK_BITMAP;
+            }
+            else
+            {
+                memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+            }
+
+            return;
+        }
+</#if>
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+       else if (memInfo.state == SRV_FU_VERIFY_SIGNATURE_BLOCK)
+        {
+            /* Calculating SHA.... no callback*/
+            dsaState = SRV_FU_DSA_CALCULATING;
+            return;
+        }
+</#if>
+</#if>
+        else if (memInfo.state == SRV_FU_MEM_STATE_READ_MEMORY)
+        {
+            /* Reading image.... callback when all data is copied */
+            readResult = transferResult;
+            readBusy = false;
+            return;
+        }
+        else
+        {
+            memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+            transferCmd = SRV_FU_MEM_TRANSFER_CMD_READ;
+        }
+    }
+    else if (commandHandle == mInfo->writeHandle)
+    {
+<#if PRIME_FU_BITMAP == true>
+        if (memInfo.state == SRV_FU_MEM_STATE_WRITE_BITMAP_WAIT_END)
+        {
+<#if PRIME_FU_READ_CACHE == true>
+            lSRV_FU_ReadCacheInvalidate(fuBitmapAddress, fuBitmapAddress + SRV_FU_BITMAP_AREA_SIZE);
+
+</#if>
+            if (transferResult == SRV_FU_MEM_TRANSFER_OK)
+            {
+                /* Continue with next block of the bitmap */
+                memInfo.state = SRV_FU_MEM_STATE_WRITE_BITMAP;
+            }
+            else
+            {
+                lSRV_FU_BitmapWriteEnd(transferResult);
+            }
+
+            return;
+        }
+
+</#if>
+        if (transferResult == SRV_FU_MEM_TRANSFER_OK)
+        {
+            /* Continue with next transfer, not callback */
+            memInfo.state = SRV_FU_MEM_STATE_WRITE_ONE_BLOCK;
+            return;
+        }
+        else
+        {
+            lSRV_FU_WriteSegmentEnd(transferResult);
+            return;
+        }
+    }
+    else
+    {
+        memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+        transferCmd = SRV_FU_MEM_TRANSFER_CMD_BAD;
+    }
+
+    if (SRV_FU_MemTransferCallback != NULL)
+    {
+        SRV_FU_MemTransferCallback(transferCmd, transferResult);
+    }
+}
+
+static void lSRV_FU_StreamStart(void)
+{
+    streamValid = true;
+    streamOffset = 0;
+    streamCrc = 0;
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+<#if PRIME_FU_REBUILD == true>
+    streamRebuilt = false;
+</#if>
+
+    streamHashValid = false;
+    if (fuData.signAlgorithm == SRV_FU_SIGNATURE_ALGO_ECDSA256_SHA256)
+    {
+        streamHashValid = (Crypto_Hash_Sha_Init(&hashCtx, CRYPTO_HASH_SHA2_256,
+            CRYPTO_HANDLER_SW_WOLFCRYPT, SESSION_ID) == CRYPTO_HASH_SUCCESS);
+    }
+</#if>
+</#if>
+}
+
+static void lSRV_FU_StreamUpdate(uint32_t address, uint8_t *pBuffer, uint32_t size)
+{
+    uint32_t endAddress;
+    uint32_t streamSize;
+    uint8_t *pData;
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+    uint32_t hashEndAddress;
+</#if>
+</#if>
+
+    if (streamValid == false)
+    {
+        return;
+    }
+
+    if (address > streamOffset)
+    {
+        /* Gap in the image: the rest is read from memory at the end */
+        return;
+    }
+
+    endAddress = address + size;
+    if (endAddress > fuData.imageSize)
+    {
+        endAddress = fuData.imageSize;
+    }
+
+    if (endAddress <= streamOffset)
+    {
+        /* Retransmission of data already processed */
+        return;
+    }
+
+    /* Process only the part not processed yet */
+    pData = &pBuffer[streamOffset - address];
+    streamSize = endAddress - streamOffset;
+
+    streamCrc = SRV_PCRC_GetValue(pData, streamSize, PCRC_HT_GENERIC, PCRC_CRC32, streamCrc);
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+
+    /* The signature is not included in the hash */
+    hashEndAddress = fuData.imageSize - fuData.signLength;
+    if ((streamHashValid == true) && (streamOffset < hashEndAddress))
+    {
+        if (endAddress < hashEndAddress)
+        {
+            hashEndAddress = endAddress;
+        }
+
+        if (Crypto_Hash_Sha_Update(&hashCtx, pData, hashEndAddress - streamOffset) != CRYPTO_HASH_SUCCESS)
+        {
+            streamHashValid = false;
+        }
+    }
+</#if>
+</#if>
+
+    streamOffset = endAddress;
+}
+
+static uint32_t lSRV_FU_ReadImageBlock(uint32_t address, uint32_t remainingSize, uint32_t *pOffset)
+{
+    uint32_t offset;
+    uint32_t size;
+    uint32_t nBlock;
+
+    /* Data not aligned with the read pages starts inside the first page */
+    offset = address % memInfo.readPageSize;
+    *pOffset = offset;
+
+    if ((offset + remainingSize) < MAX_BUFFER_READ_SIZE)
+    {
+        size = remainingSize;
+    }
+    else
+    {
+        size = MAX_BUFFER_READ_SIZE - offset;
+    }
+
+    nBlock = (offset + size + memInfo.readPageSize - 1U) / memInfo.readPageSize;
+    if ((nBlock * memInfo.readPageSize) > MAX_BUFFER_READ_SIZE)
+    {
+        /* Cannot read everything, the last page is read next time */
+        nBlock--;
+        if ((nBlock * memInfo.readPageSize) <= offset)
+        {
+            /* Pages do not fit in the input buffer */
+            return 0;
+        }
+
+        size = (nBlock * memInfo.readPageSize) - offset;
+    }
+
+    DRV_MEMORY_AsyncRead(memInfo.memoryHandle, &memInfo.readHandle, pBuffInput,
+        address / memInfo.readPageSize, nBlock);
+
+    return size;
+}
+
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+static void lSRV_FU_EraseInit(uint32_t erasedSize)
+{
+    uint32_t imageEnd;
+
+    /* Round up to erase blocks */
+    imageEnd = ((fuData.imageSize + memInfo.eraseBlockSize - 1U) / memInfo.eraseBlockSize) *
+                memInfo.eraseBlockSize;
+    if (imageEnd > memInfo.sizeFuRegion)
+    {
+        imageEnd = memInfo.sizeFuRegion;
+    }
+
+    eraseEnd = memInfo.startAdressFuRegion +
+               (((erasedSize + memInfo.eraseBlockSize - 1U) / memInfo.eraseBlockSize) *
+                memInfo.eraseBlockSize);
+    eraseLimit = memInfo.startAdressFuRegion + imageEnd;
+    writeHighAddress = eraseEnd;
+}
+
+static bool lSRV_FU_EraseAhead(uint32_t endAddress)
+{
+    uint32_t numBlocks;
+
+    if (endAddress > eraseLimit)
+    {
+        endAddress = eraseLimit;
+    }
+
+    numBlocks = (endAddress - eraseEnd + memInfo.eraseBlockSize - 1U) / memInfo.eraseBlockSize;
+
+    DRV_MEMORY_AsyncErase(memInfo.memoryHandle, &eraseAheadHandle,
+        eraseEnd / memInfo.eraseBlockSize, numBlocks);
+
+    if (DRV_MEMORY_COMMAND_HANDLE_INVALID == eraseAheadHandle)
+    {
+        return false;
+    }
+
+    eraseAheadEnd = eraseEnd + (numBlocks * memInfo.eraseBlockSize);
+    eraseAheadBusy = true;
+
+    return true;
+}
+
+</#if>
+static void lSRV_FU_EraseFuRegion(void)
+{
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+    /* Image blocks are erased ahead of the received data */
+    lSRV_FU_EraseInit(0);
+<#if PRIME_FU_BITMAP == true>
+
+    if (fuBitmapValid == true)
+    {
+        /* Only the bitmap area is erased now */
+        DRV_MEMORY_AsyncErase(memInfo.memoryHandle, &memInfo.eraseHandle,
+            fuBitmapAddress / memInfo.eraseBlockSize,
+            (memInfo.startAdressFuRegion + memInfo.sizeFuRegion - fuBitmapAddress) / memInfo.eraseBlockSize);
+
+        memInfo.state = SRV_FU_MEM_STATE_ERASE_FLASH;
+        return;
+    }
+</#if>
+
+    memInfo.state = SRV_FU_MEM_STATE_ERASE_END;
+<#else>
+
+    DRV_MEMORY_AsyncErase(memInfo.memoryHandle, &memInfo.eraseHandle,
+        memInfo.eraseBlockStart, memInfo.numFuRegionEraseBlocks);
+
+	memInfo.state = SRV_FU_MEM_STATE_ERASE_FLASH;
+</#if>
+}
+
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+static void lSRV_FU_ConvertDerFormatSignature(void)
+{
+    uint8_t index;
+    
+    for (index = 0U; index < 32U; index++)
+    {
+        imageSignature[index] = imageSignature[4U + index];
+    }
+
+    for (index = 0U; index < 32U; index++)
+    {
+        imageSignature[32U + index] = imageSignature[38U + index];
+    }
+
+}
+
+static bool lSRV_FU_VerifySignature(void)
+{
+    crypto_Hash_Status_E stateCryptoHash;
+    uint32_t hashedSize;
+    
+    if (fuData.signAlgorithm == SRV_FU_SIGNATURE_ALGO_NO_SIGNATURE)
+    {
+        /* No need to check any signature, finish checking */
+        SRV_FU_ImageVerifyCallback(SRV_FU_VERIFY_RESULT_SUCCESS);
+        dsaState = SRV_FU_DSA_IDLE;
+        memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+
+        return true;
+    } 
+    
+    if (fuData.signAlgorithm != SRV_FU_SIGNATURE_ALGO_ECDSA256_SHA256)
+    {
+        /* Only ECDSA256_SHA256 is supported */
+        return false;
+    } 
+    
+    if (dsaState != SRV_FU_DSA_IDLE)
+    {
+        /* DSA state machine not idle */
+        return false;
+    } 
+    
+    /* Check if signature comes in DER format */
+    if (fuData.signLength == 70UL) {
+        lSRV_FU_ConvertDerFormatSignature();
+    }
+
+    dsaRemainingSize = fuData.imageSize - fuData.signLength;
+
+    if ((streamValid == true) && (streamHashValid == true))
+    {
+        /* Hash of the prefix computed while writing, read only the rest */
+        streamHashValid = false;
+        if (streamOffset < dsaRemainingSize)
+        {
+            hashedSize = streamOffset;
+        }
+        else
+        {
+            hashedSize = dsaRemainingSize;
+        }
+    }
+    else
+    {
+        stateCryptoHash = Crypto_Hash_Sha_Init(&hashCtx, CRYPTO_HASH_SHA2_256, CRYPTO_HANDLER_SW_WOLFCRYPT, SESSION_ID);
+
+        if (stateCryptoHash != CRYPTO_HASH_SUCCESS)
+        {
+            return false;
+        }
+
+        hashedSize = 0;
+    }
+
+    dsaReadAddress = memInfo.startAdressFuRegion + hashedSize;
+<#if PRIME_FU_REBUILD == true>
+    dsaReadAddress += imageOffset;
+</#if>
+    dsaRemainingSize -= hashedSize;
+
+    /* First block read from SRV_FU_Tasks */
+    dsaState = SRV_FU_DSA_CALCULATING;
+    dsaSize = 0;
+    memInfo.state = SRV_FU_VERIFY_SIGNATURE_BLOCK;
+
+    return true;
+}
+
+static void lSRV_FU_CheckImage(void)
+{
+    if (lSRV_FU_CheckImageData() != true)
+    {
+		/* Wrong Metadata, vendor or model */
+        SRV_FU_ImageVerifyCallback(SRV_FU_VERIFY_RESULT_IMAGE_FAIL);
+
+        return;
+	}
+
+<#if PRIME_FU_REBUILD == true>
+    if ((deltaValid == true) && (deltaHeader.sourceApp != (uint8_t)PRIME_INVALID_APP) &&
+        ((uint8_t)appToFu != deltaHeader.sourceApp))
+    {
+		/* Delta image applied to the slot of another application */
+        SRV_FU_ImageVerifyCallback(SRV_FU_VERIFY_RESULT_IMAGE_FAIL);
+
+        return;
+	}
+
+</#if>
+    if (lSRV_FU_VerifySignature() != true)
+    {
+		/* Wrong signature */
+        SRV_FU_ImageVerifyCallback(SRV_FU_VERIFY_RESULT_SIGNATURE_FAIL);
+	}
+}
+
+<#if PRIME_FU_REBUILD == true>
+static uint32_t lSRV_FU_DeltaGetUint32(uint8_t *pData)
+{
+    return ((uint32_t)pData[0]) | (((uint32_t)pData[1]) << 8) |
+           (((uint32_t)pData[2]) << 16) | (((uint32_t)pData[3]) << 24);
+}
+
+static bool lSRV_FU_DeltaRead(uint32_t *pSize)
+{
+    uint32_t blockStart, nBlock;
+    uint32_t size;
+
+    size = deltaPatchEnd - deltaReadAddress;
+    if (size > MAX_BUFFER_READ_SIZE)
+    {
+        size = MAX_BUFFER_READ_SIZE;
+    }
+
+    blockStart = deltaReadAddress / memInfo.readPageSize;
+    nBlock = (size + memInfo.readPageSize - 1U) / memInfo.readPageSize;
+
+    if ((nBlock * memInfo.readPageSize) > MAX_BUFFER_READ_SIZE)
+    {
+        /* Read only the blocks fitting in the buffer */
+        nBlock--;
+        size = nBlock * memInfo.readPageSize;
+    }
+
+    DRV_MEMORY_AsyncRead(memInfo.memoryHandle, &memInfo.readHandle, pBuffInput, blockStart, nBlock);
+
+    if (DRV_MEMORY_COMMAND_HANDLE_INVALID == memInfo.readHandle)
+    {
+        return false;
+    }
+
+    deltaReadAddress += size;
+    *pSize = size;
+
+    return true;
+}
+<#if PRIME_FU_COMPRESSION == true>
+
+static bool lSRV_FU_ZipStart(void)
+{
+    zipHeader.size = lSRV_FU_DeltaGetUint32(&pBuffInput[4]);
+    zipHeader.crc = lSRV_FU_DeltaGetUint32(&pBuffInput[8]);
+    zipHeader.windowBits = pBuffInput[12];
+    zipHeader.countBits = pBuffInput[13];
+
+    if ((zipHeader.windowBits < 4U) || (zipHeader.windowBits > SRV_FU_ZIP_WINDOW_BITS) ||
+        (zipHeader.countBits < 3U) || (zipHeader.countBits >= zipHeader.windowBits))
+    {
+        return false;
+    }
+
+    /* Compressed data follows the header */
+    zipInSize = deltaInSize;
+    zipInOffset = SRV_FU_ZIP_HEADER_SIZE;
+
+    zipState = SRV_FU_ZIP_TAG;
+    zipBits = 0;
+    zipBitCount = 0;
+    zipCopyLength = 0;
+    zipOutSize = 0;
+    zipOutCrc = 0;
+    zipWindowPos = 0;
+    (void)memset(zipWindow, 0, sizeof(zipWindow));
+
+    /* The rest of the image is taken from the decompressed data */
+    deltaIn = pBuffWrite1;
+    deltaInOffset = 0;
+    deltaInSize = 0;
+    zipValid = true;
+
+    return true;
+}
+
+static bool lSRV_FU_ZipGetBits(uint32_t numBits, uint32_t *pValue)
+{
+    while (zipBitCount < numBits)
+    {
+        if (zipInOffset == zipInSize)
+        {
+            /* Wait for more compressed data */
+            return false;
+        }
+
+        zipBits = (zipBits << 8) | (uint32_t)pBuffInput[zipInOffset];
+        zipInOffset++;
+        zipBitCount += 8U;
+    }
+
+    zipBitCount -= numBits;
+    *pValue = zipBits >> zipBitCount;
+    zipBits &= (1UL << zipBitCount) - 1U;
+
+    return true;
+}
+
+static void lSRV_FU_ZipOutput(uint8_t data)
+{
+    zipWindow[zipWindowPos & SRV_FU_ZIP_WINDOW_MASK] = data;
+    zipWindowPos++;
+
+    deltaIn[deltaInSize] = data;
+    deltaInSize++;
+    zipOutSize++;
+}
+
+static uint32_t lSRV_FU_ZipDecode(void)
+{
+    uint32_t startSize = deltaInSize;
+    uint32_t numBits;
+    uint32_t value;
+
+    /* LZSS bit stream: tag bit, then literal byte or window index and count */
+    while ((deltaInSize < WRITE_BUFFER_SIZE) && (zipOutSize < zipHeader.size))
+    {
+        if (zipState == SRV_FU_ZIP_COPY)
+        {
+            lSRV_FU_ZipOutput(zipWindow[(zipWindowPos - zipCopyDistance) & SRV_FU_ZIP_WINDOW_MASK]);
+
+            zipCopyLength--;
+            if (zipCopyLength == 0U)
+            {
+                zipState = SRV_FU_ZIP_TAG;
+            }
+
+            continue;
+        }
+
+        if (zipState == SRV_FU_ZIP_TAG)
+        {
+            numBits = 1U;
+        }
+        else if (zipState == SRV_FU_ZIP_LITERAL)
+        {
+            numBits = 8U;
+        }
+        else if (zipState == SRV_FU_ZIP_INDEX)
+        {
+            numBits = zipHeader.windowBits;
+        }
+        else
+        {
+            numBits = zipHeader.countBits;
+        }
+
+        if (lSRV_FU_ZipGetBits(numBits, &value) == false)
+        {
+            break;
+        }
+
+        switch (zipState)
+        {
+            case SRV_FU_ZIP_TAG:
+                zipState = (value == 1U) ? SRV_FU_ZIP_LITERAL : SRV_FU_ZIP_INDEX;
+                break;
+
+            case SRV_FU_ZIP_LITERAL:
+                lSRV_FU_ZipOutput((uint8_t)value);
+                zipState = SRV_FU_ZIP_TAG;
+                break;
+
+            case SRV_FU_ZIP_INDEX:
+                zipCopyDistance = value + 1U;
+                zipState = SRV_FU_ZIP_COUNT;
+                break;
+
+            case SRV_FU_ZIP_COUNT:
+            case SRV_FU_ZIP_COPY:
+            default:
+                zipCopyLength = value + 1U;
+                zipState = SRV_FU_ZIP_COPY;
+                break;
+        }
+    }
+
+    if (deltaInSize > startSize)
+    {
+        zipOutCrc = SRV_PCRC_GetValue(&deltaIn[startSize], deltaInSize - startSize,
+            PCRC_HT_GENERIC, PCRC_CRC32, zipOutCrc);
+    }
+
+    return deltaInSize - startSize;
+}
+</#if>
+
+static bool lSRV_FU_DeltaFill(SRV_FU_DELTA_STATE waitState)
+{
+<#if PRIME_FU_COMPRESSION == true>
+    if (zipValid == true)
+    {
+        if (deltaInOffset == deltaInSize)
+        {
+            deltaInOffset = 0;
+            deltaInSize = 0;
+        }
+
+        if (lSRV_FU_ZipDecode() > 0U)
+        {
+            return true;
+        }
+
+        if ((zipOutSize == zipHeader.size) || (deltaReadAddress >= deltaPatchEnd))
+        {
+            /* End of the compressed data */
+            return false;
+        }
+
+        if (lSRV_FU_DeltaRead(&zipInSize) == false)
+        {
+            return false;
+        }
+
+        zipInOffset = 0;
+        deltaState = waitState;
+
+        return true;
+    }
+
+</#if>
+    if ((deltaReadAddress >= deltaPatchEnd) || (lSRV_FU_DeltaRead(&deltaInSize) == false))
+    {
+        return false;
+    }
+
+    deltaInOffset = 0;
+    deltaState = waitState;
+
+    return true;
+}
+
+static bool lSRV_FU_DeltaStart(void)
+{
+    deltaValid = false;
+<#if PRIME_FU_DELTA == true>
+    deltaSourceOffset = 0;
+    deltaSourceCrc = 0;
+</#if>
+<#if PRIME_FU_COMPRESSION == true>
+    zipValid = false;
+</#if>
+    deltaReadAddress = memInfo.startAdressFuRegion;
+    deltaPatchEnd = memInfo.startAdressFuRegion + fuData.imageSize;
+
+    /* Read the header of the image */
+    deltaIn = pBuffInput;
+    deltaInOffset = 0;
+    deltaState = SRV_FU_DELTA_WAIT_READ_HEADER;
+    memInfo.state = SRV_FU_DELTA_BLOCK;
+
+    return lSRV_FU_DeltaRead(&deltaInSize);
+}
+
+static void lSRV_FU_DeltaError(void)
+{
+    /* Back to the transferred image */
+    fuData.imageSize = deltaPatchEnd - memInfo.startAdressFuRegion;
+    streamValid = false;
+    deltaValid = false;
+<#if PRIME_FU_COMPRESSION == true>
+    zipValid = false;
+</#if>
+
+    deltaState = SRV_FU_DELTA_IDLE;
+    memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+
+    SRV_FU_ImageVerifyCallback(SRV_FU_VERIFY_RESULT_IMAGE_FAIL);
+}
+
+static bool lSRV_FU_DeltaCheckOutput(void)
+{
+    uint32_t outputEnd;
+    uint32_t regionEnd;
+
+    if ((deltaHeader.outputSize < (fuData.signLength + PRIME_METADATA_SIZE)) ||
+        (deltaHeader.outputSize > memInfo.sizeFuRegion) ||
+        (memInfo.writePageSize > WRITE_BUFFER_SIZE))
+    {
+        return false;
+    }
+
+    /* The image is rebuilt in the erase blocks after the received image */
+    deltaOutAddress = memInfo.startAdressFuRegion +
+        (((fuData.imageSize + memInfo.eraseBlockSize - 1U) / memInfo.eraseBlockSize) *
+         memInfo.eraseBlockSize);
+    outputEnd = deltaOutAddress +
+        (((deltaHeader.outputSize + memInfo.eraseBlockSize - 1U) / memInfo.eraseBlockSize) *
+         memInfo.eraseBlockSize);
+
+    regionEnd = memInfo.startAdressFuRegion + memInfo.sizeFuRegion;
+<#if PRIME_FU_BITMAP == true>
+    if (fuBitmapEnabled == true)
+    {
+        regionEnd = fuBitmapAddress;
+    }
+</#if>
+
+    return ((outputEnd <= regionEnd) && (outputEnd >= deltaOutAddress));
+}
+<#if PRIME_FU_DELTA == true>
+
+static bool lSRV_FU_DeltaCheckHeader(void)
+{
+    uintptr_t sourceAddress;
+    uint32_t sourceSlotSize;
+
+    deltaHeader.outputSize = lSRV_FU_DeltaGetUint32(&deltaIn[4]);
+    deltaHeader.outputCrc = lSRV_FU_DeltaGetUint32(&deltaIn[8]);
+    deltaHeader.sourceSize = lSRV_FU_DeltaGetUint32(&deltaIn[12]);
+    deltaHeader.sourceCrc = lSRV_FU_DeltaGetUint32(&deltaIn[16]);
+    deltaHeader.sourceApp = deltaIn[20];
+
+    /* The image to upgrade is the source of the patch */
+    if (deltaHeader.sourceApp == (uint8_t)PRIME_MAC13_APP)
+    {
+        sourceAddress = PRIME_MAC13_FLASH_LOCATION;
+        sourceSlotSize = PRIME_MAC13_SIZE;
+    }
+    else if (deltaHeader.sourceApp == (uint8_t)PRIME_MAC14_APP)
+    {
+        sourceAddress = PRIME_MAC14_FLASH_LOCATION;
+        sourceSlotSize = PRIME_MAC14_SIZE;
+    }
+    else if (deltaHeader.sourceApp == (uint8_t)PRIME_PHY_APP)
+    {
+        sourceAddress = PRIME_PHY_FLASH_LOCATION;
+        sourceSlotSize = PRIME_PHY_SIZE;
+    }
+    else if (deltaHeader.sourceApp == (uint8_t)PRIME_MAIN_APP)
+    {
+        sourceAddress = PRIME_APP_FLASH_LOCATION;
+        sourceSlotSize = PRIME_APP_SIZE;
+    }
+    else
+    {
+        return false;
+    }
+
+    if ((deltaHeader.sourceSize > sourceSlotSize) || (lSRV_FU_DeltaCheckOutput() == false))
+    {
+        return false;
+    }
+
+    /* The whole slot is copied from the rebuilt image when swapping */
+    if (sourceSlotSize > (memInfo.startAdressFuRegion + memInfo.sizeFuRegion - deltaOutAddress))
+    {
+        return false;
+    }
+
+    /* The slot is mapped in memory */
+    deltaSource = (uint8_t *)sourceAddress;
+    deltaSourceOffset = 0;
+    deltaSourceCrc = 0;
+    deltaInOffset += SRV_FU_DELTA_HEADER_SIZE;
+
+    return true;
+}
+</#if>
+
+static bool lSRV_FU_DeltaEraseOutput(void)
+{
+    uint32_t numBlocks;
+
+    numBlocks = (deltaHeader.outputSize + memInfo.eraseBlockSize - 1U) / memInfo.eraseBlockSize;
+
+    DRV_MEMORY_AsyncErase(memInfo.memoryHandle, &memInfo.eraseHandle,
+        deltaOutAddress / memInfo.eraseBlockSize, numBlocks);
+
+    if (DRV_MEMORY_COMMAND_HANDLE_INVALID == memInfo.eraseHandle)
+    {
+        return false;
+    }
+
+    /* From now on, hash, metadata and signature are the ones of the rebuilt
+       image. The CRC is still the one of the transferred image */
+    fuData.imageSize = deltaHeader.outputSize;
+    lSRV_FU_StreamStart();
+    streamRebuilt = true;
+
+    deltaCmdSize = 0;
+    deltaLength = 0;
+    deltaOutSize = 0;
+    deltaOutCount = 0;
+    deltaOutWritten = 0;
+    deltaFlushSize = (WRITE_BUFFER_SIZE / memInfo.writePageSize) * memInfo.writePageSize;
+<#if PRIME_FU_COMPRESSION == true>
+
+    if (deltaHeader.sourceApp == (uint8_t)PRIME_INVALID_APP)
+    {
+        /* Compressed image: all the decompressed data is the image */
+        deltaCmd[0] = SRV_FU_DELTA_CMD_INSERT;
+        deltaLength = deltaHeader.outputSize;
+    }
+</#if>
+
+    return true;
+}
+
+<#if PRIME_FU_DELTA == true>
+static bool lSRV_FU_DeltaParseCmd(void)
+{
+    uint32_t cmdSize;
+
+    deltaCmd[deltaCmdSize] = deltaIn[deltaInOffset];
+    deltaCmdSize++;
+    deltaInOffset++;
+
+    if (deltaCmd[0] == SRV_FU_DELTA_CMD_INSERT)
+    {
+        cmdSize = 5U;
+    }
+    else if ((deltaCmd[0] == SRV_FU_DELTA_CMD_COPY) || (deltaCmd[0] == SRV_FU_DELTA_CMD_ADD))
+    {
+        cmdSize = SRV_FU_DELTA_CMD_MAX_SIZE;
+    }
+    else
+    {
+        /* Unknown command */
+        return false;
+    }
+
+    if (deltaCmdSize < cmdSize)
+    {
+        return true;
+    }
+
+    deltaCmdSize = 0;
+    deltaLength = lSRV_FU_DeltaGetUint32(&deltaCmd[1]);
+
+    if ((deltaLength == 0U) || (deltaLength > (deltaHeader.outputSize - deltaOutSize)))
+    {
+        return false;
+    }
+
+    if (cmdSize == SRV_FU_DELTA_CMD_MAX_SIZE)
+    {
+        deltaSourceOffset = lSRV_FU_DeltaGetUint32(&deltaCmd[5]);
+
+        if ((deltaLength > deltaHeader.sourceSize) ||
+            (deltaSourceOffset > (deltaHeader.sourceSize - deltaLength)))
+        {
+            /* Out of the source image */
+            return false;
+        }
+    }
+
+    return true;
+}
+
+</#if>
+static bool lSRV_FU_DeltaApply(void)
+{
+    uint32_t size;
+<#if PRIME_FU_DELTA == true>
+    uint32_t index;
+</#if>
+    uint8_t *pOut;
+    uint8_t *pIn;
+
+    while ((deltaOutCount < deltaFlushSize) && (deltaOutSize < deltaHeader.outputSize))
+    {
+<#if PRIME_FU_DELTA == true>
+        if (deltaLength == 0U)
+        {
+            if (deltaInOffset == deltaInSize)
+            {
+                /* Wait for more patch data */
+                break;
+            }
+
+            if (lSRV_FU_DeltaParseCmd() == false)
+            {
+                return false;
+            }
+
+            continue;
+        }
+
+</#if>
+        size = deltaFlushSize - deltaOutCount;
+        if (size > deltaLength)
+        {
+            size = deltaLength;
+        }
+
+        pOut = &pBuffWrite0[deltaOutCount];
+
+<#if PRIME_FU_DELTA == true>
+        if (deltaCmd[0] == SRV_FU_DELTA_CMD_COPY)
+        {
+            (void)memcpy(pOut, &deltaSource[deltaSourceOffset], size);
+            deltaSourceOffset += size;
+        }
+        else
+</#if>
+        {
+            if (size > (deltaInSize - deltaInOffset))
+            {
+                size = deltaInSize - deltaInOffset;
+            }
+
+            if (size == 0U)
+            {
+                /* Wait for more patch data */
+                break;
+            }
+
+            pIn = &deltaIn[deltaInOffset];
+            deltaInOffset += size;
+
+<#if PRIME_FU_DELTA == true>
+            if (deltaCmd[0] == SRV_FU_DELTA_CMD_ADD)
+            {
+                /* Add the difference to the source image */
+                for (index = 0; index < size; index++)
+                {
+                    pOut[index] = (uint8_t)((uint32_t)deltaSource[deltaSourceOffset + index] + (uint32_t)pIn[index]);
+                }
+
+                deltaSourceOffset += size;
+            }
+            else
+</#if>
+            {
+                (void)memcpy(pOut, pIn, size);
+            }
+        }
+
+        deltaLength -= size;
+        deltaOutCount += size;
+        deltaOutSize += size;
+    }
+
+    return true;
+}
+
+static bool lSRV_FU_DeltaWrite(void)
+{
+    uint32_t nBlock;
+
+    nBlock = (deltaOutCount + memInfo.writePageSize - 1U) / memInfo.writePageSize;
+
+    /* Fill the last block of the image */
+    (void)memset(&pBuffWrite0[deltaOutCount], 0xFF, (nBlock * memInfo.writePageSize) - deltaOutCount);
+
+    DRV_MEMORY_AsyncWrite(memInfo.memoryHandle, &memInfo.writeHandle, pBuffWrite0,
+        (deltaOutAddress + deltaOutWritten) / memInfo.writePageSize, nBlock);
+
+    return (DRV_MEMORY_COMMAND_HANDLE_INVALID != memInfo.writeHandle);
+}
+
+static void lSRV_FU_DeltaTasks(void)
+{
+    switch (deltaState)
+    {
+        case SRV_FU_DELTA_CHECK_HEADER:
+        {
+<#if PRIME_FU_COMPRESSION == true>
+            if ((zipValid == false) && (deltaInSize >= SRV_FU_ZIP_HEADER_SIZE) &&
+                (lSRV_FU_DeltaGetUint32(pBuffInput) == SRV_FU_ZIP_MAGIC))
+            {
+                /* Compressed image: the header is checked on the decompressed data */
+                if (lSRV_FU_ZipStart() == false)
+                {
+                    lSRV_FU_DeltaError();
+                    break;
+                }
+            }
+
+            if ((zipValid == true) && (deltaInSize < SRV_FU_DELTA_HEADER_SIZE) &&
+                (zipOutSize < zipHeader.size))
+            {
+                if (lSRV_FU_DeltaFill(SRV_FU_DELTA_WAIT_READ_HEADER) == false)
+                {
+                    lSRV_FU_DeltaError();
+                }
+
+                break;
+            }
+
+</#if>
+<#if PRIME_FU_DELTA == true>
+            if ((deltaInSize >= SRV_FU_DELTA_HEADER_SIZE) &&
+                (lSRV_FU_DeltaGetUint32(deltaIn) == SRV_FU_DELTA_MAGIC))
+            {
+                if (lSRV_FU_DeltaCheckHeader() == true)
+                {
+                    deltaState = SRV_FU_DELTA_CHECK_SOURCE;
+                }
+                else
+                {
+                    lSRV_FU_DeltaError();
+                }
+
+                break;
+            }
+
+</#if>
+<#if PRIME_FU_COMPRESSION == true>
+            if (zipValid == true)
+            {
+                /* The decompressed data is the image */
+                deltaHeader.outputSize = zipHeader.size;
+                deltaHeader.outputCrc = zipHeader.crc;
+                deltaHeader.sourceSize = 0;
+                deltaHeader.sourceCrc = 0;
+                deltaHeader.sourceApp = (uint8_t)PRIME_INVALID_APP;
+
+                if (lSRV_FU_DeltaCheckOutput() == true)
+                {
+                    deltaState = SRV_FU_DELTA_CHECK_SOURCE;
+                }
+                else
+                {
+                    lSRV_FU_DeltaError();
+                }
+
+                break;
+            }
+
+</#if>
+            /* Not a delta image, check it as received */
+            deltaState = SRV_FU_DELTA_DONE;
+            memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+            lSRV_FU_CheckImage();
+            break;
+        }
+
+        case SRV_FU_DELTA_CHECK_SOURCE:
+        {
+<#if PRIME_FU_DELTA == true>
+            uint32_t size;
+
+            /* Check that the patch applies to the running image */
+            size = deltaHeader.sourceSize - deltaSourceOffset;
+            if (size > MAX_BUFFER_READ_SIZE)
+            {
+                size = MAX_BUFFER_READ_SIZE;
+            }
+
+            if (size > 0U)
+            {
+                deltaSourceCrc = SRV_PCRC_GetValue(&deltaSource[deltaSourceOffset], size,
+                    PCRC_HT_GENERIC, PCRC_CRC32, deltaSourceCrc);
+                deltaSourceOffset += size;
+                break;
+            }
+
+            if (deltaSourceCrc != deltaHeader.sourceCrc)
+            {
+                lSRV_FU_DeltaError();
+                break;
+            }
+
+</#if>
+            if (lSRV_FU_DeltaEraseOutput() == true)
+            {
+                deltaState = SRV_FU_DELTA_WAIT_ERASE;
+            }
+            else
+            {
+                lSRV_FU_DeltaError();
+            }
+
+            break;
+        }
+
+        case SRV_FU_DELTA_APPLYING:
+        {
+            if (lSRV_FU_DeltaApply() == false)
+            {
+                /* Wrong patch */
+                lSRV_FU_DeltaError();
+            }
+            else if ((deltaOutCount == deltaFlushSize) ||
+                     ((deltaOutSize == deltaHeader.outputSize) && (deltaOutCount > 0U)))
+            {
+                if (lSRV_FU_DeltaWrite() == true)
+                {
+                    deltaState = SRV_FU_DELTA_WAIT_WRITE;
+                }
+                else
+                {
+                    lSRV_FU_DeltaError();
+                }
+            }
+            else if (deltaOutSize == deltaHeader.outputSize)
+            {
+<#if PRIME_FU_COMPRESSION == true>
+                if ((zipValid == true) && ((deltaInOffset != deltaInSize) ||
+                    (zipOutSize != zipHeader.size) || (zipOutCrc != zipHeader.crc)))
+                {
+                    /* Decompressed data not fully used */
+                    lSRV_FU_DeltaError();
+                }
+                else
+</#if>
+                if ((streamValid == true) && (streamOffset == deltaHeader.outputSize) &&
+                    (streamCrc == deltaHeader.outputCrc))
+                {
+                    /* Image rebuilt, check it */
+                    imageOffset = deltaOutAddress - memInfo.startAdressFuRegion;
+                    deltaValid = true;
+                    deltaState = SRV_FU_DELTA_DONE;
+                    memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+                    lSRV_FU_CheckImage();
+                }
+                else
+                {
+                    lSRV_FU_DeltaError();
+                }
+            }
+            else if (lSRV_FU_DeltaFill(SRV_FU_DELTA_WAIT_READ_BLOCK) == false)
             {
-                nBlock++;
+                /* Truncated patch */
+                lSRV_FU_DeltaError();
             }
             else
             {
-                /* Cannot read everything, we reduced the size of the Crc calculated
-                this time */
-                dsaSize = bytesPagesRead;
+                /* Continue with more patch data */
             }
+
+            break;
         }
 
-        DRV_MEMORY_AsyncRead(memInfo.memoryHandle, &memInfo.readHandle, pBuffInput, blockStart, nBlock);
+        case SRV_FU_DELTA_WRITE_END:
+        {
+            lSRV_FU_StreamUpdate(deltaOutWritten, pBuffWrite0, deltaOutCount);
+            lSRV_FU_StoreImageInfo(deltaOutWritten, pBuffWrite0, deltaOutCount);
 
-        dsaReadAddress += dsaSize;
-        dsaRemainingSize -= dsaSize;
+            deltaOutWritten += deltaOutCount;
+            deltaOutCount = 0;
+            deltaState = SRV_FU_DELTA_APPLYING;
+            break;
+        }
 
-        memInfo.state = SRV_FU_VERIFY_SIGNATURE_BLOCK;
+        case SRV_FU_DELTA_ERROR:
+        {
+            lSRV_FU_DeltaError();
+            break;
+        }
 
-        return true;
+        case SRV_FU_DELTA_IDLE:
+        case SRV_FU_DELTA_WAIT_READ_HEADER:
+        case SRV_FU_DELTA_WAIT_ERASE:
+        case SRV_FU_DELTA_WAIT_READ_BLOCK:
+        case SRV_FU_DELTA_WAIT_WRITE:
+        case SRV_FU_DELTA_DONE:
+        default:
+            break;
     }
 }
 </#if>
 </#if>
+</#if>
 
 
 // *****************************************************************************
@@ -569,18 +2393,67 @@ void SRV_FU_Initialize(void)
     memInfo.startAdressFuRegion = 0;
     memInfo.sizeFuRegion = PRIME_FU_MEM_SIZE;
 
+    writeSegments[0].pBuffer = pBuffWrite0;
+    writeSegments[1].pBuffer = pBuffWrite1;
+    writeIndex = 0;
+    writeCount = 0;
+    readBusy = false;
+    readQueued = false;
+    readLineData = NULL;
+<#if PRIME_FU_READ_CACHE == true>
+
+    readCacheEnabled = false;
+    readCacheFillLine = SRV_FU_READ_CACHE_NO_LINE;
+    readCacheTick = 0;
+    readCacheHits = 0;
+    readCacheMisses = 0;
+    lSRV_FU_ReadCacheInvalidate(0, SRV_FU_READ_CACHE_NO_LINE);
+</#if>
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+
+    eraseEnd = 0;
+    eraseLimit = 0;
+    eraseAheadBusy = false;
+    eraseRegionPending = false;
+</#if>
+
 	memInfo.state = SRV_FU_MEM_STATE_OPEN_DRIVER;
 
 <#if (prime_config)??>
 <#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
     dsaState = SRV_FU_DSA_NO_PUBLIC_KEY; 
+<#if PRIME_FU_REBUILD == true>
+    deltaState = SRV_FU_DELTA_IDLE;
+    deltaValid = false;
+    imageOffset = 0;
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+    deltaVerifyPending = false;
+</#if>
+</#if>
+<#if PRIME_FU_CHUNK_HASH == true>
+    manifestValid = false;
+</#if>
 </#if>
 </#if>
+<#if PRIME_FU_BITMAP == true>
+
+    fuBitmapEnabled = false;
+    fuBitmapValid = false;
+    fuBitmapInvalidate = false;
+    fuImageId = SRV_FU_IMAGE_ID_UNKNOWN;
+</#if>
 }
 
 void SRV_FU_Tasks(void)
 {
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+    if (eraseAheadBusy == true)
+    {
+        /* The memory driver may queue only one command: wait for the erase */
+        return;
+    }
 
+</#if>
    /* Check the Firmware upgrade's current state. */
     switch ( memInfo.state )
     {
@@ -611,13 +2484,167 @@ void SRV_FU_Tasks(void)
 
             memInfo.numFuRegionEraseBlocks = (memInfo.sizeFuRegion / nvmGeometry->geometryTable[SYS_MEDIA_GEOMETRY_TABLE_ERASE_ENTRY].blockSize);
 
+            memInfo.eraseBlockSize = nvmGeometry->geometryTable[SYS_MEDIA_GEOMETRY_TABLE_ERASE_ENTRY].blockSize;
+
 			memInfo.writePageSize = nvmGeometry->geometryTable[SYS_MEDIA_GEOMETRY_TABLE_WRITE_ENTRY].blockSize;
 			memInfo.readPageSize = nvmGeometry->geometryTable[SYS_MEDIA_GEOMETRY_TABLE_READ_ENTRY].blockSize;
 
             memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+<#if PRIME_FU_READ_CACHE == true>
+
+            /* Cache lines are read with whole pages inside the memory */
+            readCacheEnabled = (((SRV_FU_READ_CACHE_LINE_SIZE % memInfo.readPageSize) == 0U) &&
+                (((memInfo.startAdressFuRegion + memInfo.sizeFuRegion) % SRV_FU_READ_CACHE_LINE_SIZE) == 0U));
+</#if>
+<#if PRIME_FU_BITMAP == true>
+
+            /* Reserve the last erase blocks of the FU region for the bitmap */
+            {
+                uint32_t eraseSize;
+                uint32_t bitmapSize;
+
+                eraseSize = nvmGeometry->geometryTable[SYS_MEDIA_GEOMETRY_TABLE_ERASE_ENTRY].blockSize;
+                bitmapSize = ((SRV_FU_BITMAP_AREA_SIZE + eraseSize - 1U) / eraseSize) * eraseSize;
+
+                if ((bitmapSize >= memInfo.sizeFuRegion) ||
+                    (memInfo.writePageSize > MEMORY_WRITE_SIZE) ||
+                    ((SRV_FU_BITMAP_AREA_SIZE % memInfo.writePageSize) != 0U) ||
+                    ((SRV_FU_BITMAP_AREA_SIZE % memInfo.readPageSize) != 0U))
+                {
+                    /* Upgrades cannot be resumed with this memory */
+                    break;
+                }
+
+                fuBitmapAddress = memInfo.startAdressFuRegion + memInfo.sizeFuRegion - bitmapSize;
+
+                DRV_MEMORY_AsyncRead(memInfo.memoryHandle, &memInfo.readHandle, fuBitmapArea,
+                    fuBitmapAddress / memInfo.readPageSize, SRV_FU_BITMAP_AREA_SIZE / memInfo.readPageSize);
+
+                if (DRV_MEMORY_COMMAND_HANDLE_INVALID != memInfo.readHandle)
+                {
+                    fuBitmapEnabled = true;
+                    memInfo.state = SRV_FU_MEM_STATE_READ_BITMAP;
+                }
+            }
+</#if>
+            break;
+        }
+<#if PRIME_FU_BITMAP == true>
+
+        case SRV_FU_MEM_STATE_CHECK_BITMAP:
+        {
+            lSRV_FU_BitmapCheck();
+            memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+            break;
+        }
+
+        case SRV_FU_MEM_STATE_WRITE_BITMAP:
+        {
+            uint32_t offset;
+
+            if (fuBitmapWriteStart >= fuBitmapWriteEnd)
+            {
+                lSRV_FU_BitmapWriteEnd(SRV_FU_MEM_TRANSFER_OK);
+                break;
+            }
+
+            /* Write the whole block containing the modified bytes */
+            offset = (fuBitmapWriteStart / memInfo.writePageSize) * memInfo.writePageSize;
+
+            (void)memcpy(pMemWrite, &fuBitmapArea[offset], memInfo.writePageSize);
+
+            DRV_MEMORY_AsyncWrite(memInfo.memoryHandle, &memInfo.writeHandle, pMemWrite,
+                (fuBitmapAddress + offset) / memInfo.writePageSize, 1);
+
+            if (DRV_MEMORY_COMMAND_HANDLE_INVALID == memInfo.writeHandle)
+            {
+                lSRV_FU_BitmapWriteEnd(SRV_FU_MEM_TRANSFER_ERROR);
+            }
+            else
+            {
+                fuBitmapWriteStart = offset + memInfo.writePageSize;
+                memInfo.state = SRV_FU_MEM_STATE_WRITE_BITMAP_WAIT_END;
+            }
+
+            break;
+        }
+</#if>
+
+
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+        case SRV_FU_MEM_STATE_ERASE_END:
+        {
+            memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+
+            if (SRV_FU_MemTransferCallback != NULL)
+            {
+                SRV_FU_MemTransferCallback(SRV_FU_MEM_TRANSFER_CMD_ERASE, SRV_FU_MEM_TRANSFER_OK);
+            }
+
             break;
         }
 
+</#if>
+        case SRV_FU_MEM_STATE_CMD_WAIT:
+        {
+<#if PRIME_FU_BITMAP == true>
+            if (fuBitmapInvalidate == true)
+            {
+                /* Upgrade finished: invalidate the bitmap so it is not resumed */
+                fuBitmapInvalidate = false;
+                lSRV_FU_BitmapWrite(0, sizeof(fuBitmapHeader.magic), SRV_FU_MEM_TRANSFER_CMD_BAD, false);
+                break;
+            }
+
+</#if>
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+            if (eraseRegionPending == true)
+            {
+                eraseRegionPending = false;
+                lSRV_FU_EraseFuRegion();
+                break;
+            }
+
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+<#if PRIME_FU_REBUILD == true>
+            if (deltaVerifyPending == true)
+            {
+                deltaVerifyPending = false;
+                SRV_FU_VerifyImage();
+                break;
+            }
+
+</#if>
+</#if>
+</#if>
+</#if>
+            if (readQueued == true)
+            {
+                /* Read requested while another command was in progress */
+                readQueued = false;
+                memInfo.state = SRV_FU_MEM_STATE_READ_MEMORY;
+                break;
+            }
+
+            if (writeCount > 0U)
+            {
+                /* Segments received while another command was in progress */
+                memInfo.state = SRV_FU_MEM_STATE_WRITE_ONE_BLOCK;
+                break;
+            }
+
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+            /* Keep one block erased ahead of the received data */
+            if ((eraseAheadBusy == false) && (eraseEnd < eraseLimit) &&
+                (eraseEnd < (writeHighAddress + memInfo.eraseBlockSize)))
+            {
+                (void)lSRV_FU_EraseAhead(eraseEnd + 1U);
+            }
+
+</#if>
+            break;
+        }
 
         case SRV_FU_MEM_STATE_ERASE_FLASH:
         {
@@ -636,69 +2663,75 @@ void SRV_FU_Tasks(void)
 
 		case SRV_FU_MEM_STATE_READ_MEMORY:
 		{
-			if (DRV_MEMORY_COMMAND_HANDLE_INVALID == memInfo.readHandle)
-			{
-                memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
-
-                if (SRV_FU_MemTransferCallback != NULL)
-                {
-                    SRV_FU_MemTransferCallback(SRV_FU_MEM_TRANSFER_CMD_READ, SRV_FU_MEM_TRANSFER_ERROR);
-                }
-			}
+            if (readBusy == false)
+            {
+                lSRV_FU_ReadNext();
+            }
 			break;
 		}
 
 		case SRV_FU_MEM_STATE_WRITE_ONE_BLOCK:
 		{
-            uint32_t block;
-            uint32_t offset;
-            uint32_t bytesToCopy;
+            SRV_FU_WRITE_SEGMENT *pSegment = &writeSegments[writeIndex];
 
-            if (memInfo.writeSize == 0U)
+            if (pSegment->programmed == true)
             {
-                memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+                lSRV_FU_StreamUpdate(pSegment->address, &pSegment->pBuffer[pSegment->offset],
+                    pSegment->size);
+<#if PRIME_FU_READ_CACHE == true>
+                lSRV_FU_ReadCacheInvalidate(memInfo.startAdressFuRegion + pSegment->address,
+                    memInfo.startAdressFuRegion + pSegment->address + pSegment->size);
+</#if>
 
-                if (SRV_FU_MemTransferCallback != NULL)
+<#if PRIME_FU_BITMAP == true>
+                if (fuBitmapValid == true)
                 {
-                    SRV_FU_MemTransferCallback(SRV_FU_MEM_TRANSFER_CMD_WRITE, SRV_FU_MEM_TRANSFER_OK);
+                    /* Store the received pages before reporting the write */
+                    lSRV_FU_BitmapMarkPages(pSegment->address, pSegment->size);
+                    lSRV_FU_BitmapWrite(fuBitmapWriteStart, fuBitmapWriteEnd,
+                        SRV_FU_MEM_TRANSFER_CMD_WRITE, true);
+                    break;
                 }
 
+</#if>
+                lSRV_FU_WriteSegmentEnd(SRV_FU_MEM_TRANSFER_OK);
                 break;
             }
 
-            block = memInfo.writeAddress / memInfo.writePageSize;
-            memInfo.retrieveAddress = block * memInfo.writePageSize;
-            offset = memInfo.writeAddress - memInfo.retrieveAddress;
-
-            if ((memInfo.writePageSize - offset) < memInfo.writeSize)
-            {
-                bytesToCopy = memInfo.writePageSize - offset;
-            }
-            else
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+            if (((memInfo.startAdressFuRegion + pSegment->address + pSegment->size) > eraseEnd) &&
+                (eraseEnd < eraseLimit))
             {
-                bytesToCopy = memInfo.writeSize;
-            }
+                /* Erase the blocks of the segment before writing it */
+                if (eraseAheadBusy == true)
+                {
+                    memInfo.state = SRV_FU_MEM_STATE_ERASE_AHEAD_WAIT;
+                }
+                else if (lSRV_FU_EraseAhead(memInfo.startAdressFuRegion + pSegment->address + pSegment->size) == true)
+                {
+                    memInfo.state = SRV_FU_MEM_STATE_ERASE_AHEAD_WAIT;
+                }
+                else
+                {
+                    lSRV_FU_WriteSegmentEnd(SRV_FU_MEM_TRANSFER_ERROR);
+                }
 
-            (void)memset( pMemWrite, 0xff, memInfo.writePageSize);
-            (void)memcpy( &pMemWrite[offset], &pBuffInput[memInfo.bytesWritten] , bytesToCopy);
+                break;
+            }
 
-            DRV_MEMORY_AsyncWrite(memInfo.memoryHandle, &memInfo.writeHandle, pMemWrite, block, 1);
+</#if>
+            /* All blocks of the segment in a single transfer */
+            DRV_MEMORY_AsyncWrite(memInfo.memoryHandle, &memInfo.writeHandle, pSegment->pBuffer,
+                (memInfo.startAdressFuRegion + pSegment->address) / memInfo.writePageSize,
+                pSegment->numBlocks);
 
 			if (DRV_MEMORY_COMMAND_HANDLE_INVALID == memInfo.writeHandle)
 			{
-                memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
-
-                if (SRV_FU_MemTransferCallback != NULL)
-                {
-                    SRV_FU_MemTransferCallback(SRV_FU_MEM_TRANSFER_CMD_WRITE, SRV_FU_MEM_TRANSFER_ERROR);
-                }
+                lSRV_FU_WriteSegmentEnd(SRV_FU_MEM_TRANSFER_ERROR);
 			}
             else
             {
-                memInfo.writeAddress += bytesToCopy;
-                memInfo.writeSize -= bytesToCopy;
-                memInfo.bytesWritten += bytesToCopy;
-
+                pSegment->programmed = true;
                 memInfo.state = SRV_FU_MEM_STATE_WRITE_WAIT_END;
             }
 
@@ -709,48 +2742,26 @@ void SRV_FU_Tasks(void)
         {
             if (crcState == SRC_FU_CRC_CALCULATING)
             {
-                calculatedCrc = SRV_PCRC_GetValue(pBuffInput, crcSize, PCRC_HT_GENERIC, PCRC_CRC32,
-                                     calculatedCrc);
+                if (crcSize > 0U)
+                {
+                    calculatedCrc = SRV_PCRC_GetValue(&pBuffInput[crcReadOffset], crcSize, PCRC_HT_GENERIC,
+                                         PCRC_CRC32, calculatedCrc);
+                }
 
                 if (crcRemainingSize > 0U)
                 {
-                    uint32_t blockStart, nBlock;
-                    uint32_t bytesPagesRead;
-
-                    crcState = SRV_FU_CRC_WAIT_READ_BLOCK;
-
-                    if (crcRemainingSize < MAX_BUFFER_READ_SIZE)
-                    {
-                        crcSize = crcRemainingSize;
-                    }
-                    else
+                    crcSize = lSRV_FU_ReadImageBlock(crcReadAddress, crcRemainingSize, &crcReadOffset);
+                    if (crcSize > 0U)
                     {
-                        crcSize = MAX_BUFFER_READ_SIZE;
-                    }
-
-                    blockStart = crcReadAddress / memInfo.readPageSize;
-                    nBlock = crcSize / memInfo.readPageSize;
-
-                    bytesPagesRead = nBlock * memInfo.readPageSize;
-                    /* Align CRC size with the readPageSize */
-                    if (crcSize > bytesPagesRead)
+                        crcState = SRV_FU_CRC_WAIT_READ_BLOCK;
+                        crcReadAddress += crcSize;
+                        crcRemainingSize -= crcSize;
+                    }
+                    else
                     {
-                        if (((nBlock + 1U) * memInfo.readPageSize) <= MAX_BUFFER_READ_SIZE)
-                        {
-                            nBlock++;
-                        }
-                        else
-                        {
-                            /* Cannot read everything, we reduced the size of the Crc calculated
-                            this time */
-                            crcSize = bytesPagesRead;
-                        }
+                        /* Image cannot be read, the CRC reported will not match */
+                        crcRemainingSize = 0;
                     }
-
-                    DRV_MEMORY_AsyncRead(memInfo.memoryHandle, &memInfo.readHandle, pBuffInput, blockStart, nBlock);
-
-                    crcReadAddress += crcSize;
-                    crcRemainingSize -= crcSize;
                 }
                 else
                 {
@@ -775,18 +2786,32 @@ void SRV_FU_Tasks(void)
             {
                 crypto_Hash_Status_E stateCryptoHash;
 
-                if (dsaRemainingSize > 0U)
+                if (dsaSize > 0U)
                 {
-                    stateCryptoHash = Crypto_Hash_Sha_Update(&hashCtx, pBuffInput, dsaSize);
+                    stateCryptoHash = Crypto_Hash_Sha_Update(&hashCtx, &pBuffInput[dsaReadOffset], dsaSize);
                 }
                 else
                 {
-                    stateCryptoHash = Crypto_Hash_Sha_Update(&hashCtx, pBuffInput, dsaSize);
+                    /* Nothing read yet or hash updated while writing the image */
+                    stateCryptoHash = CRYPTO_HASH_SUCCESS;
+                }
+
+                if (dsaRemainingSize > 0U)
+                {
+                    dsaSize = lSRV_FU_ReadImageBlock(dsaReadAddress, dsaRemainingSize, &dsaReadOffset);
+                }
+                else if (stateCryptoHash == CRYPTO_HASH_SUCCESS)
+                {
                     stateCryptoHash = Crypto_Hash_Sha_Final(&hashCtx, hashDigest);
                 }
-                
-                if (stateCryptoHash!= CRYPTO_HASH_SUCCESS)
+                else
+                {
+                    /* Hash failed */
+                }
+
+                if ((stateCryptoHash != CRYPTO_HASH_SUCCESS) || ((dsaRemainingSize > 0U) && (dsaSize == 0U)))
                 {
+                    /* Hash failed or image cannot be read */
                     dsaState = SRV_FU_DSA_IDLE;
                     memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
 
@@ -797,41 +2822,7 @@ void SRV_FU_Tasks(void)
 
                 if (dsaRemainingSize > 0U)
                 {
-                    uint32_t blockStart, nBlock;
-                    uint32_t bytesPagesRead;
-
                     dsaState = SRV_FU_DSA_WAIT_READ_BLOCK;
-
-                    if (dsaRemainingSize < MAX_BUFFER_READ_SIZE)
-                    {
-                        dsaSize = dsaRemainingSize;
-                    }
-                    else
-                    {
-                        dsaSize = MAX_BUFFER_READ_SIZE;
-                    }
-
-                    blockStart = dsaReadAddress / memInfo.readPageSize;
-                    nBlock = dsaSize / memInfo.readPageSize;
-
-                    bytesPagesRead = nBlock * memInfo.readPageSize;
-                    /* Align SHA size with the readPageSize */
-                    if (dsaSize > bytesPagesRead)
-                    {
-                        if (((nBlock + 1U) * memInfo.readPageSize) <= MAX_BUFFER_READ_SIZE)
-                        {
-                            nBlock++;
-                        }
-                        else
-                        {
-                            /* Cannot read everything, we reduced the size of the Crc calculated
-                            this time */
-                            dsaSize = bytesPagesRead;
-                        }
-                    }
-
-                    DRV_MEMORY_AsyncRead(memInfo.memoryHandle, &memInfo.readHandle, pBuffInput, blockStart, nBlock);
-
                     dsaReadAddress += dsaSize;
                     dsaRemainingSize -= dsaSize;
                 }
@@ -870,12 +2861,35 @@ void SRV_FU_Tasks(void)
             break;
         }
 
+</#if>
+</#if>
+        case SRV_FU_DELTA_BLOCK:
+<#if PRIME_FU_REBUILD == true>
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+        {
+            lSRV_FU_DeltaTasks();
+            break;
+        }
+
+</#if>
 </#if>
 </#if>
         case SRV_FU_MEM_STATE_XFER_WAIT:
+        case SRV_FU_MEM_STATE_READ_BITMAP:
+<#if PRIME_FU_BITMAP == false>
+        case SRV_FU_MEM_STATE_CHECK_BITMAP:
+        case SRV_FU_MEM_STATE_WRITE_BITMAP:
+</#if>
+        case SRV_FU_MEM_STATE_WRITE_BITMAP_WAIT_END:
         case SRV_FU_MEM_STATE_SUCCESS:
         case SRV_FU_MEM_STATE_WRITE_WAIT_END:
-        case SRV_FU_MEM_STATE_CMD_WAIT:
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+        case SRV_FU_MEM_STATE_ERASE_AHEAD_WAIT:
+<#else>
+        case SRV_FU_MEM_STATE_ERASE_END:
+        case SRV_FU_MEM_STATE_ERASE_AHEAD_WAIT:
+</#if>
         case SRV_FU_MEM_UNINITIALIZED:
 /* MISRA C-2012 deviation block start */
 /* MISRA C-2012 Rule 16.4 deviated once. Deviation record ID - H3_MISRAC_2012_R_16_4_DR_1 */
@@ -900,21 +2914,57 @@ void SRV_FU_Tasks(void)
 
 void SRV_FU_DataRead(uint32_t address, uint8_t *buffer, uint16_t size)
 {
-	uint32_t readAddress;
-	uint32_t blockStart, nBlock;
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+<#if PRIME_FU_REBUILD == true>
+    if ((deltaState != SRV_FU_DELTA_IDLE) && (deltaState != SRV_FU_DELTA_DONE))
+    {
+        /* Image being rebuilt: memory in use */
+        if (SRV_FU_MemTransferCallback != NULL)
+        {
+            SRV_FU_MemTransferCallback(SRV_FU_MEM_TRANSFER_CMD_READ, SRV_FU_MEM_TRANSFER_ERROR);
+        }
+
+        return;
+    }
 
-	readAddress = memInfo.startAdressFuRegion + address;
+</#if>
+</#if>
+</#if>
+    if ((readQueued == true) || (memInfo.state == SRV_FU_MEM_STATE_READ_MEMORY))
+    {
+        /* Only one read at a time */
+        if (SRV_FU_MemTransferCallback != NULL)
+        {
+            SRV_FU_MemTransferCallback(SRV_FU_MEM_TRANSFER_CMD_READ, SRV_FU_MEM_TRANSFER_ERROR);
+        }
 
-	blockStart = readAddress / memInfo.readPageSize;
-	nBlock = size / memInfo.readPageSize;
+        return;
+    }
 
-	DRV_MEMORY_AsyncRead(memInfo.memoryHandle, &memInfo.readHandle, (void *) buffer, blockStart, nBlock);
+    /* Any address and size: data copied from SRV_FU_Tasks */
+    readBuffer = buffer;
+    readAddress = memInfo.startAdressFuRegion + address;
+    readRemaining = size;
+    readResult = SRV_FU_MEM_TRANSFER_OK;
+    readLineData = NULL;
+    readBusy = false;
 
-	memInfo.state = SRV_FU_MEM_STATE_READ_MEMORY;
+    if (memInfo.state == SRV_FU_MEM_STATE_CMD_WAIT)
+    {
+        memInfo.state = SRV_FU_MEM_STATE_READ_MEMORY;
+    }
+    else
+    {
+        /* Read when the command in progress ends */
+        readQueued = true;
+    }
 }
 
 void SRV_FU_DataWrite(uint32_t address, uint8_t *buffer, uint16_t size)
 {
+    SRV_FU_WRITE_SEGMENT *pSegment;
+    uint32_t bufferSize;
 
     if (size > MAX_BUFFER_READ_SIZE)
     {
@@ -935,19 +2985,80 @@ void SRV_FU_DataWrite(uint32_t address, uint8_t *buffer, uint16_t size)
         return;
     }
 
-    memInfo.writeAddress = memInfo.startAdressFuRegion + address;
-    memInfo.writeSize = size;
-    memInfo.bytesWritten = 0;
+    if (writeCount >= WRITE_NUM_SEGMENTS)
+    {
+        /* Both write buffers in use */
+        if (SRV_FU_MemTransferCallback != NULL)
+        {
+            SRV_FU_MemTransferCallback(SRV_FU_MEM_TRANSFER_CMD_WRITE, SRV_FU_MEM_TRANSFER_ERROR);
+        }
+        return;
+    }
+
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+<#if PRIME_FU_REBUILD == true>
+    if ((deltaState != SRV_FU_DELTA_IDLE) && (deltaState != SRV_FU_DELTA_DONE))
+    {
+        /* Image being rebuilt: write buffers in use */
+        if (SRV_FU_MemTransferCallback != NULL)
+        {
+            SRV_FU_MemTransferCallback(SRV_FU_MEM_TRANSFER_CMD_WRITE, SRV_FU_MEM_TRANSFER_ERROR);
+        }
+
+        return;
+    }
+
+</#if>
+<#if PRIME_FU_CHUNK_HASH == true>
+    if (lSRV_FU_ManifestCheckChunks(address, buffer, size) == false)
+    {
+        /* Corrupted chunk: not stored, so its pages are requested again */
+        if (SRV_FU_MemTransferCallback != NULL)
+        {
+            SRV_FU_MemTransferCallback(SRV_FU_MEM_TRANSFER_CMD_WRITE, SRV_FU_MEM_TRANSFER_ERROR);
+        }
+        return;
+    }
 
-    (void)memcpy(pBuffInput, buffer, size);
+</#if>
+</#if>
+</#if>
+    pSegment = &writeSegments[(writeIndex + writeCount) % WRITE_NUM_SEGMENTS];
+    pSegment->address = address;
+    pSegment->size = size;
+    pSegment->offset = (memInfo.startAdressFuRegion + address) % memInfo.writePageSize;
+    pSegment->numBlocks = (pSegment->offset + size + memInfo.writePageSize - 1U) / memInfo.writePageSize;
+    pSegment->programmed = false;
+
+    /* Only the unaligned first and last blocks need padding */
+    bufferSize = pSegment->numBlocks * memInfo.writePageSize;
+    (void)memset(pSegment->pBuffer, 0xff, pSegment->offset);
+    (void)memcpy(&pSegment->pBuffer[pSegment->offset], buffer, size);
+    (void)memset(&pSegment->pBuffer[pSegment->offset + size], 0xff, bufferSize - pSegment->offset - size);
 
 <#if (prime_config)??>
 <#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
-    lSRV_FU_StoreImageInfo(address, size);
+    lSRV_FU_StoreImageInfo(address, &pSegment->pBuffer[pSegment->offset], size);
 </#if>
 </#if>
 
-    memInfo.state = SRV_FU_MEM_STATE_WRITE_ONE_BLOCK;
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+    if ((memInfo.startAdressFuRegion + address + size) > writeHighAddress)
+    {
+        writeHighAddress = memInfo.startAdressFuRegion + address + size;
+    }
+
+</#if>
+    writeCount++;
+    if ((writeCount == 1U) && (memInfo.state == SRV_FU_MEM_STATE_CMD_WAIT))
+    {
+        memInfo.state = SRV_FU_MEM_STATE_WRITE_ONE_BLOCK;
+    }
+    else
+    {
+        /* Written when the command in progress ends */
+    }
 }
 
 void SRV_FU_CfgRead(void *dst, uint16_t size)
@@ -984,9 +3095,106 @@ void SRV_FU_Start(SRV_FU_INFO *fuInfo)
 	fuData.pageSize = fuInfo->pageSize;
 	fuData.signAlgorithm = fuInfo->signAlgorithm;
 	fuData.signLength = fuInfo->signLength;
+<#if PRIME_FU_READ_CACHE == true>
+
+    lSRV_FU_ReadCacheInvalidate(0, SRV_FU_READ_CACHE_NO_LINE);
+</#if>
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+<#if PRIME_FU_REBUILD == true>
+
+    deltaState = SRV_FU_DELTA_IDLE;
+    deltaValid = false;
+    imageOffset = 0;
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+    deltaVerifyPending = false;
+</#if>
+</#if>
+</#if>
+</#if>
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+<#if PRIME_FU_CHUNK_HASH == true>
+
+    if ((manifestValid == true) &&
+        ((fuInfo->pageSize == 0U) || (((uint32_t)fuInfo->pageSize % manifestHeader.chunkSize) != 0U)))
+    {
+        /* Pages are written one by one: a chunk spanning two pages would
+         * never be checked, so the manifest is rejected */
+        manifestValid = false;
+    }
+</#if>
+</#if>
+</#if>
+<#if PRIME_FU_BITMAP == true>
+
+    /* Bitmap of the previous upgrade is replaced now */
+    fuBitmapInvalidate = false;
+
+    if ((fuBitmapValid == true) && (fuImageId != SRV_FU_IMAGE_ID_UNKNOWN) &&
+        (fuBitmapHeader.imageId == fuImageId) &&
+        (fuBitmapHeader.imageSize == fuInfo->imageSize) &&
+        (fuBitmapHeader.pageSize == fuInfo->pageSize) &&
+        (fuBitmapHeader.signLength == fuInfo->signLength) &&
+        (fuBitmapHeader.signAlgorithm == (uint8_t)fuInfo->signAlgorithm))
+    {
+        /* Same image: keep received pages, report erase as done */
+        lSRV_FU_BitmapWrite(0, 0, SRV_FU_MEM_TRANSFER_CMD_ERASE, true);
+        crcState = SRV_FU_CRC_IDLE;
+
+        /* Stored pages are read from memory to get CRC and hash */
+        streamValid = false;
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+
+        /* Blocks up to the last received page were erased */
+        lSRV_FU_EraseInit(lSRV_FU_BitmapRxEnd());
+</#if>
+        return;
+    }
+
+    fuBitmapValid = false;
+    fuBitmapNumPages = lSRV_FU_BitmapNumPages(fuInfo->imageSize, fuInfo->pageSize);
 
+    /* Without image identifier the upgrade is never resumed: bitmap is not
+     * programmed */
+    if ((fuBitmapEnabled == true) && (fuImageId != SRV_FU_IMAGE_ID_UNKNOWN) &&
+        (fuBitmapNumPages != 0U) && (fuBitmapNumPages <= SRV_FU_BITMAP_MAX_PAGES) &&
+        (fuInfo->imageSize <= (fuBitmapAddress - memInfo.startAdressFuRegion)))
+    {
+        /* New image: bitmap header is written after erasing */
+        fuBitmapHeader.magic = SRV_FU_BITMAP_MAGIC;
+        fuBitmapHeader.imageSize = fuInfo->imageSize;
+        fuBitmapHeader.signLength = fuInfo->signLength;
+        fuBitmapHeader.signAlgorithm = (uint8_t)fuInfo->signAlgorithm;
+        fuBitmapHeader.pageSize = fuInfo->pageSize;
+        fuBitmapHeader.imageId = fuImageId;
+
+        (void)memset(fuBitmapArea, 0xFF, sizeof(fuBitmapArea));
+        (void)memcpy(fuBitmapArea, &fuBitmapHeader, sizeof(fuBitmapHeader));
+
+        fuBitmapNumRxPages = 0;
+        fuBitmapValid = true;
+    }
+</#if>
+
+    /* Compute CRC and hash as the image is written */
+    lSRV_FU_StreamStart();
+
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+    if (eraseAheadBusy == true)
+    {
+        /* Erase ahead of the previous upgrade in progress: erase from SRV_FU_Tasks */
+        eraseRegionPending = true;
+        memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+    }
+    else
+    {
+        lSRV_FU_EraseFuRegion();
+    }
+<#else>
 	/* Erase internal flash pages */
 	lSRV_FU_EraseFuRegion();
+</#if>
 
 	/* Set CRC status */
 	crcState = SRV_FU_CRC_IDLE;
@@ -995,6 +3203,30 @@ void SRV_FU_Start(SRV_FU_INFO *fuInfo)
 
 void SRV_FU_End(SRV_FU_RESULT fuResult)
 {
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+<#if PRIME_FU_CHUNK_HASH == true>
+    /* The manifest only applies to this upgrade */
+    manifestValid = false;
+
+</#if>
+</#if>
+</#if>
+<#if PRIME_FU_BITMAP == true>
+    if (fuBitmapValid == true)
+    {
+        /* Upgrade finished: bitmap is invalidated from SRV_FU_Tasks once
+         * the memory is idle */
+        fuBitmapValid = false;
+        fuBitmapHeader.magic = 0;
+        (void)memcpy(fuBitmapArea, &fuBitmapHeader, sizeof(fuBitmapHeader.magic));
+        fuBitmapInvalidate = true;
+    }
+
+    /* The identifier only applies to this upgrade */
+    fuImageId = SRV_FU_IMAGE_ID_UNKNOWN;
+
+</#if>
 	/* Check callback is initialized */
 	if (SRV_FU_ResultCallback == NULL)
     {
@@ -1032,56 +3264,50 @@ void SRV_FU_End(SRV_FU_RESULT fuResult)
 
 void SRV_FU_CalculateCrc(void)
 {
-	uint32_t blockStart, nBlock;
-    uint32_t bytesPagesRead;
+    bool streamTransfer;
 
 	if (crcState != SRV_FU_CRC_IDLE)
     {
 		return;
 	}
 
-	crcState = SRV_FU_CRC_WAIT_READ_BLOCK;
-
 	crcReadAddress = memInfo.startAdressFuRegion;
     crcRemainingSize = fuData.imageSize;
+    streamTransfer = streamValid;
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+<#if PRIME_FU_REBUILD == true>
 
-	if (crcRemainingSize < MAX_BUFFER_READ_SIZE)
+    if (deltaState != SRV_FU_DELTA_IDLE)
     {
-        crcSize = crcRemainingSize;
+        /* Transferred image, also when an image is rebuilt from it */
+        crcRemainingSize = deltaPatchEnd - memInfo.startAdressFuRegion;
     }
-    else
+
+    if (streamRebuilt == true)
     {
-        crcSize = MAX_BUFFER_READ_SIZE;
+        /* CRC computed while writing is the one of the rebuilt image */
+        streamTransfer = false;
     }
+</#if>
+</#if>
+</#if>
 
-    blockStart = crcReadAddress / memInfo.readPageSize;
-	nBlock = crcSize / memInfo.readPageSize;
+    /* CRC Initial */
+    calculatedCrc = 0;
 
-    bytesPagesRead = nBlock * memInfo.readPageSize;
-    /* Align CRC size with the readPageSize */
-    if (crcSize > bytesPagesRead)
+    if (streamTransfer == true)
     {
-        if (((nBlock + 1U) * memInfo.readPageSize) <= MAX_BUFFER_READ_SIZE)
-        {
-            nBlock++;
-        }
-        else
-        {
-            /* Cannot read everything, we reduced the size of the Crc calculated
-            this time */
-            crcSize = bytesPagesRead;
-        }
+        /* CRC of the prefix computed while writing, read only the rest */
+        crcReadAddress += streamOffset;
+        crcRemainingSize -= streamOffset;
+        calculatedCrc = streamCrc;
     }
 
-	DRV_MEMORY_AsyncRead(memInfo.memoryHandle, &memInfo.readHandle, pBuffInput, blockStart, nBlock);
-
-	crcReadAddress += crcSize;
-    crcRemainingSize -= crcSize;
-
+    /* First block read from SRV_FU_Tasks */
+    crcState = SRC_FU_CRC_CALCULATING;
+    crcSize = 0;
     memInfo.state = SRV_FU_CALCULATE_CRC_BLOCK;
-
-    /* CRC Initial */
-    calculatedCrc = 0;
 }
 
 void SRV_FU_RegisterCallbackCrc(SRV_FU_CRC_CB callback)
@@ -1102,11 +3328,47 @@ void SRV_FU_RegisterCallbackFuResult(SRV_FU_RESULT_CB callback)
 
 uint16_t SRV_FU_GetBitmap(uint8_t *bitmap, uint32_t *numRxPages)
 {
+<#if PRIME_FU_BITMAP == true>
+    uint32_t bitmapSize;
+    uint32_t index;
+
+    if (fuBitmapValid == false)
+    {
+        return 0;
+    }
+
+    /* Bit set for each received page */
+    bitmapSize = (fuBitmapNumPages + 7U) >> 3;
+    for (index = 0; index < bitmapSize; index++)
+    {
+        bitmap[index] = (uint8_t)~fuBitmapArea[SRV_FU_BITMAP_OFFSET + index];
+    }
+
+    *numRxPages = fuBitmapNumRxPages;
+
+    return (uint16_t)bitmapSize;
+<#else>
 	(void)bitmap;
 	(void)numRxPages;
 
 	return 0;
+</#if>
+}
+<#if PRIME_FU_BITMAP == true>
+
+void SRV_FU_SetImageId(uint32_t imageId)
+{
+    fuImageId = imageId;
+}
+</#if>
+<#if PRIME_FU_READ_CACHE == true>
+
+void SRV_FU_GetReadCacheStats(uint32_t *hits, uint32_t *misses)
+{
+    *hits = readCacheHits;
+    *misses = readCacheMisses;
 }
+</#if>
 
 void SRV_FU_RequestSwapVersion(SRV_FU_TRAFFIC_VERSION trafficVersion)
 {
@@ -1183,6 +3445,13 @@ bool SRV_FU_SwapFirmware(void)
     {
         return false;
     }
+<#if PRIME_FU_REBUILD == true>
+    else if ((imageOffset > 0U) && (destSize > (memInfo.sizeFuRegion - imageOffset)))
+    {
+        /* Rebuilt image too close to the end of the region */
+        return false;
+    }
+</#if>
     else{
         /* Update boot configuration */
         SRV_STORAGE_BOOT_CONFIG bootConfig;
@@ -1190,6 +3459,9 @@ bool SRV_FU_SwapFirmware(void)
         if(SRV_STORAGE_GetConfigInfo(SRV_STORAGE_TYPE_BOOT_INFO, (uint8_t)sizeof(bootConfig), &bootConfig))
         {
 	bootConfig.origAddr = DRV_MEMORY_AddressGet(memInfo.memoryHandle);
+<#if PRIME_FU_REBUILD == true>
+            bootConfig.origAddr += imageOffset;
+</#if>
             bootConfig.destAddr = destAddress;
             bootConfig.imgSize = destSize;
             bootConfig.cfgKey = 0;
@@ -1216,6 +3488,80 @@ void SRV_FU_SetECDSAPublicKey(uint8_t *pubKey, uint32_t pubKeyLen)
 
     dsaState = SRV_FU_DSA_IDLE;
 }
+<#if PRIME_FU_CHUNK_HASH == true>
+
+bool SRV_FU_SetManifest(uint8_t *manifest, uint32_t size)
+{
+    uint32_t numChunks;
+    uint32_t hashesSize;
+    crypto_Hash_Status_E stateCryptoHash;
+    crypto_DigiSign_Status_E stateCryptoECDSA;
+    int8_t validDSA = 0;
+
+    manifestValid = false;
+
+    if ((dsaState == SRV_FU_DSA_NO_PUBLIC_KEY) || (size < SRV_FU_MANIFEST_HEADER_SIZE))
+    {
+        return false;
+    }
+
+    (void)memcpy(&manifestHeader, manifest, SRV_FU_MANIFEST_HEADER_SIZE);
+
+    if ((manifestHeader.magic != SRV_FU_MANIFEST_MAGIC) || (manifestHeader.chunkSize == 0U))
+    {
+        return false;
+    }
+
+    /* Header, one hash per chunk and the signature of both */
+    numChunks = (manifestHeader.imageSize + manifestHeader.chunkSize - 1U) / manifestHeader.chunkSize;
+    hashesSize = numChunks * HASH_SIZE_SHA_256;
+    if (size != (SRV_FU_MANIFEST_HEADER_SIZE + hashesSize + SIGNATURE_SIZE_ECDSA_256))
+    {
+        return false;
+    }
+
+    stateCryptoHash = Crypto_Hash_Sha_Init(&chunkHashCtx, CRYPTO_HASH_SHA2_256,
+        CRYPTO_HANDLER_SW_WOLFCRYPT, SESSION_ID);
+
+    if (stateCryptoHash == CRYPTO_HASH_SUCCESS)
+    {
+        stateCryptoHash = Crypto_Hash_Sha_Update(&chunkHashCtx, manifest,
+            SRV_FU_MANIFEST_HEADER_SIZE + hashesSize);
+    }
+
+    if (stateCryptoHash == CRYPTO_HASH_SUCCESS)
+    {
+        stateCryptoHash = Crypto_Hash_Sha_Final(&chunkHashCtx, chunkDigest);
+    }
+
+    if (stateCryptoHash != CRYPTO_HASH_SUCCESS)
+    {
+        return false;
+    }
+
+    /* Signed with the same key as the images */
+    stateCryptoECDSA = Crypto_DigiSign_Ecdsa_Verify(CRYPTO_HANDLER_SW_WOLFCRYPT,
+                                                    chunkDigest,
+                                                    HASH_SIZE_SHA_256,
+                                                    &manifest[SRV_FU_MANIFEST_HEADER_SIZE + hashesSize],
+                                                    SIGNATURE_SIZE_ECDSA_256,
+                                                    ECDSAPublicKey,
+                                                    ECDSAPublicKeyLen,
+                                                    &validDSA,
+                                                    CRYPTO_ECC_CURVE_P256,
+                                                    SESSION_ID);
+
+    if ((validDSA != 1) || (stateCryptoECDSA != CRYPTO_DIGISIGN_SUCCESS))
+    {
+        return false;
+    }
+
+    manifestHashes = &manifest[SRV_FU_MANIFEST_HEADER_SIZE];
+    manifestValid = true;
+
+    return true;
+}
+</#if>
 </#if>
 </#if>
 
@@ -1229,19 +3575,37 @@ void SRV_FU_VerifyImage(void)
 
 <#if (prime_config)??>
 <#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
-    if (lSRV_FU_CheckImageData() != true)
+<#if PRIME_FU_REBUILD == true>
+    if (deltaState == SRV_FU_DELTA_IDLE)
     {
-		/* Wrong Metadata, vendor or model */
-        SRV_FU_ImageVerifyCallback(SRV_FU_VERIFY_RESULT_IMAGE_FAIL);
-        
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+        if (eraseAheadBusy == true)
+        {
+            /* Started from SRV_FU_Tasks when the erase ends */
+            deltaVerifyPending = true;
+            return;
+        }
+
+</#if>
+        /* Rebuild the image if it is a delta image, checked from SRV_FU_Tasks */
+        if (lSRV_FU_DeltaStart() == false)
+        {
+            deltaState = SRV_FU_DELTA_IDLE;
+            memInfo.state = SRV_FU_MEM_STATE_CMD_WAIT;
+            SRV_FU_ImageVerifyCallback(SRV_FU_VERIFY_RESULT_IMAGE_FAIL);
+        }
+
         return;
-	}
-    
-    if (lSRV_FU_VerifySignature() != true)
+    }
+
+    if (deltaState != SRV_FU_DELTA_DONE)
     {
-		/* Wrong signature */
-        SRV_FU_ImageVerifyCallback(SRV_FU_VERIFY_RESULT_SIGNATURE_FAIL);
-	}
+        /* Rebuild in progress */
+        return;
+    }
+
+</#if>
+    lSRV_FU_CheckImage();
 </#if>
 </#if>
 }
@@ -381,6 +381,12 @@ void SRV_FU_Tasks(void);
 
   Remarks:
     This function is called by the PRIME stack.
+<#if PRIME_FU_ERASE_ON_DEMAND == true>
+    The memory used by the image is not erased here: erase blocks are erased
+    in SRV_FU_Tasks just ahead of the data written with SRV_FU_DataWrite.
+    No other memory command is started while one of these erases is in
+    progress, so the memory driver only needs to queue one command.
+</#if>
 */
 void SRV_FU_Start(SRV_FU_INFO *fuInfo);
 
@@ -531,6 +537,50 @@ bool SRV_FU_SwapFirmware(void);
     This function is called by the application.
 */
 void SRV_FU_SetECDSAPublicKey(uint8_t *pubKey, uint32_t pubKeyLen);
+<#if PRIME_FU_CHUNK_HASH == true>
+
+// ****************************************************************************
+/* Function:
+   bool SRV_FU_SetManifest(uint8_t *manifest, uint32_t size)
+
+  Summary:
+    Sets the chunk hash manifest of the image to receive.
+
+  Description:
+    This function sets the manifest with the SHA-256 hash of each chunk of the
+    image to receive. The signature of the manifest is verified once with the
+    ECDSA-256 public key, and then each chunk written with SRV_FU_DataWrite is
+    checked against its hash before storing it.
+
+  Precondition:
+    The SRV_FU_SetECDSAPublicKey function should have been called before
+    calling this function.
+
+  Parameters:
+    manifest    - Pointer to the buffer where the manifest is stored
+    size        - Size of the manifest
+
+  Returns:
+    True if the manifest signature is valid. Otherwise, false.
+
+  Example:
+    <code>
+    if (SRV_FU_SetManifest(manifest, manifestSize) == false)
+    {
+        ... Corrupted chunks detected only when the image is verified
+    }
+    </code>
+
+  Remarks:
+    This function is called by the application, before the image is
+    received. The buffer is not copied, so it must be kept until the upgrade
+    ends. The manifest is discarded by SRV_FU_End, and it is not used if the
+    image size does not match. Chunks are checked as pages are written, so
+    SRV_FU_Start rejects the manifest if the chunk size is not a divisor of
+    the page size of the upgrade.
+*/
+bool SRV_FU_SetManifest(uint8_t *manifest, uint32_t size);
+</#if>
 </#if>
 </#if>
 
@@ -672,7 +722,22 @@ void SRV_FU_RegisterCallbackMemTransfer(SRV_FU_MEM_TRANSFER_CB callback);
     </code>
 
   Remarks:
-    This function is called by the PRIME stack.
+    This function is called by the PRIME stack. Address and size do not need
+    to be aligned to the memory read blocks. The read is reported with the
+    memory transfer callback once all data is in the buffer. A read requested
+    while another memory operation is in progress starts when it ends. Only
+    one read can be pending.
+<#if PRIME_FU_READ_CACHE == true>
+    The last memory lines read are kept in a cache, so data read again, as
+    pages relayed to several nodes, is not read again from memory.
+</#if>
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+<#if (PRIME_FU_DELTA == true) || (PRIME_FU_COMPRESSION == true)>
+    The read fails while an image is being rebuilt from the received image.
+</#if>
+</#if>
+</#if>
 */
 void SRV_FU_DataRead(uint32_t address, uint8_t *buffer, uint16_t size);
 
@@ -705,7 +770,21 @@ void SRV_FU_DataRead(uint32_t address, uint8_t *buffer, uint16_t size);
     </code>
 
   Remarks:
-    This function is called by the PRIME stack.
+    This function is called by the PRIME stack. The data is copied, so the
+    buffer can be reused on return. Up to two segments can be pending to be
+    written; each one is reported with its own memory transfer callback.
+<#if (prime_config)??>
+<#if ((prime_config.PRIME_MODE == "SN") && (prime_config.PRIME_PROJECT == "application project"))>
+<#if PRIME_FU_CHUNK_HASH == true>
+    If a chunk fully contained in the data does not match its hash in the
+    manifest, the data is not stored and the write is reported as failed, so
+    its pages are not marked as received and they are requested again.
+</#if>
+<#if (PRIME_FU_DELTA == true) || (PRIME_FU_COMPRESSION == true)>
+    The write fails while an image is being rebuilt from the received image.
+</#if>
+</#if>
+</#if>
 */
 void SRV_FU_DataWrite(uint32_t address, uint8_t *buffer, uint16_t size);
 
@@ -778,6 +857,10 @@ void SRV_FU_RegisterCallbackCrc(SRV_FU_CRC_CB callback);
 
   Remarks:
     This function is called by the PRIME stack.
+<#if (PRIME_FU_DELTA == true) || (PRIME_FU_COMPRESSION == true)>
+    If an image is rebuilt from the received image, the CRC is still the one
+    of the received image.
+</#if>
 */
 void SRV_FU_CalculateCrc(void);
 
@@ -851,6 +934,15 @@ void SRV_FU_RegisterCallbackVerify(SRV_FU_IMAGE_VERIFY_CB callback);
 
   Remarks:
     This function is called by the PRIME stack.
+<#if PRIME_FU_DELTA == true>
+    If the received image is a delta image, the new image is first rebuilt
+    from it and the image running in the slot to upgrade, and the checks are
+    done on the rebuilt image. The result is reported once the rebuild ends.
+</#if>
+<#if PRIME_FU_COMPRESSION == true>
+    If the received image is compressed, it is decompressed first in the same
+    way.
+</#if>
 */
 void SRV_FU_VerifyImage(void);
 
@@ -864,14 +956,16 @@ void SRV_FU_VerifyImage(void);
 
   Description:
     This function is used to gets the bitmap with the information about the
-    status of each page of the image.
+    status of each page of the image. Bit n of the bitmap (bit n % 8 of byte
+    n / 8) is set if page n has been stored in memory.
 
   Precondition:
     The SRV_FU_Initialize function should have been called before calling this
     function.
 
   Parameters:
-    bitmap        - Pointer to the bitmap information
+    bitmap        - Pointer to the bitmap information. The buffer must hold
+                    1024 bytes, the maximum size of the bitmap
     numRxPages    - Pointer to the number of pages received
 
   Returns:
@@ -887,9 +981,88 @@ void SRV_FU_VerifyImage(void);
     </code>
 
   Remarks:
-    This function is called by the PRIME stack.
+    This function is called by the PRIME stack. The bitmap is stored at the
+    end of the Firmware Upgrade region, so it is kept after a reset and
+    SRV_FU_Start does not erase the region if it is called again with the
+    same image information and image identifier (see SRV_FU_SetImageId).
+    The bitmap is only stored if the image identifier has been set, so 0 is
+    returned otherwise. Images with more than 8192 pages are not tracked and
+    0 is returned too.
 */
 uint16_t SRV_FU_GetBitmap(uint8_t *bitmap, uint32_t *numRxPages);
+<#if PRIME_FU_BITMAP == true>
+
+// ****************************************************************************
+/* Function:
+    void SRV_FU_SetImageId(uint32_t imageId)
+
+  Summary:
+    Sets the identifier of the image to be received.
+
+  Description:
+    This function is used to set an identifier of the image to be received,
+    such as its CRC or version. It is stored with the page bitmap, and an
+    interrupted upgrade is only resumed if the identifier matches.
+
+  Precondition:
+    The SRV_FU_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    imageId       - Identifier of the image
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    SRV_FU_SetImageId(imageCrc);
+    </code>
+
+  Remarks:
+    This function is called by the application before SRV_FU_Start. The
+    identifier is cleared by SRV_FU_End. Without identifier, an image with the
+    same size and signature as the stored one cannot be told apart from it, so
+    the bitmap is not stored and the upgrade is never resumed.
+*/
+void SRV_FU_SetImageId(uint32_t imageId);
+</#if>
+<#if PRIME_FU_READ_CACHE == true>
+
+// ****************************************************************************
+/* Function:
+    void SRV_FU_GetReadCacheStats(uint32_t *hits, uint32_t *misses)
+
+  Summary:
+    Gets the statistics of the image read cache.
+
+  Description:
+    This function is used to get the number of memory lines found in the cache
+    and read from memory by SRV_FU_DataRead since initialization.
+
+  Precondition:
+    The SRV_FU_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    hits      - Pointer to the number of lines found in the cache
+    misses    - Pointer to the number of lines read from memory
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    uint32_t hits, misses;
+
+    SRV_FU_GetReadCacheStats(&hits, &misses);
+    </code>
+
+  Remarks:
+    This function is called by the application.
+*/
+void SRV_FU_GetReadCacheStats(uint32_t *hits, uint32_t *misses);
+</#if>
 
 // ****************************************************************************
 /* Function:
@@ -87,10 +87,10 @@ typedef enum
     /* Get the geometry details */
     SRV_FU_MEM_STATE_GEOMETRY_GET,
 
-    /* Write one block to Memory */
+    /* Write one segment to Memory */
     SRV_FU_MEM_STATE_WRITE_ONE_BLOCK,
     
-    /* Wait end of writing one block to Memory */
+    /* Wait end of writing one segment to Memory */
     SRV_FU_MEM_STATE_WRITE_WAIT_END,
    
     /* Read From Memory */
@@ -99,15 +99,36 @@ typedef enum
     /* Erase Flash */
     SRV_FU_MEM_STATE_ERASE_FLASH,
 
+    /* Report end of erase */
+    SRV_FU_MEM_STATE_ERASE_END,
+
+    /* Wait end of erasing the blocks ahead of the segment to write */
+    SRV_FU_MEM_STATE_ERASE_AHEAD_WAIT,
+
     /* Calculate CRC */
     SRV_FU_CALCULATE_CRC_BLOCK,
        
     /* Verify Signature */
     SRV_FU_VERIFY_SIGNATURE_BLOCK,
+
+    /* Rebuild the image from a delta image */
+    SRV_FU_DELTA_BLOCK,
     
     /* Wait for transfer to complete */
     SRV_FU_MEM_STATE_XFER_WAIT,
 
+    /* Wait end of reading the page bitmap from Memory */
+    SRV_FU_MEM_STATE_READ_BITMAP,
+
+    /* Check the page bitmap read from Memory */
+    SRV_FU_MEM_STATE_CHECK_BITMAP,
+
+    /* Write one block of the page bitmap to Memory */
+    SRV_FU_MEM_STATE_WRITE_BITMAP,
+
+    /* Wait end of writing one block of the page bitmap to Memory */
+    SRV_FU_MEM_STATE_WRITE_BITMAP_WAIT_END,
+
     /* Transfer success */
     SRV_FU_MEM_STATE_SUCCESS,
 
@@ -151,20 +172,109 @@ typedef struct
 
     uint32_t eraseBlockStart;
     uint32_t numFuRegionEraseBlocks;
+    uint32_t eraseBlockSize;
 
     uint32_t writePageSize;
-    uint32_t writeAddress;
-    uint32_t writeSize;
-    uint32_t bytesWritten;
 
-    uint32_t retrieveAddress;
-    
     uint32_t readPageSize;
 
 } SRV_FU_MEM_INFO;
 
 
 
+// *****************************************************************************
+/* Write segment
+
+  Summary:
+    Holds a segment of the image pending to be written
+
+  Description:
+    This structure holds the information of a segment received with
+    SRV_FU_DataWrite. The data is stored in the write buffer at the offset of
+    the segment inside its first memory block, and the rest of the blocks is
+    filled with 0xFF, so the segment is written with a single multi-block
+    transfer.
+
+  Remarks:
+    None.
+ */
+
+typedef struct
+{
+    /* Buffer with the blocks to write */
+    uint8_t *pBuffer;
+
+    /* Address of the segment in the image */
+    uint32_t address;
+
+    /* Size of the segment */
+    uint32_t size;
+
+    /* Offset of the segment data in the buffer */
+    uint32_t offset;
+
+    /* Number of memory blocks to write */
+    uint32_t numBlocks;
+
+    /* Write already requested to the memory driver */
+    bool programmed;
+
+} SRV_FU_WRITE_SEGMENT;
+
+// *****************************************************************************
+/* Read cache line
+
+  Summary:
+    Holds the information of a line of the read cache
+
+  Description:
+    This structure holds the address of the memory pages stored in a line of
+    the cache of the image read with SRV_FU_DataRead.
+
+  Remarks:
+    The least recently used line is replaced on a miss.
+ */
+
+typedef struct
+{
+    /* Memory address of the line */
+    uint32_t address;
+
+    /* Value of the use counter the last time the line was read */
+    uint32_t lastUse;
+
+    /* Line read from memory */
+    bool valid;
+
+} SRV_FU_READ_CACHE_LINE;
+
+// *****************************************************************************
+/* Page bitmap header
+
+  Summary:
+    Header of the page bitmap stored in memory
+
+  Description:
+    This structure identifies the image whose received pages are tracked by the
+    page bitmap stored at the end of the Firmware Upgrade region.
+
+  Remarks:
+    The bitmap follows the header. A received page is marked by clearing its
+    bit, so the bitmap is updated without erasing the memory. The page
+    containing the bit is programmed again over its previous contents, which
+    is not allowed by memories with ECC or programmed only once after erase.
+ */
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t imageSize;
+    uint16_t signLength;
+    uint8_t signAlgorithm;
+    uint8_t pageSize;
+    uint32_t imageId;
+} SRV_FU_BITMAP_HEADER;
+
 // *****************************************************************************
 /* CRC calculation states
 
@@ -205,6 +315,133 @@ typedef enum
   SRV_FU_DSA_CALCULATING
 } SRV_FU_DSA_STATE;
 
+// *****************************************************************************
+/* Delta image header
+
+  Summary:
+    Header of a delta image
+
+  Description:
+    A delta image is a patch that rebuilds the new image from the image running
+    in the slot of the application to upgrade. The header is at the start of
+    the transferred image and it is followed by the patch commands.
+
+  Remarks:
+    Fields are little endian. Each command is a command byte and a 32-bit
+    length. SRV_FU_DELTA_CMD_COPY and SRV_FU_DELTA_CMD_ADD are followed by a
+    32-bit offset in the source image, and SRV_FU_DELTA_CMD_ADD and
+    SRV_FU_DELTA_CMD_INSERT are followed by length bytes of data.
+ */
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t outputSize;
+    uint32_t outputCrc;
+    uint32_t sourceSize;
+    uint32_t sourceCrc;
+    uint8_t sourceApp;
+    uint8_t reserved[3];
+} SRV_FU_DELTA_HEADER;
+
+/* Delta image rebuild states
+
+  Summary:
+    Delta image rebuild states
+
+  Description:
+    States of the rebuild of an image from a delta image
+
+  Remarks:
+    None
+ */
+typedef enum
+{
+  SRV_FU_DELTA_IDLE,
+  SRV_FU_DELTA_WAIT_READ_HEADER,
+  SRV_FU_DELTA_CHECK_HEADER,
+  SRV_FU_DELTA_CHECK_SOURCE,
+  SRV_FU_DELTA_WAIT_ERASE,
+  SRV_FU_DELTA_WAIT_READ_BLOCK,
+  SRV_FU_DELTA_APPLYING,
+  SRV_FU_DELTA_WAIT_WRITE,
+  SRV_FU_DELTA_WRITE_END,
+  SRV_FU_DELTA_ERROR,
+  SRV_FU_DELTA_DONE
+} SRV_FU_DELTA_STATE;
+
+// *****************************************************************************
+/* Compressed image header
+
+  Summary:
+    Header of a compressed image
+
+  Description:
+    A compressed image is an image, or a delta image, compressed with a LZSS
+    stream. The header is at the start of the transferred image and it is
+    followed by the compressed data.
+
+  Remarks:
+    Fields are little endian. The stream is compatible with heatshrink: a tag
+    bit set is followed by a literal byte, and a tag bit cleared by the window
+    index (windowBits) and the count (countBits) of a back reference, both
+    minus one. The window starts filled with zeros.
+ */
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t size;
+    uint32_t crc;
+    uint8_t windowBits;
+    uint8_t countBits;
+    uint8_t reserved[2];
+} SRV_FU_ZIP_HEADER;
+
+/* Compressed data decoder states
+
+  Summary:
+    Compressed data decoder states
+
+  Description:
+    States of the decoder of the compressed data
+
+  Remarks:
+    None
+ */
+typedef enum
+{
+  SRV_FU_ZIP_TAG,
+  SRV_FU_ZIP_LITERAL,
+  SRV_FU_ZIP_INDEX,
+  SRV_FU_ZIP_COUNT,
+  SRV_FU_ZIP_COPY
+} SRV_FU_ZIP_STATE;
+
+// *****************************************************************************
+/* Chunk hash manifest header
+
+  Summary:
+    Header of the chunk hash manifest
+
+  Description:
+    The chunk hash manifest holds the SHA-256 hash of each chunk of an image,
+    so corrupted chunks are detected as they are received. The image is split
+    in chunks of chunkSize bytes; the last one may be shorter.
+
+  Remarks:
+    Fields are little endian. The header is followed by the hash of each chunk
+    and by the ECDSA-256 signature (r and s) of the SHA-256 hash of the header
+    and the chunk hashes.
+ */
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t imageSize;
+    uint32_t chunkSize;
+} SRV_FU_MANIFEST_HEADER;
+
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
 
@@ -53,3 +53,8 @@ def instantiateComponent(primeTimeManagementComponent):
     pTimeMgmtSystemDefFile.setSourcePath("service/time_management/templates/system/definitions.h.ftl")
     pTimeMgmtSystemDefFile.setMarkup(True)
 
+    pTimeMgmtSystemTasksFile = primeTimeManagementComponent.createFileSymbol("SRV_TIME_MANAGEMENT_SYSTEM_TASKS", None)
+    pTimeMgmtSystemTasksFile.setType("STRING")
+    pTimeMgmtSystemTasksFile.setOutputName("core.LIST_SYSTEM_TASKS_C_CALL_LIB_TASKS")
+    pTimeMgmtSystemTasksFile.setSourcePath("service/time_management/templates/system/system_tasks.c.ftl")
+    pTimeMgmtSystemTasksFile.setMarkup(True)
@@ -47,19 +47,79 @@ Microchip or any third party.
 // *****************************************************************************
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include "system/int/sys_int.h"
 #include "system/time/sys_time.h"
 #include "srv_time_management.h"
 
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macro Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Timer wheel: 4 levels of 32 slots, 1 ms tick. Level 0 covers 32 ms and
+   each upper level 32 times the previous one (up to 17 minutes) */
+#define SRV_TIME_MANAGEMENT_WHEEL_BITS          5U
+#define SRV_TIME_MANAGEMENT_WHEEL_SLOTS         (1UL << SRV_TIME_MANAGEMENT_WHEEL_BITS)
+#define SRV_TIME_MANAGEMENT_WHEEL_MASK          (SRV_TIME_MANAGEMENT_WHEEL_SLOTS - 1U)
+#define SRV_TIME_MANAGEMENT_WHEEL_LEVELS        4U
+#define SRV_TIME_MANAGEMENT_WHEEL_MAX_DELTA     ((1UL << (SRV_TIME_MANAGEMENT_WHEEL_BITS * SRV_TIME_MANAGEMENT_WHEEL_LEVELS)) - 1U)
+
+/* Maximum number of wheel ticks processed in each call to Tasks */
+#define SRV_TIME_MANAGEMENT_WHEEL_TICKS_BATCH   16U
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Static Data
 // *****************************************************************************
 // *****************************************************************************
 
-/* Time control variables */
-static uint64_t srvTimeMngPreviousCounter = 0;
-static uint64_t srvTimeMngCurrentTimeUs = 0;
+/* Reference of the time base: counter value and its time in us */
+typedef struct
+{
+    uint64_t counter;
+    uint64_t timeUs;
+} SRV_TIME_MANAGEMENT_REFERENCE;
+
+/* Double-buffered reference. Sequence selects the active buffer and changes
+   on every update, so readers detect a concurrent update and retry */
+static volatile SRV_TIME_MANAGEMENT_REFERENCE srvTimeMngReference[2] = {{0, 0}, {0, 0}};
+static volatile uint32_t srvTimeMngSequence = 0;
+
+/* Q32.32 conversion factors for the timer frequency: integer and fraction */
+static uint32_t srvTimeMngUsPerCountInt = 0;
+static uint32_t srvTimeMngUsPerCountFrac = 0;
+static uint32_t srvTimeMngCountPerUsInt = 0;
+static uint32_t srvTimeMngCountPerUsFrac = 0;
+static volatile bool srvTimeMngFactorsReady = false;
+
+/* Rate and offset model of a clock domain */
+typedef struct
+{
+    uint32_t refDomain;
+    uint32_t refHost;
+    uint32_t rateInt;
+    uint32_t rateFrac;
+    uint32_t invRateInt;
+    uint32_t invRateFrac;
+    uint32_t driftFrac;
+    uint16_t errorUs;
+    bool valid;
+} SRV_TIME_MANAGEMENT_DOMAIN_MODEL;
+
+/* Models of external clock domains, protected by a sequence number */
+static volatile SRV_TIME_MANAGEMENT_DOMAIN_MODEL srvTimeMngDomains[SRV_TIME_MANAGEMENT_DOMAIN_NUM];
+static volatile uint32_t srvTimeMngDomainSequence = 0;
+
+/* Timer wheel */
+static SRV_TIME_MANAGEMENT_TIMER *srvTimeMngWheel[SRV_TIME_MANAGEMENT_WHEEL_LEVELS][SRV_TIME_MANAGEMENT_WHEEL_SLOTS];
+static SYS_TIME_HANDLE srvTimeMngWheelHandle = SYS_TIME_HANDLE_INVALID;
+static volatile uint32_t srvTimeMngWheelTicks = 0;
+static uint32_t srvTimeMngWheelTick = 0;
+static uint32_t srvTimeMngWheelNumTimers = 0;
+static bool srvTimeMngWheelRunning = false;
 
 // *****************************************************************************
 // *****************************************************************************
@@ -67,33 +127,359 @@ static uint64_t srvTimeMngCurrentTimeUs = 0;
 // *****************************************************************************
 // *****************************************************************************
 
+static void lSRV_TIME_MANAGEMENT_InitFactors(void)
+{
+    uint64_t frequency;
+    uint64_t factor;
+
+    frequency = (uint64_t)SYS_TIME_FrequencyGet();
+    if (frequency == 0U)
+    {
+        return;
+    }
+
+    // Microseconds per cycle, rounded down
+    factor = (1000000ULL << 32) / frequency;
+    srvTimeMngUsPerCountInt = (uint32_t)(factor >> 32);
+    srvTimeMngUsPerCountFrac = (uint32_t)factor;
+
+    // Cycles per microsecond, rounded down
+    factor = (frequency << 32) / 1000000ULL;
+    srvTimeMngCountPerUsInt = (uint32_t)(factor >> 32);
+    srvTimeMngCountPerUsFrac = (uint32_t)factor;
+
+    srvTimeMngFactorsReady = true;
+}
+
+static inline uint64_t lSRV_TIME_MANAGEMENT_Scale(uint64_t value,
+    uint32_t factorInt, uint32_t factorFrac)
+{
+    uint32_t valueHigh = (uint32_t)(value >> 32);
+    uint32_t valueLow = (uint32_t)value;
+
+    // 32x32 multiplications only, no division
+    return (((uint64_t)valueHigh * factorInt) << 32) + ((uint64_t)valueHigh * factorFrac) +
+           ((uint64_t)valueLow * factorInt) + (((uint64_t)valueLow * factorFrac) >> 32);
+}
+
+static inline uint64_t lSRV_TIME_MANAGEMENT_USToCount(uint64_t timeUs)
+{
+    return lSRV_TIME_MANAGEMENT_Scale(timeUs, srvTimeMngCountPerUsInt,
+            srvTimeMngCountPerUsFrac);
+}
+
+static inline uint64_t lSRV_TIME_MANAGEMENT_CountToUS(uint64_t count)
+{
+    uint64_t timeUs;
+
+    timeUs = lSRV_TIME_MANAGEMENT_Scale(count, srvTimeMngUsPerCountInt,
+            srvTimeMngUsPerCountFrac);
+
+    // Truncated factor may be 1 us short on exact multiples. Correction keeps
+    // USToCount(CountToUS(count)) <= count, so the reference never advances
+    // beyond the timer counter
+    timeUs += (uint64_t)(lSRV_TIME_MANAGEMENT_USToCount(timeUs + 1U) <= count);
+
+    return timeUs;
+}
+
+static void lSRV_TIME_MANAGEMENT_GetReference(SRV_TIME_MANAGEMENT_REFERENCE *pRef)
+{
+    uint32_t sequence;
+
+    // Lock-free read: retry if the reference was updated meanwhile
+    do
+    {
+        sequence = srvTimeMngSequence;
+        pRef->counter = srvTimeMngReference[sequence & 1U].counter;
+        pRef->timeUs = srvTimeMngReference[sequence & 1U].timeUs;
+    } while (sequence != srvTimeMngSequence);
+}
+
+static void lSRV_TIME_MANAGEMENT_UpdateReference(SRV_TIME_MANAGEMENT_REFERENCE *pRef,
+    uint64_t elapsedUs)
+{
+    uint32_t sequence;
+    bool interruptStatus;
+
+    interruptStatus = SYS_INT_Disable();
+
+    // Only update if no other context has done it since reference was read
+    sequence = srvTimeMngSequence;
+    if (srvTimeMngReference[sequence & 1U].counter == pRef->counter)
+    {
+        // Write inactive buffer and then publish it
+        srvTimeMngReference[(sequence + 1U) & 1U].counter = pRef->counter +
+                lSRV_TIME_MANAGEMENT_USToCount(elapsedUs);
+        srvTimeMngReference[(sequence + 1U) & 1U].timeUs = pRef->timeUs + elapsedUs;
+        srvTimeMngSequence = sequence + 1U;
+    }
+
+    SYS_INT_Restore(interruptStatus);
+}
+
+static void lSRV_TIME_MANAGEMENT_GetDomainModel(SRV_TIME_MANAGEMENT_DOMAIN domain,
+    SRV_TIME_MANAGEMENT_DOMAIN_MODEL *pModel)
+{
+    SRV_TIME_MANAGEMENT_REFERENCE reference;
+    uint64_t counter;
+    uint32_t sequence;
+
+    if (domain == SRV_TIME_MANAGEMENT_DOMAIN_HOST)
+    {
+        // Identity
+        pModel->refDomain = 0;
+        pModel->refHost = 0;
+        pModel->rateInt = 1;
+        pModel->rateFrac = 0;
+        pModel->invRateInt = 1;
+        pModel->invRateFrac = 0;
+        pModel->driftFrac = 0;
+        pModel->errorUs = 0;
+        pModel->valid = true;
+    }
+    else if (domain == SRV_TIME_MANAGEMENT_DOMAIN_SYS_TIME)
+    {
+        // Same oscillator as host time: no drift, conversion factors of the service.
+        // Service reference may be older than the 32-bit signed difference of
+        // the translator (~14 s at 150 MHz), so the model is taken at the
+        // current counter, with the 64-bit difference to the reference
+        lSRV_TIME_MANAGEMENT_GetReference(&reference);
+        counter = SYS_TIME_Counter64Get();
+        pModel->refDomain = (uint32_t)counter;
+        pModel->refHost = (uint32_t)(reference.timeUs +
+                lSRV_TIME_MANAGEMENT_CountToUS(counter - reference.counter));
+        pModel->rateInt = srvTimeMngUsPerCountInt;
+        pModel->rateFrac = srvTimeMngUsPerCountFrac;
+        pModel->invRateInt = srvTimeMngCountPerUsInt;
+        pModel->invRateFrac = srvTimeMngCountPerUsFrac;
+        pModel->driftFrac = 0;
+        pModel->errorUs = 1;
+        pModel->valid = srvTimeMngFactorsReady;
+    }
+    else
+    {
+        // Lock-free read: retry if the model was updated meanwhile
+        do
+        {
+            sequence = srvTimeMngDomainSequence;
+            pModel->refDomain = srvTimeMngDomains[domain].refDomain;
+            pModel->refHost = srvTimeMngDomains[domain].refHost;
+            pModel->rateInt = srvTimeMngDomains[domain].rateInt;
+            pModel->rateFrac = srvTimeMngDomains[domain].rateFrac;
+            pModel->invRateInt = srvTimeMngDomains[domain].invRateInt;
+            pModel->invRateFrac = srvTimeMngDomains[domain].invRateFrac;
+            pModel->driftFrac = srvTimeMngDomains[domain].driftFrac;
+            pModel->errorUs = srvTimeMngDomains[domain].errorUs;
+            pModel->valid = srvTimeMngDomains[domain].valid;
+        } while (sequence != srvTimeMngDomainSequence);
+    }
+}
+
+static uint32_t lSRV_TIME_MANAGEMENT_Abs(int32_t delta)
+{
+    if (delta < 0)
+    {
+        return (uint32_t)(-(int64_t)delta);
+    }
+
+    return (uint32_t)delta;
+}
+
+static uint32_t lSRV_TIME_MANAGEMENT_ScaleDelta(int32_t delta, uint32_t factorInt,
+    uint32_t factorFrac, uint32_t *pScaled)
+{
+    uint32_t magnitude;
+    uint32_t scaled;
+
+    // Rounded to nearest, the model is not used to advance a reference
+    magnitude = lSRV_TIME_MANAGEMENT_Abs(delta);
+    scaled = (uint32_t)(((uint64_t)magnitude * factorInt) +
+            ((((uint64_t)magnitude * factorFrac) + (1ULL << 31)) >> 32));
+    *pScaled = scaled;
+
+    if (delta < 0)
+    {
+        return 0U - scaled;
+    }
+
+    return scaled;
+}
+
+static void lSRV_TIME_MANAGEMENT_WheelTickCb(uintptr_t context)
+{
+    (void)context;
+
+    // Only count ticks in interrupt context, wheel is advanced in Tasks
+    srvTimeMngWheelTicks++;
+}
+
+static void lSRV_TIME_MANAGEMENT_WheelUnlink(SRV_TIME_MANAGEMENT_TIMER *pTimer)
+{
+    *pTimer->ppPrev = pTimer->pNext;
+    if (pTimer->pNext != NULL)
+    {
+        pTimer->pNext->ppPrev = pTimer->ppPrev;
+    }
+
+    pTimer->pNext = NULL;
+    pTimer->ppPrev = NULL;
+}
+
+static void lSRV_TIME_MANAGEMENT_WheelLink(SRV_TIME_MANAGEMENT_TIMER **ppHead,
+    SRV_TIME_MANAGEMENT_TIMER *pTimer)
+{
+    pTimer->pNext = *ppHead;
+    if (pTimer->pNext != NULL)
+    {
+        pTimer->pNext->ppPrev = &pTimer->pNext;
+    }
+
+    pTimer->ppPrev = ppHead;
+    *ppHead = pTimer;
+}
+
+static void lSRV_TIME_MANAGEMENT_WheelInsert(SRV_TIME_MANAGEMENT_TIMER *pTimer)
+{
+    uint32_t delta;
+    uint32_t slotTick;
+    uint8_t level = 0;
+
+    delta = pTimer->expiryTick - srvTimeMngWheelTick;
+    if (delta > SRV_TIME_MANAGEMENT_WHEEL_MAX_DELTA)
+    {
+        // Too far: park in the last level, it is inserted again on cascade
+        delta = SRV_TIME_MANAGEMENT_WHEEL_MAX_DELTA;
+    }
+
+    slotTick = srvTimeMngWheelTick + delta;
+
+    while ((level < (SRV_TIME_MANAGEMENT_WHEEL_LEVELS - 1U)) &&
+           (delta >= (1UL << (SRV_TIME_MANAGEMENT_WHEEL_BITS * (level + 1U)))))
+    {
+        level++;
+    }
+
+    lSRV_TIME_MANAGEMENT_WheelLink(&srvTimeMngWheel[level]
+            [(slotTick >> (SRV_TIME_MANAGEMENT_WHEEL_BITS * level)) & SRV_TIME_MANAGEMENT_WHEEL_MASK],
+            pTimer);
+}
+
+static void lSRV_TIME_MANAGEMENT_WheelDetach(SRV_TIME_MANAGEMENT_TIMER **ppSlot,
+    SRV_TIME_MANAGEMENT_TIMER **ppList)
+{
+    // Move the slot to a local list, callbacks may stop timers on it
+    *ppList = *ppSlot;
+    *ppSlot = NULL;
+    if (*ppList != NULL)
+    {
+        (*ppList)->ppPrev = ppList;
+    }
+}
+
+static void lSRV_TIME_MANAGEMENT_WheelCascade(uint8_t level, uint32_t index)
+{
+    SRV_TIME_MANAGEMENT_TIMER *pList;
+    SRV_TIME_MANAGEMENT_TIMER *pTimer;
+
+    lSRV_TIME_MANAGEMENT_WheelDetach(&srvTimeMngWheel[level][index], &pList);
+
+    while (pList != NULL)
+    {
+        pTimer = pList;
+        lSRV_TIME_MANAGEMENT_WheelUnlink(pTimer);
+        lSRV_TIME_MANAGEMENT_WheelInsert(pTimer);
+    }
+}
+
+static void lSRV_TIME_MANAGEMENT_WheelAdvance(void)
+{
+    SRV_TIME_MANAGEMENT_TIMER *pList;
+    SRV_TIME_MANAGEMENT_TIMER *pTimer;
+    uint32_t index;
+    uint8_t level;
+
+    srvTimeMngWheelTick++;
+
+    // Move timers of upper levels down when lower level wraps
+    if ((srvTimeMngWheelTick & SRV_TIME_MANAGEMENT_WHEEL_MASK) == 0U)
+    {
+        for (level = 1; level < SRV_TIME_MANAGEMENT_WHEEL_LEVELS; level++)
+        {
+            index = (srvTimeMngWheelTick >> (SRV_TIME_MANAGEMENT_WHEEL_BITS * level)) &
+                    SRV_TIME_MANAGEMENT_WHEEL_MASK;
+            lSRV_TIME_MANAGEMENT_WheelCascade(level, index);
+            if (index != 0U)
+            {
+                break;
+            }
+        }
+    }
+
+    // Expire all timers of the current slot as a batch
+    lSRV_TIME_MANAGEMENT_WheelDetach(&srvTimeMngWheel[0]
+            [srvTimeMngWheelTick & SRV_TIME_MANAGEMENT_WHEEL_MASK], &pList);
+
+    while (pList != NULL)
+    {
+        pTimer = pList;
+        lSRV_TIME_MANAGEMENT_WheelUnlink(pTimer);
+
+        if (pTimer->expiryTick != srvTimeMngWheelTick)
+        {
+            // Parked timer not expired yet
+            lSRV_TIME_MANAGEMENT_WheelInsert(pTimer);
+            continue;
+        }
+
+        if (pTimer->periodMs != 0U)
+        {
+            // Re-arm before the callback, which may stop the timer
+            pTimer->expiryTick += pTimer->periodMs;
+            lSRV_TIME_MANAGEMENT_WheelInsert(pTimer);
+        }
+        else
+        {
+            srvTimeMngWheelNumTimers--;
+        }
+
+        pTimer->callback(pTimer->context);
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Time Management Service Interface Implementation
+// *****************************************************************************
+// *****************************************************************************
+
 uint64_t SRV_TIME_MANAGEMENT_GetTimeUS64(void)
 {
+    SRV_TIME_MANAGEMENT_REFERENCE reference;
     uint64_t counter;
-    uint64_t currentTimeUs;
-    uint64_t diffCounter;
-    uint32_t elapsedUs;
+    uint64_t elapsedUs;
+
+    if (srvTimeMngFactorsReady == false)
+    {
+        // Timer frequency is known once SYS_TIME is initialized
+        lSRV_TIME_MANAGEMENT_InitFactors();
+    }
+
+    lSRV_TIME_MANAGEMENT_GetReference(&reference);
 
     // Get current cycle counter
     counter = SYS_TIME_Counter64Get();
-    // Diff with previous
-    diffCounter = (counter - srvTimeMngPreviousCounter);
-    // Convert to Us
-    elapsedUs = SYS_TIME_CountToUS((uint32_t)diffCounter);
-    // Current time in Us
-    currentTimeUs = srvTimeMngCurrentTimeUs + elapsedUs;
+    // Convert the full 64-bit difference, so no wrap if not called for long
+    elapsedUs = lSRV_TIME_MANAGEMENT_CountToUS(counter - reference.counter);
 
     // Every time we update counters, there may be up to 1 us error
     // Only update if at least 10 seconds elapsed
     if (elapsedUs >= 10000000U)
     {
-        // Update counter Us
-        srvTimeMngCurrentTimeUs = currentTimeUs;
-        // Update previous counter for next computation
-        srvTimeMngPreviousCounter += SYS_TIME_USToCount(elapsedUs);
+        lSRV_TIME_MANAGEMENT_UpdateReference(&reference, elapsedUs);
     }
 
-    return currentTimeUs;
+    return reference.timeUs + elapsedUs;
 }
 
 
@@ -110,54 +496,56 @@ uint32_t SRV_TIME_MANAGEMENT_GetTimeUS(void)
 
 uint64_t SRV_TIME_MANAGEMENT_USToCount(uint32_t timeUs)
 {
-    uint64_t counter;
-    uint32_t currentUs;
+    uint64_t currentTimeUs;
     int32_t diffUs;
 
-    // Update reference counters, just in case  is not called periodically
-    (void) SRV_TIME_MANAGEMENT_GetTimeUS64();
+    // 32-bit time is resolved in a window of +/- 35 minutes around now
+    currentTimeUs = SRV_TIME_MANAGEMENT_GetTimeUS64();
+    diffUs = (int32_t)(timeUs - (uint32_t)currentTimeUs);
 
-    // Get the low part of the current timer counter
-    currentUs = (uint32_t)srvTimeMngCurrentTimeUs;
+    return SRV_TIME_MANAGEMENT_USToCount64((uint64_t)((int64_t)currentTimeUs + diffUs));
+}
 
-    diffUs = (int32_t)timeUs - (int32_t)currentUs;
 
-    if (diffUs < 0)
-    {
-      counter = srvTimeMngPreviousCounter - SYS_TIME_USToCount((uint32_t)(-diffUs));
-    }
-    else
+uint32_t SRV_TIME_MANAGEMENT_CountToUS(uint64_t counter)
+{
+    return (uint32_t)SRV_TIME_MANAGEMENT_CountToUS64(counter);
+}
+
+
+uint64_t SRV_TIME_MANAGEMENT_USToCount64(uint64_t timeUs)
+{
+    SRV_TIME_MANAGEMENT_REFERENCE reference;
+
+    // Update reference counters, just in case it is not called periodically
+    (void) SRV_TIME_MANAGEMENT_GetTimeUS64();
+
+    lSRV_TIME_MANAGEMENT_GetReference(&reference);
+
+    if (timeUs < reference.timeUs)
     {
-      counter = srvTimeMngPreviousCounter + SYS_TIME_USToCount((uint32_t)diffUs);
+        return reference.counter - lSRV_TIME_MANAGEMENT_USToCount(reference.timeUs - timeUs);
     }
 
-    return counter;
+    return reference.counter + lSRV_TIME_MANAGEMENT_USToCount(timeUs - reference.timeUs);
 }
 
 
-uint32_t SRV_TIME_MANAGEMENT_CountToUS(uint64_t counter)
+uint64_t SRV_TIME_MANAGEMENT_CountToUS64(uint64_t counter)
 {
-    uint32_t timeUs;
-    int64_t diffCount;
+    SRV_TIME_MANAGEMENT_REFERENCE reference;
 
     // Update reference counters, just in case it is not called periodically
     (void) SRV_TIME_MANAGEMENT_GetTimeUS64();
 
-    // Get the low part of the current timer counter
-    timeUs = (uint32_t)srvTimeMngCurrentTimeUs;
-
-    diffCount = (int64_t)counter - (int64_t)srvTimeMngPreviousCounter;
+    lSRV_TIME_MANAGEMENT_GetReference(&reference);
 
-    if (diffCount < 0)
+    if (counter < reference.counter)
     {
-      timeUs -= SYS_TIME_CountToUS((uint32_t)(-diffCount));
-    }
-    else
-    {
-      timeUs += SYS_TIME_CountToUS((uint32_t)diffCount);
+        return reference.timeUs - lSRV_TIME_MANAGEMENT_CountToUS(reference.counter - counter);
     }
 
-    return timeUs;
+    return reference.timeUs + lSRV_TIME_MANAGEMENT_CountToUS(counter - reference.counter);
 }
 
 SYS_TIME_HANDLE SRV_TIME_MANAGEMENT_CbRegisterUS ( SYS_TIME_CALLBACK callback,
@@ -171,3 +559,206 @@ SYS_TIME_HANDLE SRV_TIME_MANAGEMENT_CbRegisterMS ( SYS_TIME_CALLBACK callback,
 {
     return SYS_TIME_CallbackRegisterMS(callback, context, ms, type);
 }
+
+void SRV_TIME_MANAGEMENT_DomainUpdate(SRV_TIME_MANAGEMENT_DOMAIN domain,
+    uint32_t timeDomain, uint32_t timeHost, uint32_t relFreq,
+    uint16_t errorUs, uint16_t driftPpm)
+{
+    volatile SRV_TIME_MANAGEMENT_DOMAIN_MODEL *pModel;
+    uint64_t invRate;
+    bool interruptStatus;
+
+    if ((domain <= SRV_TIME_MANAGEMENT_DOMAIN_SYS_TIME) ||
+        (domain >= SRV_TIME_MANAGEMENT_DOMAIN_NUM) || (relFreq == 0U))
+    {
+        return;
+    }
+
+    // Domain ticks per host us [uQ32.32], only division of the translator
+    invRate = ((uint64_t)1 << 56) / relFreq;
+
+    pModel = &srvTimeMngDomains[domain];
+
+    interruptStatus = SYS_INT_Disable();
+
+    pModel->refDomain = timeDomain;
+    pModel->refHost = timeHost;
+    pModel->rateInt = relFreq >> 24;
+    pModel->rateFrac = relFreq << 8;
+    pModel->invRateInt = (uint32_t)(invRate >> 32);
+    pModel->invRateFrac = (uint32_t)invRate;
+    // Drift as fraction [uQ0.32]: 2^32 / 10^6 = 4294.97
+    pModel->driftFrac = (uint32_t)driftPpm * 4295U;
+    pModel->errorUs = errorUs;
+    pModel->valid = true;
+    srvTimeMngDomainSequence++;
+
+    SYS_INT_Restore(interruptStatus);
+}
+
+bool SRV_TIME_MANAGEMENT_DomainConvert(SRV_TIME_MANAGEMENT_DOMAIN srcDomain,
+    SRV_TIME_MANAGEMENT_DOMAIN dstDomain, uint32_t time, uint32_t *pTime,
+    uint32_t *pErrorUs)
+{
+    SRV_TIME_MANAGEMENT_DOMAIN_MODEL srcModel;
+    SRV_TIME_MANAGEMENT_DOMAIN_MODEL dstModel;
+    uint32_t timeHost;
+    uint32_t srcDeltaUs;
+    uint32_t dstDeltaUs;
+    uint32_t dstDelta;
+    uint32_t errorUs;
+
+    if ((srcDomain >= SRV_TIME_MANAGEMENT_DOMAIN_NUM) ||
+        (dstDomain >= SRV_TIME_MANAGEMENT_DOMAIN_NUM))
+    {
+        return false;
+    }
+
+    if (srvTimeMngFactorsReady == false)
+    {
+        (void)SRV_TIME_MANAGEMENT_GetTimeUS64();
+    }
+
+    lSRV_TIME_MANAGEMENT_GetDomainModel(srcDomain, &srcModel);
+    lSRV_TIME_MANAGEMENT_GetDomainModel(dstDomain, &dstModel);
+    if ((srcModel.valid == false) || (dstModel.valid == false))
+    {
+        return false;
+    }
+
+    // Source domain to host time
+    timeHost = srcModel.refHost + lSRV_TIME_MANAGEMENT_ScaleDelta(
+            (int32_t)(time - srcModel.refDomain), srcModel.rateInt,
+            srcModel.rateFrac, &srcDeltaUs);
+
+    // Host time to destination domain
+    dstDeltaUs = lSRV_TIME_MANAGEMENT_Abs((int32_t)(timeHost - dstModel.refHost));
+    *pTime = dstModel.refDomain + lSRV_TIME_MANAGEMENT_ScaleDelta(
+            (int32_t)(timeHost - dstModel.refHost), dstModel.invRateInt,
+            dstModel.invRateFrac, &dstDelta);
+
+    if (pErrorUs != NULL)
+    {
+        // Error of references plus drift since them
+        errorUs = (uint32_t)srcModel.errorUs + (uint32_t)dstModel.errorUs;
+        errorUs += (uint32_t)(((uint64_t)srcDeltaUs * srcModel.driftFrac) >> 32);
+        errorUs += (uint32_t)(((uint64_t)dstDeltaUs * dstModel.driftFrac) >> 32);
+        *pErrorUs = errorUs;
+    }
+
+    return true;
+}
+
+void SRV_TIME_MANAGEMENT_TimerInit(SRV_TIME_MANAGEMENT_TIMER *pTimer,
+    SRV_TIME_MANAGEMENT_TIMER_CALLBACK callback, uintptr_t context)
+{
+    pTimer->pNext = NULL;
+    pTimer->ppPrev = NULL;
+    pTimer->callback = callback;
+    pTimer->context = context;
+    pTimer->expiryTick = 0;
+    pTimer->periodMs = 0;
+}
+
+void SRV_TIME_MANAGEMENT_TimerStartMS(SRV_TIME_MANAGEMENT_TIMER *pTimer,
+    uint32_t ms, SYS_TIME_CALLBACK_TYPE type)
+{
+    if (ms == 0U)
+    {
+        ms = 1U;
+    }
+
+    SRV_TIME_MANAGEMENT_TimerStop(pTimer);
+
+    if (srvTimeMngWheelRunning == false)
+    {
+        if (srvTimeMngWheelHandle == SYS_TIME_HANDLE_INVALID)
+        {
+            srvTimeMngWheelHandle = SYS_TIME_CallbackRegisterMS(lSRV_TIME_MANAGEMENT_WheelTickCb,
+                    0, 1, SYS_TIME_PERIODIC);
+        }
+        else
+        {
+            (void)SYS_TIME_TimerStart(srvTimeMngWheelHandle);
+        }
+
+        srvTimeMngWheelRunning = (srvTimeMngWheelHandle != SYS_TIME_HANDLE_INVALID);
+    }
+
+    // Time is counted from the last tick, including ticks not processed yet
+    pTimer->expiryTick = srvTimeMngWheelTicks + ms;
+    if (type == SYS_TIME_PERIODIC)
+    {
+        pTimer->periodMs = ms;
+    }
+    else
+    {
+        pTimer->periodMs = 0;
+    }
+
+    lSRV_TIME_MANAGEMENT_WheelInsert(pTimer);
+    srvTimeMngWheelNumTimers++;
+}
+
+void SRV_TIME_MANAGEMENT_TimerStop(SRV_TIME_MANAGEMENT_TIMER *pTimer)
+{
+    if (pTimer->ppPrev != NULL)
+    {
+        lSRV_TIME_MANAGEMENT_WheelUnlink(pTimer);
+        srvTimeMngWheelNumTimers--;
+    }
+}
+
+bool SRV_TIME_MANAGEMENT_TimerIsRunning(SRV_TIME_MANAGEMENT_TIMER *pTimer)
+{
+    return (pTimer->ppPrev != NULL);
+}
+
+void SRV_TIME_MANAGEMENT_Tasks(void)
+{
+    uint8_t numTicks = 0;
+
+    while ((srvTimeMngWheelTick != srvTimeMngWheelTicks) &&
+           (numTicks < SRV_TIME_MANAGEMENT_WHEEL_TICKS_BATCH))
+    {
+        lSRV_TIME_MANAGEMENT_WheelAdvance();
+        numTicks++;
+    }
+
+    if ((srvTimeMngWheelRunning == true) && (srvTimeMngWheelNumTimers == 0U) &&
+        (srvTimeMngWheelTick == srvTimeMngWheelTicks))
+    {
+        // No timers armed: stop the tick to save power
+        (void)SYS_TIME_TimerStop(srvTimeMngWheelHandle);
+        srvTimeMngWheelRunning = false;
+    }
+}
+
+uint32_t SRV_TIME_MANAGEMENT_GetNextDeadline(void)
+{
+    uint32_t numTicks;
+    uint32_t index;
+
+    if (srvTimeMngWheelTick != srvTimeMngWheelTicks)
+    {
+        return 0;
+    }
+
+    if (srvTimeMngWheelNumTimers == 0U)
+    {
+        return SRV_TIME_MANAGEMENT_DEADLINE_NONE;
+    }
+
+    // First non-empty slot of level 0, or wrap of level 0 (cascade)
+    for (numTicks = 1; numTicks < SRV_TIME_MANAGEMENT_WHEEL_SLOTS; numTicks++)
+    {
+        index = (srvTimeMngWheelTick + numTicks) & SRV_TIME_MANAGEMENT_WHEEL_MASK;
+        if ((index == 0U) || (srvTimeMngWheel[0][index] != NULL))
+        {
+            break;
+        }
+    }
+
+    // Next tick may come at any time
+    return (numTicks - 1U) * 1000U;
+}
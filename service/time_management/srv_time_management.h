@@ -49,6 +49,91 @@ Microchip or any third party.
 
 #include "system/time/sys_time.h"
 
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Time Management No Deadline
+
+  Summary:
+    Value returned when there is no deadline.
+
+  Description:
+    SRV_TIME_MANAGEMENT_GetNextDeadline returns this value when there are no
+    timers running in the timer wheel.
+
+  Remarks:
+    None.
+*/
+#define SRV_TIME_MANAGEMENT_DEADLINE_NONE    0xFFFFFFFFUL
+
+// *****************************************************************************
+/* Time Management Clock Domains
+
+  Summary:
+    Clock domains handled by the timestamp translator.
+
+  Description:
+    This data type identifies the clock domains whose timestamps can be
+    converted to each other.
+
+  Remarks:
+    None.
+*/
+typedef enum
+{
+    /* Host time in microseconds (SRV_TIME_MANAGEMENT_GetTimeUS) */
+    SRV_TIME_MANAGEMENT_DOMAIN_HOST = 0,
+    /* SYS_TIME counter, low 32 bits (used by RF215 timestamps) */
+    SRV_TIME_MANAGEMENT_DOMAIN_SYS_TIME,
+    /* PLC transceiver timer in microseconds */
+    SRV_TIME_MANAGEMENT_DOMAIN_PLC,
+    SRV_TIME_MANAGEMENT_DOMAIN_NUM
+} SRV_TIME_MANAGEMENT_DOMAIN;
+
+// *****************************************************************************
+/* Time Management Timer Callback
+
+  Summary:
+    Callback function pointer for timers of the timer wheel.
+
+  Description:
+    This data type defines the function called when a timer of the timer wheel
+    expires. It is called from SRV_TIME_MANAGEMENT_Tasks.
+
+  Remarks:
+    None.
+*/
+typedef void (*SRV_TIME_MANAGEMENT_TIMER_CALLBACK)(uintptr_t context);
+
+// *****************************************************************************
+/* Time Management Timer
+
+  Summary:
+    Timer of the timer wheel.
+
+  Description:
+    This data type contains a timer handled by the timer wheel of the time
+    management service. The memory is provided by the user, so the number of
+    timers is not limited by the timer objects of SYS_TIME.
+
+  Remarks:
+    Fields are handled internally. SRV_TIME_MANAGEMENT_TimerInit must be called
+    before using the timer.
+*/
+typedef struct SRV_TIME_MANAGEMENT_TIMER_STRUCT
+{
+    struct SRV_TIME_MANAGEMENT_TIMER_STRUCT *pNext;
+    struct SRV_TIME_MANAGEMENT_TIMER_STRUCT **ppPrev;
+    SRV_TIME_MANAGEMENT_TIMER_CALLBACK callback;
+    uintptr_t context;
+    uint32_t expiryTick;
+    uint32_t periodMs;
+} SRV_TIME_MANAGEMENT_TIMER;
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Time Management Service Interface Definition
@@ -89,7 +174,35 @@ Microchip or any third party.
     </code>
 
   Remarks:
-    None.
+    Time is converted with fixed-point factors precomputed for the timer
+    frequency, so no division is performed. The cost in cycles of this routine
+    and the conversion routines can be measured on Cortex-M devices with the
+    DWT cycle counter, averaged over several calls and without the overhead of
+    the loop:
+    <code>
+    uint32_t cyclesStart, cyclesLoop, cyclesConversion;
+    uint32_t index;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    cyclesStart = DWT->CYCCNT;
+    for (index = 0; index < 1000U; index++)
+    {
+        __NOP();
+    }
+    cyclesLoop = DWT->CYCCNT - cyclesStart;
+
+    cyclesStart = DWT->CYCCNT;
+    for (index = 0; index < 1000U; index++)
+    {
+        (void)SRV_TIME_MANAGEMENT_GetTimeUS64();
+    }
+    cyclesConversion = (DWT->CYCCNT - cyclesStart - cyclesLoop) / 1000U;
+    </code>
+    The cost depends on the core, the compiler and its optimization level, so
+    it has to be measured on the target.
 */
 uint64_t SRV_TIME_MANAGEMENT_GetTimeUS64(void);
 
@@ -167,7 +280,8 @@ uint32_t SRV_TIME_MANAGEMENT_GetTimeUS(void);
 
   Remarks:
     Time to convert should be as close as possible to the current time
-    to avoid an overflow.
+    to avoid an overflow. Conversion uses a fixed-point factor precomputed
+    for the timer frequency, so no division is performed.
 */
 uint64_t SRV_TIME_MANAGEMENT_USToCount(uint32_t timeUs);
 
@@ -204,10 +318,86 @@ uint64_t SRV_TIME_MANAGEMENT_USToCount(uint32_t timeUs);
 
   Remarks:
     Cycles to convert should be as close as possible to the current value
-    to avoid an overflow.
+    to avoid an overflow. Conversion uses a fixed-point factor precomputed
+    for the timer frequency, so no division is performed.
 */
 uint32_t SRV_TIME_MANAGEMENT_CountToUS(uint64_t counter);
 
+// *****************************************************************************
+/* Function:
+    uint64_t SRV_TIME_MANAGEMENT_USToCount64(uint64_t timeUs)
+
+  Summary:
+    Converts a given 64-bit time in microseconds and returns the equivalent
+    value in cycles.
+
+  Description:
+    This routine converts a time in the 64-bit microseconds time base returned
+    by SRV_TIME_MANAGEMENT_GetTimeUS64 into the equivalent value of the 64-bit
+    cycles counter.
+
+  Precondition:
+    SYS_TIME_Initialize routine must have been called before.
+
+  Parameters:
+    timeUs - Time in microseconds (64 bits)
+
+  Returns:
+    Value of cycles counter.
+
+  Example:
+    <code>
+    uint64_t nextTimeCounter;
+    uint64_t nextTimeUS;
+
+    nextTimeUS = SRV_TIME_MANAGEMENT_GetTimeUS64() + 1000;
+
+    nextTimeCounter = SRV_TIME_MANAGEMENT_USToCount64(nextTimeUS);
+    </code>
+
+  Remarks:
+    Unlike SRV_TIME_MANAGEMENT_USToCount, the result is not ambiguous for
+    times far from the current time. This routine can be called from
+    interrupt context.
+*/
+uint64_t SRV_TIME_MANAGEMENT_USToCount64(uint64_t timeUs);
+
+// *****************************************************************************
+/* Function:
+    uint64_t SRV_TIME_MANAGEMENT_CountToUS64(uint64_t counter)
+
+  Summary:
+    Converts a given time in cycles and returns the equivalent 64-bit value in
+    microseconds.
+
+  Description:
+    This routine converts a value of the 64-bit cycles counter into the 64-bit
+    microseconds time base returned by SRV_TIME_MANAGEMENT_GetTimeUS64.
+
+  Precondition:
+    SYS_TIME_Initialize routine must have been called before.
+
+  Parameters:
+    counter - Cycles of the counter
+
+  Returns:
+    Converted time in microseconds (64 bits).
+
+  Example:
+    <code>
+    uint64_t timeReceptionCounter;
+    uint64_t timeUs;
+
+    timeUs = SRV_TIME_MANAGEMENT_CountToUS64(timeReceptionCounter);
+    </code>
+
+  Remarks:
+    Unlike SRV_TIME_MANAGEMENT_CountToUS, the result is not ambiguous for
+    cycles far from the current value. This routine can be called from
+    interrupt context.
+*/
+uint64_t SRV_TIME_MANAGEMENT_CountToUS64(uint64_t counter);
+
 // *****************************************************************************
 /* Function:
     SYS_TIME_HANDLE SRV_TIME_MANAGEMENT_CbRegisterUS ( SYS_TIME_CALLBACK callback,
@@ -329,6 +519,317 @@ SYS_TIME_HANDLE SRV_TIME_MANAGEMENT_CbRegisterUS ( SYS_TIME_CALLBACK callback,
 SYS_TIME_HANDLE SRV_TIME_MANAGEMENT_CbRegisterMS ( SYS_TIME_CALLBACK callback,
                         uintptr_t context, uint32_t ms, SYS_TIME_CALLBACK_TYPE type );
 
+// *****************************************************************************
+/* Function:
+    void SRV_TIME_MANAGEMENT_DomainUpdate(SRV_TIME_MANAGEMENT_DOMAIN domain,
+        uint32_t timeDomain, uint32_t timeHost, uint32_t relFreq,
+        uint16_t errorUs, uint16_t driftPpm)
+
+  Summary:
+    Updates the rate and offset model of a clock domain.
+
+  Description:
+    This routine sets a pair of simultaneous timestamps of a clock domain and
+    of the host, the relative frequency between them and the bounds of the
+    error of the model. It is called by the owner of the clock domain every
+    time it synchronizes with the host.
+
+  Precondition:
+    None.
+
+  Parameters:
+    domain      - Clock domain to update. Host and SYS_TIME domains are
+                  handled internally and cannot be updated.
+
+    timeDomain  - Time of the clock domain at the reference.
+
+    timeHost    - Host time in microseconds at the reference.
+
+    relFreq     - Host microseconds per tick of the domain [uQ8.24].
+
+    errorUs     - Error of the reference in microseconds.
+
+    driftPpm    - Maximum drift of the relative frequency in PPM.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    SRV_TIME_MANAGEMENT_DomainUpdate(SRV_TIME_MANAGEMENT_DOMAIN_PLC, timePlc,
+            timeHost, 1UL << 24, 1, 100);
+    </code>
+
+  Remarks:
+    The inverse of the relative frequency is computed here, so conversions do
+    not divide.
+*/
+void SRV_TIME_MANAGEMENT_DomainUpdate(SRV_TIME_MANAGEMENT_DOMAIN domain,
+    uint32_t timeDomain, uint32_t timeHost, uint32_t relFreq,
+    uint16_t errorUs, uint16_t driftPpm);
+
+// *****************************************************************************
+/* Function:
+    bool SRV_TIME_MANAGEMENT_DomainConvert(SRV_TIME_MANAGEMENT_DOMAIN srcDomain,
+        SRV_TIME_MANAGEMENT_DOMAIN dstDomain, uint32_t time, uint32_t *pTime,
+        uint32_t *pErrorUs)
+
+  Summary:
+    Converts a timestamp between two clock domains.
+
+  Description:
+    This routine converts a timestamp of a clock domain to another one through
+    the host time, in constant time. It also returns the error bound of the
+    result, which grows with the distance to the references of the models.
+
+  Precondition:
+    SYS_TIME_Initialize routine must have been called before.
+
+  Parameters:
+    srcDomain   - Clock domain of the timestamp.
+
+    dstDomain   - Clock domain of the result.
+
+    time        - Timestamp to convert.
+
+    pTime       - Pointer to store the converted timestamp.
+
+    pErrorUs    - Pointer to store the error bound in microseconds. It can be
+                  NULL.
+
+  Returns:
+    true if both clock domains have a valid model, false otherwise.
+
+  Example:
+    <code>
+    uint32_t rxTimeHost;
+    uint32_t errorUs;
+
+    if (SRV_TIME_MANAGEMENT_DomainConvert(SRV_TIME_MANAGEMENT_DOMAIN_PLC,
+            SRV_TIME_MANAGEMENT_DOMAIN_HOST, rxTimePlc, &rxTimeHost, &errorUs))
+    {
+    }
+    </code>
+
+  Remarks:
+    Timestamps are resolved in a window of +/- 2^31 ticks around the
+    references of the models. The reference of SRV_TIME_MANAGEMENT_DOMAIN_SYS_TIME
+    is the current timer counter, so its timestamps are resolved around now.
+    This routine can be called from interrupt context.
+*/
+bool SRV_TIME_MANAGEMENT_DomainConvert(SRV_TIME_MANAGEMENT_DOMAIN srcDomain,
+    SRV_TIME_MANAGEMENT_DOMAIN dstDomain, uint32_t time, uint32_t *pTime,
+    uint32_t *pErrorUs);
+
+// *****************************************************************************
+/* Function:
+    void SRV_TIME_MANAGEMENT_TimerInit(SRV_TIME_MANAGEMENT_TIMER *pTimer,
+        SRV_TIME_MANAGEMENT_TIMER_CALLBACK callback, uintptr_t context)
+
+  Summary:
+    Initializes a timer of the timer wheel.
+
+  Description:
+    This routine sets the callback and context of a timer of the timer wheel.
+    The timer is stopped.
+
+  Precondition:
+    None.
+
+  Parameters:
+    pTimer      - Pointer to the timer, provided by the user.
+
+    callback    - Pointer to the function to be called when the timer expires.
+
+    context     - A client-defined value that is passed to the callback function.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    static SRV_TIME_MANAGEMENT_TIMER keepAliveTimer;
+
+    SRV_TIME_MANAGEMENT_TimerInit(&keepAliveTimer, MyCallback, (uintptr_t)node);
+    </code>
+
+  Remarks:
+    The timer must not be running.
+*/
+void SRV_TIME_MANAGEMENT_TimerInit(SRV_TIME_MANAGEMENT_TIMER *pTimer,
+    SRV_TIME_MANAGEMENT_TIMER_CALLBACK callback, uintptr_t context);
+
+// *****************************************************************************
+/* Function:
+    void SRV_TIME_MANAGEMENT_TimerStartMS(SRV_TIME_MANAGEMENT_TIMER *pTimer,
+        uint32_t ms, SYS_TIME_CALLBACK_TYPE type)
+
+  Summary:
+    Starts a timer of the timer wheel.
+
+  Description:
+    This routine arms a timer of the timer wheel in constant time, to expire
+    after the given number of milliseconds (either once or repeatedly). If the
+    timer is already running, it is restarted.
+
+  Precondition:
+    SRV_TIME_MANAGEMENT_TimerInit must have been called before.
+
+  Parameters:
+    pTimer      - Pointer to the timer.
+
+    ms          - Time period in milliseconds. 0 is handled as 1.
+
+    type        - SYS_TIME_SINGLE or SYS_TIME_PERIODIC.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    SRV_TIME_MANAGEMENT_TimerStartMS(&keepAliveTimer, 30000, SYS_TIME_SINGLE);
+    </code>
+
+  Remarks:
+    Timers are driven by a single SYS_TIME timer with 1 ms resolution. This
+    routine must not be called from interrupt context.
+*/
+void SRV_TIME_MANAGEMENT_TimerStartMS(SRV_TIME_MANAGEMENT_TIMER *pTimer,
+    uint32_t ms, SYS_TIME_CALLBACK_TYPE type);
+
+// *****************************************************************************
+/* Function:
+    void SRV_TIME_MANAGEMENT_TimerStop(SRV_TIME_MANAGEMENT_TIMER *pTimer)
+
+  Summary:
+    Stops a timer of the timer wheel.
+
+  Description:
+    This routine disarms a timer of the timer wheel in constant time.
+
+  Precondition:
+    SRV_TIME_MANAGEMENT_TimerInit must have been called before.
+
+  Parameters:
+    pTimer      - Pointer to the timer.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    SRV_TIME_MANAGEMENT_TimerStop(&keepAliveTimer);
+    </code>
+
+  Remarks:
+    Stopping a timer which is not running has no effect. This routine must not
+    be called from interrupt context.
+*/
+void SRV_TIME_MANAGEMENT_TimerStop(SRV_TIME_MANAGEMENT_TIMER *pTimer);
+
+// *****************************************************************************
+/* Function:
+    bool SRV_TIME_MANAGEMENT_TimerIsRunning(SRV_TIME_MANAGEMENT_TIMER *pTimer)
+
+  Summary:
+    Checks whether a timer of the timer wheel is running.
+
+  Description:
+    This routine returns true if the timer is armed and has not expired yet.
+
+  Precondition:
+    SRV_TIME_MANAGEMENT_TimerInit must have been called before.
+
+  Parameters:
+    pTimer      - Pointer to the timer.
+
+  Returns:
+    true if the timer is running, false otherwise.
+
+  Example:
+    <code>
+    if (SRV_TIME_MANAGEMENT_TimerIsRunning(&keepAliveTimer) == false)
+    {
+    }
+    </code>
+
+  Remarks:
+    None.
+*/
+bool SRV_TIME_MANAGEMENT_TimerIsRunning(SRV_TIME_MANAGEMENT_TIMER *pTimer);
+
+// *****************************************************************************
+/* Function:
+    void SRV_TIME_MANAGEMENT_Tasks(void)
+
+  Summary:
+    Maintains the timer wheel of the time management service.
+
+  Description:
+    This routine advances the timer wheel by the ticks elapsed since the last
+    call and calls the callbacks of the expired timers. Ticks are processed in
+    batches of limited size, so a long delay is recovered in several calls.
+
+  Precondition:
+    None.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    while (true)
+    {
+        SRV_TIME_MANAGEMENT_Tasks();
+    }
+    </code>
+
+  Remarks:
+    This routine is called from SYS_Tasks.
+*/
+void SRV_TIME_MANAGEMENT_Tasks(void);
+
+// *****************************************************************************
+/* Function:
+    uint32_t SRV_TIME_MANAGEMENT_GetNextDeadline(void)
+
+  Summary:
+    Gets the time until the timer wheel needs to be maintained.
+
+  Description:
+    This routine returns the time until the next timer of the timer wheel
+    expires or the wheel needs to cascade timers from upper levels, so the
+    caller knows how long SRV_TIME_MANAGEMENT_Tasks can be left without being
+    called.
+
+  Precondition:
+    None.
+
+  Parameters:
+    None.
+
+  Returns:
+    Time in microseconds until the next deadline. 0 if there are ticks
+    pending to be processed. SRV_TIME_MANAGEMENT_DEADLINE_NONE if there are no
+    timers running.
+
+  Example:
+    <code>
+    if (SRV_TIME_MANAGEMENT_GetNextDeadline() > 1000U)
+    {
+        __WFI();
+    }
+    </code>
+
+  Remarks:
+    The returned time is rounded down to the wheel tick (1 ms), as the
+    position inside the current tick is unknown.
+*/
+uint32_t SRV_TIME_MANAGEMENT_GetNextDeadline(void);
+
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus // Provide C++ Compatibility
  }
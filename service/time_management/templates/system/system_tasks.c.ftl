@@ -0,0 +1,3 @@
+    
+    /* Maintain Time Management timer wheel */
+    SRV_TIME_MANAGEMENT_Tasks();